@@ -0,0 +1,580 @@
+#include "benchmarksuite.h"
+#include "levelstorage.h"
+#include "projectreader.h"
+#include "reanchorer.h"
+#include "highlightcache.h"
+#include "diagramwidget/scenemodel.h"
+#include "diagramwidget/diagramrenderer.h"
+#include "richtextcodec.h"
+#include "regexhighlighter.h"
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QHash>
+#include <QDateTime>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QtAlgorithms>
+#include <QTextDocument>
+#include <QDebug>
+
+// Same value the diagram widget uses, picking colors must skip it
+static const float pickingBackground[3] = {0.2f, 0.0f, 0.6f};
+
+// Nodes of the synthetic graph laid out by the layout benchmark
+static const int LARGE_LAYOUT_NODES = 100000;
+// Nodes of the synthetic level allocated and freed by the load benchmark
+static const int LARGE_LEVEL_NODES = 50000;
+
+static double elapsedMs(const QElapsedTimer &timer)
+{
+    return timer.nsecsElapsed() / 1000000.0;
+}
+
+double benchmarkResult::median() const
+{
+    if(samples.isEmpty())
+        return 0.0;
+    QVector<double> sorted = samples;
+    qSort(sorted);
+    int middle = sorted.size() / 2;
+    if(sorted.size() % 2 == 0)
+        return (sorted[middle-1] + sorted[middle]) / 2.0;
+    return sorted[middle];
+}
+
+double benchmarkResult::minimum() const
+{
+    double value = samples.isEmpty() ? 0.0 : samples[0];
+    for(int i=1; i<samples.size(); i++)
+        value = qMin(value, samples[i]);
+    return value;
+}
+
+double benchmarkResult::maximum() const
+{
+    double value = samples.isEmpty() ? 0.0 : samples[0];
+    for(int i=1; i<samples.size(); i++)
+        value = qMax(value, samples[i]);
+    return value;
+}
+
+// Inserts a level into a scene model the way the windows insert it into the diagram widget
+static void buildScene(SceneModel &scene, const QVector<dbDataStructure*> &elements)
+{
+    QHash<const dbDataStructure*, int> nodes;
+    scene.clear();
+    for(int i=0; i<elements.size(); i++)
+    {
+        int father = elements[i]->father ? nodes.value(elements[i]->father, -1) : -1;
+        nodes.insert(elements[i], scene.addNode(elements[i]->label, father));
+    }
+}
+
+// A level file's content, LARGE_LEVEL_NODES blocks with short comments and code anchors (the same level every run)
+static QByteArray largeLevelData()
+{
+    QVector<dbDataStructure*> elements;
+    qsrand(LARGE_LEVEL_NODES);
+    for(int i=0; i<LARGE_LEVEL_NODES; i++)
+    {
+        dbDataStructure *block = new dbDataStructure();
+        block->uniqueID = i;
+        block->label = QString("Block %1").arg(i);
+        block->data = QString("<html><body><p>Comment of block %1</p></body></html>").arg(i).toUtf8();
+        block->fileName = QString("src/file_%1.cpp").arg(i % 100);
+        block->firstLineData = QString("static int compute_%1(int value)").arg(i).toAscii();
+        block->linesNumbers.append(qrand() % 1000);
+        if(i > 0)
+        {
+            block->father = elements[i - 1 - (qrand() % qMin(i, 64))];
+            block->father->nextItems.append(block);
+        }
+        elements.append(block);
+    }
+
+    // Same content as LevelStorage::writeLevelFile, in memory
+    LevelStorage::convertDbDataToStorableData(elements, true);
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << elements.size();
+    for(int i=0; i<elements.size(); i++)
+        out << *(elements[i]);
+    LevelStorage::freeElements(elements);
+    return data;
+}
+
+// Decodes a level the way LevelStorage::readLevelFile does, with the nodes allocated from a level arena (as
+// readLevelFile does) or one by one with new
+static void decodeLevel(const QByteArray &data, bool useArena, QVector<dbDataStructure*> &elements)
+{
+    QDataStream in(data);
+    int numElements;
+    in >> numElements;
+    elements.reserve(numElements);
+    NodeArena<dbDataStructure> *arena = useArena ? new NodeArena<dbDataStructure>(numElements) : NULL;
+    for(int i=0; i<numElements; i++)
+    {
+        dbDataStructure *element;
+        if(useArena)
+        {
+            element = arena->create();
+            element->arena = arena;
+        }
+        else
+            element = new dbDataStructure();
+        in >> *element;
+        elements.append(element);
+    }
+    LevelStorage::convertDbDataToStorableData(elements, false);
+}
+
+BenchmarkSuite::BenchmarkSuite(int iterations)
+{
+    m_iterations = qMax(1, iterations);
+}
+
+void BenchmarkSuite::addSample(const QString &name, const QString &unit, double value)
+{
+    for(int i=0; i<m_results.size(); i++)
+    {
+        if(m_results[i].name == name)
+        {
+            m_results[i].samples.append(value);
+            return;
+        }
+    }
+    benchmarkResult result;
+    result.name = name;
+    result.unit = unit;
+    result.samples.append(value);
+    m_results.append(result);
+}
+
+bool BenchmarkSuite::run(const QString &filter)
+{
+    m_results.clear();
+    m_levelFiles = LevelStorage::allLevelFiles();
+    if(m_levelFiles.isEmpty())
+    {
+        qWarning() << "No documentation level found in" << GDS_DIR;
+        return false;
+    }
+    ProjectReader reader;
+    reader.readAll(m_levelFiles, m_graphs);
+
+    if(filter.isEmpty() || QString("load").startsWith(filter))
+        benchmarkLoad();
+    if(filter.isEmpty() || QString("save").startsWith(filter))
+        benchmarkSave();
+    if(filter.isEmpty() || QString("layout").startsWith(filter))
+        benchmarkLayout();
+    if(filter.isEmpty() || QString("picking").startsWith(filter))
+        benchmarkPicking();
+    if(filter.isEmpty() || QString("render").startsWith(filter))
+        benchmarkRender();
+    if(filter.isEmpty() || QString("highlight").startsWith(filter))
+        benchmarkHighlight();
+    if(filter.isEmpty() || QString("reanchor").startsWith(filter))
+        benchmarkReanchor();
+    if(filter.isEmpty() || QString("comments").startsWith(filter))
+        benchmarkComments();
+
+    for(int i=0; i<m_graphs.size(); i++)
+        LevelStorage::freeElements(m_graphs[i]);
+    m_graphs.clear();
+    return true;
+}
+
+// Every level read one after the other (as the windows do) and by the project reader, then the node allocation
+// alone on a synthetic level
+void BenchmarkSuite::benchmarkLoad()
+{
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for(int i=0; i<m_levelFiles.size(); i++)
+        {
+            QVector<dbDataStructure*> elements;
+            LevelStorage::readLevelFile(m_levelFiles[i], elements);
+            LevelStorage::freeElements(elements);
+        }
+        addSample("load.serial", "ms", elapsedMs(timer));
+
+        QVector< QVector<dbDataStructure*> > graphs;
+        ProjectReader reader;
+        timer.restart();
+        reader.readAll(m_levelFiles, graphs);
+        addSample("load.parallel", "ms", elapsedMs(timer));
+        addSample("load.parallel.throughput", "levels/s", reader.levelsPerSecond());
+        for(int i=0; i<graphs.size(); i++)
+            LevelStorage::freeElements(graphs[i]);
+    }
+
+    // Allocating and freeing the nodes of a big level: from the level's arena against ::operator new for every
+    // node. The level is decoded from memory, disk reads don't blur the comparison
+    QByteArray largeLevel = largeLevelData();
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        for(int pass=0; pass<2; pass++)
+        {
+            bool useArena = (pass == 0);
+            QString name = useArena ? "load.free.arena" : "load.free.heap";
+            QVector<dbDataStructure*> elements;
+            QElapsedTimer timer;
+            timer.start();
+            decodeLevel(largeLevel, useArena, elements);
+            QElapsedTimer freeTimer;
+            freeTimer.start();
+            LevelStorage::freeElements(elements);
+            addSample(name + ".free", "ms", elapsedMs(freeTimer));
+            addSample(name, "ms", elapsedMs(timer));
+        }
+    }
+}
+
+// Levels are saved into a temporary directory, the project isn't touched
+void BenchmarkSuite::benchmarkSave()
+{
+    QDir saveDir(QDir::temp().filePath("gds-bench-save"));
+    if(!saveDir.exists() && !QDir::temp().mkdir("gds-bench-save"))
+    {
+        qWarning() << "Cannot create" << saveDir.path() << "- save benchmark skipped";
+        return;
+    }
+
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for(int i=0; i<m_graphs.size(); i++)
+            LevelStorage::writeLevelFile(saveDir.filePath(QFileInfo(m_levelFiles[i]).fileName()), m_graphs[i]);
+        addSample("save", "ms", elapsedMs(timer));
+    }
+
+    for(int i=0; i<m_levelFiles.size(); i++)
+        saveDir.remove(QFileInfo(m_levelFiles[i]).fileName());
+    QDir::temp().rmdir("gds-bench-save");
+}
+
+// Inserting every level into the scene model and calculating its displacement (calculateDisplacement())
+void BenchmarkSuite::benchmarkLayout()
+{
+    SceneModel scene;
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        double buildTime = 0.0, layoutTime = 0.0;
+        for(int i=0; i<m_graphs.size(); i++)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            buildScene(scene, m_graphs[i]);
+            buildTime += elapsedMs(timer);
+            timer.restart();
+            scene.layout();
+            layoutTime += elapsedMs(timer);
+        }
+        addSample("layout.insert", "ms", buildTime);
+        addSample("layout.displacement", "ms", layoutTime);
+    }
+
+    // Far bigger than any real level: a synthetic tree of LARGE_LAYOUT_NODES nodes, every node under one of the
+    // few nodes added just before it (deep and irregular, the same tree every run). The sequential pass against
+    // the parallel one
+    SceneModel large;
+    qsrand(LARGE_LAYOUT_NODES);
+    large.addNode(QString(), -1);
+    for(int i=1; i<LARGE_LAYOUT_NODES; i++)
+        large.addNode(QString(), i - 1 - (qrand() % qMin(i, 64)));
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        large.layout(1);
+        addSample("layout.large.sequential", "ms", elapsedMs(timer));
+        timer.restart();
+        large.layout();
+        addSample("layout.large.parallel", "ms", elapsedMs(timer));
+    }
+}
+
+// The CPU side of picking: encoding every node into its picking color and decoding it back. Reading the
+// picked pixel needs a GL context and isn't measured here
+void BenchmarkSuite::benchmarkPicking()
+{
+    QVector<SceneModel> scenes(m_graphs.size());
+    qint64 nodes = 0;
+    for(int i=0; i<m_graphs.size(); i++)
+    {
+        buildScene(scenes[i], m_graphs[i]);
+        scenes[i].layout();
+        nodes += scenes[i].size();
+    }
+    if(nodes == 0)
+        return;
+
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        int errors = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for(int i=0; i<scenes.size(); i++)
+        {
+            for(int id=0; id<scenes[i].size(); id++)
+            {
+                unsigned char rgb[3];
+                SceneModel::colorForNode(id, pickingBackground, rgb);
+                if(scenes[i].nodeFromColor(rgb, pickingBackground) != id)
+                    errors++;
+            }
+        }
+        addSample("picking.roundtrip", "ns/node", timer.nsecsElapsed() / (double)nodes);
+        if(errors > 0)
+            qWarning() << "Picking benchmark -" << errors << "nodes decoded wrongly";
+    }
+}
+
+// A frame of every level drawn by DiagramRenderer into a window-sized image, with and without the labels. The
+// diagram widget draws through OpenGL, which needs a context the benchmark doesn't have: the software renderer
+// draws the same blocks and lines and stands in for the frame time (shaders, buffer uploads and the picking
+// pass aren't measured)
+void BenchmarkSuite::benchmarkRender()
+{
+    QVector<SceneModel> scenes(m_graphs.size());
+    for(int i=0; i<m_graphs.size(); i++)
+        DiagramRenderer::buildScene(m_graphs[i], scenes[i]);
+
+    DiagramRenderer renderer;
+    QSize frameSize(1280, 800);
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        for(int pass=0; pass<2; pass++)
+        {
+            bool labels = (pass == 0);
+            renderer.setLabelsVisible(labels);
+            for(int i=0; i<scenes.size(); i++)
+            {
+                QElapsedTimer timer;
+                timer.start();
+                QImage frame = renderer.render(scenes[i], frameSize);
+                addSample(labels ? "render.frame" : "render.frame.nolabels", "ms", elapsedMs(timer));
+            }
+        }
+    }
+}
+
+// Opening every documented code file: reading, hashing and lexing it as the highlighter does (cold), getting
+// the same tokens from the highlight cache (warm) and highlighting it with the old regex rules (baseline)
+void BenchmarkSuite::benchmarkHighlight()
+{
+    QSet<QString> fileNames;
+    for(int i=0; i<m_graphs.size(); i++)
+    {
+        for(int j=0; j<m_graphs[i].size(); j++)
+        {
+            if(!m_graphs[i][j]->fileName.isEmpty())
+                fileNames.insert(m_graphs[i][j]->fileName);
+        }
+    }
+    if(fileNames.isEmpty())
+        return;
+
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        QVector<QByteArray> hashes;
+        double coldTime = 0.0;
+        QSet<QString>::const_iterator itr = fileNames.constBegin();
+        while(itr != fileNames.constEnd())
+        {
+            QElapsedTimer timer;
+            timer.start();
+            QFile file(LevelStorage::convertToAbsolutePath(*itr));
+            itr++;
+            if(!file.open(QFile::ReadOnly))
+                continue;
+            QByteArray content = file.readAll();
+            file.close();
+
+            highlightData data;
+            QByteArray hash = HighlightCache::contentHash(content);
+            HighlightCache::lexContent(content, data);
+            coldTime += elapsedMs(timer);
+
+            HighlightCache::insert(hash, data);
+            hashes.append(hash);
+        }
+        addSample("highlight.cold", "ms", coldTime);
+
+        // Baseline: the QRegExp highlighter used before CppLexer on the same files. It applies its formats to
+        // a document as the code pane did (loading the text into the document isn't measured)
+        double regexTime = 0.0;
+        itr = fileNames.constBegin();
+        while(itr != fileNames.constEnd())
+        {
+            QFile file(LevelStorage::convertToAbsolutePath(*itr));
+            itr++;
+            if(!file.open(QFile::ReadOnly))
+                continue;
+            QTextDocument document;
+            document.setPlainText(QString::fromUtf8(file.readAll()));
+            file.close();
+
+            QElapsedTimer timer;
+            timer.start();
+            RegexHighlighter highlighter(&document);
+            highlighter.rehighlight();
+            regexTime += elapsedMs(timer);
+        }
+        addSample("highlight.regex", "ms", regexTime);
+
+        QElapsedTimer timer;
+        timer.start();
+        for(int i=0; i<hashes.size(); i++)
+        {
+            highlightData data;
+            HighlightCache::find(hashes[i], data);
+        }
+        addSample("highlight.cached", "ms", elapsedMs(timer));
+    }
+}
+
+// Project-wide re-anchoring, nothing is written back
+void BenchmarkSuite::benchmarkReanchor()
+{
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        BatchReanchorJob job(false);
+        QElapsedTimer timer;
+        timer.start();
+        job.run();
+        addSample("reanchor", "ms", elapsedMs(timer));
+        if(iteration == 0)
+            addSample("reanchor.moved", "blocks", job.movedCount());
+    }
+}
+
+// Every comment stored as html (as generated, like projects written before the compact format) and as compact
+// rich text: stored size, size once compressed as level files do and time to load it into a document
+void BenchmarkSuite::benchmarkComments()
+{
+    QVector<QByteArray> htmlComments;
+    QVector<QByteArray> compactComments;
+    {
+        QTextDocument document;
+        for(int i=0; i<m_graphs.size(); i++)
+        {
+            for(int j=0; j<m_graphs[i].size(); j++)
+            {
+                const QByteArray &comment = m_graphs[i][j]->data;
+                if(comment.isEmpty())
+                    continue;
+                RichTextCodec::load(comment, document);
+                QByteArray compact = RichTextCodec::encode(document);
+                if(compact.isEmpty())
+                    continue;
+                htmlComments.append(comment);
+                compactComments.append(compact);
+            }
+        }
+    }
+    if(htmlComments.isEmpty())
+        return;
+
+    qint64 htmlBytes = 0, compactBytes = 0, htmlCompressed = 0, compactCompressed = 0;
+    for(int i=0; i<htmlComments.size(); i++)
+    {
+        htmlBytes += htmlComments[i].size();
+        compactBytes += compactComments[i].size();
+        htmlCompressed += qCompress(htmlComments[i]).size();
+        compactCompressed += qCompress(compactComments[i]).size();
+    }
+    addSample("comments.html.size", "KB", htmlBytes / 1024.0);
+    addSample("comments.compact.size", "KB", compactBytes / 1024.0);
+    addSample("comments.html.compressed", "KB", htmlCompressed / 1024.0);
+    addSample("comments.compact.compressed", "KB", compactCompressed / 1024.0);
+
+    for(int iteration=0; iteration<m_iterations; iteration++)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for(int i=0; i<htmlComments.size(); i++)
+        {
+            QTextDocument document;
+            RichTextCodec::load(htmlComments[i], document);
+        }
+        addSample("comments.html.load", "ms", elapsedMs(timer));
+
+        timer.restart();
+        for(int i=0; i<compactComments.size(); i++)
+        {
+            QTextDocument document;
+            RichTextCodec::load(compactComments[i], document);
+        }
+        addSample("comments.compact.load", "ms", elapsedMs(timer));
+    }
+}
+
+static QString jsonString(const QString &text)
+{
+    QString escaped = text;
+    escaped.replace("\\", "\\\\").replace("\"", "\\\"");
+    return "\"" + escaped + "\"";
+}
+
+bool BenchmarkSuite::writeJson(const QString &path, const QStringList &metadata) const
+{
+    QFile file;
+    if(path.isEmpty() || path == "-")
+    {
+        if(!file.open(stdout, QFile::WriteOnly | QFile::Text))
+            return false;
+    }
+    else
+    {
+        file.setFileName(path);
+        if(!file.open(QFile::WriteOnly | QFile::Text))
+            return false;
+    }
+
+    QTextStream out(&file);
+    out << "{" << endl;
+    out << "  \"date\": " << jsonString(QDateTime::currentDateTime().toString(Qt::ISODate)) << "," << endl;
+    out << "  \"iterations\": " << m_iterations << "," << endl;
+    out << "  \"metadata\": {";
+    for(int i=0; i<metadata.size(); i++)
+    {
+        out << (i > 0 ? ", " : "") << jsonString(metadata[i].section('=', 0, 0)) << ": "
+            << jsonString(metadata[i].section('=', 1));
+    }
+    out << "}," << endl;
+    out << "  \"results\": [" << endl;
+    for(int i=0; i<m_results.size(); i++)
+    {
+        const benchmarkResult &result = m_results[i];
+        out << "    {\"name\": " << jsonString(result.name) << ", \"unit\": " << jsonString(result.unit)
+            << ", \"median\": " << result.median() << ", \"min\": " << result.minimum()
+            << ", \"max\": " << result.maximum() << ", \"samples\": [";
+        for(int j=0; j<result.samples.size(); j++)
+            out << (j > 0 ? ", " : "") << result.samples[j];
+        out << "]}" << (i+1 < m_results.size() ? "," : "") << endl;
+    }
+    out << "  ]" << endl;
+    out << "}" << endl;
+
+    file.close();
+    return true;
+}
+
+QString BenchmarkSuite::summary() const
+{
+    QString text;
+    for(int i=0; i<m_results.size(); i++)
+    {
+        text += QString("%1 %2 %3 (min %4, max %5)\n").arg(m_results[i].name, -28)
+                .arg(m_results[i].median(), 12, 'f', 3).arg(m_results[i].unit, -9)
+                .arg(m_results[i].minimum(), 0, 'f', 3).arg(m_results[i].maximum(), 0, 'f', 3);
+    }
+    return text;
+}
@@ -0,0 +1,56 @@
+#ifndef BENCHMARKSUITE_H
+#define BENCHMARKSUITE_H
+
+// Performance benchmarks run on a gds project (usually a synthetic one, see ProjectGenerator): loading, saving,
+// layout, picking, rendering, code file highlighting, re-anchoring and comments (html against compact rich
+// text). Every benchmark is repeated and its samples are written as JSON so that results can be compared across
+// versions
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "gdsdbreader.h"
+
+struct benchmarkResult
+{
+    QString name;
+    QString unit;
+    QVector<double> samples;
+
+    double median() const;
+    double minimum() const;
+    double maximum() const;
+};
+
+class BenchmarkSuite
+{
+public:
+    explicit BenchmarkSuite(int iterations);
+
+    // Runs every benchmark whose name starts with filter (all of them if it's empty) on the project in the
+    // current directory. Returns false if the project cannot be read
+    bool run(const QString &filter);
+
+    // Every metadata entry is a "key=value" string
+    bool writeJson(const QString &path, const QStringList &metadata) const;
+    QString summary() const;
+
+private:
+    int m_iterations;
+    QVector<benchmarkResult> m_results;
+    QStringList m_levelFiles;
+    QVector< QVector<dbDataStructure*> > m_graphs; // Every level, decoded once for the benchmarks that need it
+
+    void addSample(const QString &name, const QString &unit, double value);
+
+    void benchmarkLoad();
+    void benchmarkSave();
+    void benchmarkLayout();
+    void benchmarkPicking();
+    void benchmarkRender();
+    void benchmarkHighlight();
+    void benchmarkReanchor();
+    void benchmarkComments();
+};
+
+#endif // BENCHMARKSUITE_H
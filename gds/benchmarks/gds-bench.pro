@@ -0,0 +1,34 @@
+#-------------------------------------------------
+#
+# gds-bench: synthetic project generator and performance benchmarks
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+TARGET = gds-bench
+TEMPLATE = app
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+SOURCES += main.cpp \
+    projectgenerator.cpp \
+    benchmarksuite.cpp \
+    regexhighlighter.cpp \
+    ../cpplexer.cpp \
+    ../highlightcache.cpp \
+    ../diagramwidget/scenemodel.cpp \
+    ../diagramwidget/diagramrenderer.cpp \
+    ../richtextcodec.cpp
+
+HEADERS += projectgenerator.h \
+    benchmarksuite.h \
+    regexhighlighter.h \
+    ../cpplexer.h \
+    ../highlightcache.h \
+    ../diagramwidget/scenemodel.h \
+    ../diagramwidget/diagramrenderer.h \
+    ../richtextcodec.h
+
+include(../storage.pri)
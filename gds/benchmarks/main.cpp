@@ -0,0 +1,117 @@
+#include "projectgenerator.h"
+#include "benchmarksuite.h"
+#include "levelstorage.h"
+
+#include <QApplication>
+#include <QStringList>
+#include <QFile>
+#include <QDir>
+#include <QTextStream>
+#include <QThread>
+#include <QDebug>
+#include <stdio.h>
+
+// gds-bench: performance benchmarks on synthetic projects. Usage:
+//   gds-bench generate <project dir> [shape options]
+//   gds-bench run <project dir> [--iterations <n>] [--filter <benchmark>] [--output <results.json>]
+// The shape used to generate a project is stored with it and reported with the results, results from the
+// same shape can be compared across versions
+
+// Written into the project directory by generate, read back by run
+#define SHAPE_FILE "gds-bench-shape.txt"
+
+static void printUsage()
+{
+    QTextStream err(stderr);
+    err << "Usage:" << endl
+        << "  gds-bench generate <project dir> " << projectShape::usage() << endl
+        << "  gds-bench run <project dir> [--iterations <n>] [--filter <benchmark>] [--output <results.json>]" << endl
+        << "Benchmarks: load, save, layout, picking, render, highlight, reanchor, comments" << endl;
+}
+
+static QString optionValue(const QStringList &args, const QString &option, const QString &defaultValue)
+{
+    int index = args.indexOf(option);
+    if(index == -1 || index+1 >= args.size())
+        return defaultValue;
+    return args[index+1];
+}
+
+static int commandGenerate(const QString &projectDir, const QStringList &args)
+{
+    projectShape shape;
+    if(!shape.parseArguments(args))
+        return EXIT_FAILURE;
+
+    ProjectGenerator generator(shape);
+    if(!generator.generate(projectDir))
+        return EXIT_FAILURE;
+
+    QFile file(QDir(projectDir).filePath(SHAPE_FILE));
+    if(file.open(QFile::WriteOnly | QFile::Text))
+    {
+        QTextStream out(&file);
+        out << shape.describe().join("\n") << endl;
+        file.close();
+    }
+
+    QTextStream(stdout) << "Generated " << generator.levelsCount() << " levels, " << generator.blocksCount()
+                        << " blocks into " << projectDir << endl;
+    return EXIT_SUCCESS;
+}
+
+static int commandRun(const QString &projectDir, const QStringList &args)
+{
+    if(!QDir::setCurrent(projectDir))
+    {
+        qWarning() << "Cannot change directory to" << projectDir;
+        return EXIT_FAILURE;
+    }
+    // Code file paths of generated projects are relative to the project directory
+    LevelStorage::setApplicationDir(QDir::currentPath());
+
+    QStringList metadata;
+    QFile shapeFile(SHAPE_FILE);
+    if(shapeFile.open(QFile::ReadOnly | QFile::Text))
+    {
+        metadata = QString(shapeFile.readAll()).split('\n', QString::SkipEmptyParts);
+        shapeFile.close();
+    }
+    metadata << QString("threads=%1").arg(QThread::idealThreadCount());
+
+    BenchmarkSuite suite(optionValue(args, "--iterations", "5").toInt());
+    if(!suite.run(optionValue(args, "--filter", "")))
+        return EXIT_FAILURE;
+
+    QTextStream(stderr) << suite.summary();
+    QString output = optionValue(args, "--output", "-");
+    if(!suite.writeJson(output, metadata))
+    {
+        qWarning() << "Cannot write" << output;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    // The comments benchmark needs QtGui (text documents), not a display
+    QApplication app(argc, argv, false);
+    QStringList args = app.arguments();
+    args.removeFirst();
+    if(args.size() < 2)
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    QString command = args.takeFirst();
+    QString projectDir = QDir(args.takeFirst()).absolutePath();
+    if(command == "generate")
+        return commandGenerate(projectDir, args);
+    if(command == "run")
+        return commandRun(projectDir, args);
+
+    printUsage();
+    return EXIT_FAILURE;
+}
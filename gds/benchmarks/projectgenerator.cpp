@@ -0,0 +1,266 @@
+#include "projectgenerator.h"
+#include "levelstorage.h"
+#include <QFile>
+#include <QDir>
+#include <QTextStream>
+#include <QDebug>
+
+// Words used for the labels and the comments' text
+static const char *loremWords[] = {"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit",
+                                   "sed", "do", "eiusmod", "tempor", "incididunt", "labore", "magna", "aliqua",
+                                   "buffer", "index", "parser", "widget", "level", "graph", "node", "cache", NULL};
+
+projectShape::projectShape()
+{
+    fanOut = 4;
+    depth = 3;
+    levelTwoGraphs = 8;
+    levelThreeGraphs = 16;
+    commentBytes = 1024;
+    imagesPerComment = 0;
+    imageBytes = 16 * 1024;
+    sourceFiles = 8;
+    sourceLines = 2000;
+    drift = 5;
+    seed = 1;
+}
+
+bool projectShape::parseArguments(const QStringList &args)
+{
+    for(int i=0; i+1<args.size(); i++)
+    {
+        int *option = NULL;
+        if(args[i] == "--fanout") option = &fanOut;
+        else if(args[i] == "--depth") option = &depth;
+        else if(args[i] == "--level2") option = &levelTwoGraphs;
+        else if(args[i] == "--level3") option = &levelThreeGraphs;
+        else if(args[i] == "--comment-bytes") option = &commentBytes;
+        else if(args[i] == "--images") option = &imagesPerComment;
+        else if(args[i] == "--image-bytes") option = &imageBytes;
+        else if(args[i] == "--source-files") option = &sourceFiles;
+        else if(args[i] == "--source-lines") option = &sourceLines;
+        else if(args[i] == "--drift") option = &drift;
+        else if(args[i] == "--seed")
+        {
+            seed = args[++i].toUInt();
+            continue;
+        }
+        else
+            continue;
+
+        bool ok;
+        *option = args[++i].toInt(&ok);
+        if(!ok || *option < 0)
+        {
+            qWarning() << "Invalid value for" << args[i-1];
+            return false;
+        }
+    }
+    if(fanOut < 1 || sourceFiles < 1 || sourceLines < 8)
+    {
+        qWarning() << "The fan-out and the code files must be at least 1, code files at least 8 lines long";
+        return false;
+    }
+    return true;
+}
+
+QStringList projectShape::describe() const
+{
+    return QStringList() << QString("fanout=%1").arg(fanOut) << QString("depth=%1").arg(depth)
+                         << QString("level2=%1").arg(levelTwoGraphs) << QString("level3=%1").arg(levelThreeGraphs)
+                         << QString("comment_bytes=%1").arg(commentBytes) << QString("images=%1").arg(imagesPerComment)
+                         << QString("image_bytes=%1").arg(imageBytes) << QString("source_files=%1").arg(sourceFiles)
+                         << QString("source_lines=%1").arg(sourceLines) << QString("drift=%1").arg(drift)
+                         << QString("seed=%1").arg(seed);
+}
+
+QString projectShape::usage()
+{
+    return "[--fanout <n>] [--depth <n>] [--level2 <n>] [--level3 <n>] [--comment-bytes <n>] [--images <n>] "
+           "[--image-bytes <n>] [--source-files <n>] [--source-lines <n>] [--drift <n>] [--seed <n>]";
+}
+
+ProjectGenerator::ProjectGenerator(const projectShape &shape)
+{
+    m_shape = shape;
+    m_levelsCount = 0;
+    m_blocksCount = 0;
+}
+
+int ProjectGenerator::random(int max)
+{
+    return (max <= 0) ? 0 : (qrand() % max);
+}
+
+bool ProjectGenerator::generate(const QString &projectDir)
+{
+    qsrand(m_shape.seed);
+    m_levelsCount = 0;
+    m_blocksCount = 0;
+
+    QDir dir(projectDir);
+    if(!dir.mkpath(GDS_DIR) || !dir.mkpath("src"))
+    {
+        qWarning() << "Cannot create the project directories into" << projectDir;
+        return false;
+    }
+
+    // Code files first, anchors are taken from them
+    m_sources.clear();
+    for(int i=0; i<m_shape.sourceFiles; i++)
+        m_sources.append(sourceFile(i));
+
+    // Level 1
+    QVector<dbDataStructure*> levelOne;
+    buildTree(levelOne, "Module", false);
+    QVector<quint64> levelOneIDs;
+    for(int i=0; i<levelOne.size() && levelOneIDs.size() < m_shape.levelTwoGraphs; i++)
+        levelOneIDs.append(levelOne[i]->uniqueID);
+    bool ok = writeLevel(projectDir, LevelStorage::levelFilePath(LEVEL_ONE, 0, 0), levelOne);
+
+    // Level 2 graphs, the blocks zooming into level 3 are taken round-robin from every graph
+    QVector< QVector<quint64> > levelTwoIDs(levelOneIDs.size());
+    for(int i=0; i<levelOneIDs.size() && ok; i++)
+    {
+        QVector<dbDataStructure*> levelTwo;
+        buildTree(levelTwo, QString("Component %1").arg(levelOneIDs[i]), true);
+        for(int j=0; j<levelTwo.size(); j++)
+            levelTwoIDs[i].append(levelTwo[j]->uniqueID);
+        ok = writeLevel(projectDir, LevelStorage::levelFilePath(LEVEL_TWO, levelOneIDs[i], 0), levelTwo);
+    }
+    for(int i=0; i<m_shape.levelThreeGraphs && !levelOneIDs.isEmpty() && ok; i++)
+    {
+        int graph = i % levelOneIDs.size();
+        int block = i / levelOneIDs.size();
+        if(block >= levelTwoIDs[graph].size())
+            break; // Every level 2 block has its level 3 already
+        QVector<dbDataStructure*> levelThree;
+        buildTree(levelThree, QString("Detail %1.%2").arg(levelOneIDs[graph]).arg(levelTwoIDs[graph][block]), true);
+        ok = writeLevel(projectDir, LevelStorage::levelFilePath(LEVEL_THREE, levelOneIDs[graph],
+                                                                levelTwoIDs[graph][block]), levelThree);
+    }
+
+    // Code files are written with some more lines here and there, so re-anchoring has something to do
+    for(int i=0; i<m_sources.size() && ok; i++)
+    {
+        QStringList lines = m_sources[i];
+        for(int j=0; j<m_shape.drift; j++)
+            lines.insert(random(lines.size()), QString("// Line %1 added after the documentation was written").arg(j));
+
+        QFile file(dir.filePath(QString("src/file_%1.cpp").arg(i)));
+        if(!file.open(QFile::WriteOnly | QFile::Text))
+        {
+            qWarning() << "Cannot write" << file.fileName();
+            return false;
+        }
+        QTextStream out(&file);
+        for(int j=0; j<lines.size(); j++)
+            out << lines[j] << "\n";
+        file.close();
+    }
+
+    return ok;
+}
+
+// Builds a complete tree with the shape's fan-out and depth, parents are stored before their children as the
+// windows do. Anchored blocks (level 2/3) document a few lines of a code file
+void ProjectGenerator::buildTree(QVector<dbDataStructure*> &elements, const QString &labelPrefix, bool anchored)
+{
+    dbDataStructure *root = new dbDataStructure();
+    root->father = NULL;
+    elements.append(root);
+
+    int levelStart = 0;
+    for(int d=0; d<m_shape.depth; d++)
+    {
+        int levelEnd = elements.size();
+        for(int i=levelStart; i<levelEnd; i++)
+        {
+            for(int j=0; j<m_shape.fanOut; j++)
+            {
+                dbDataStructure *child = new dbDataStructure();
+                child->father = elements[i];
+                elements[i]->nextItems.append(child);
+                elements.append(child);
+            }
+        }
+        levelStart = levelEnd;
+    }
+
+    for(int i=0; i<elements.size(); i++)
+    {
+        dbDataStructure *block = elements[i];
+        block->uniqueID = i;
+        block->depth = 0;
+        block->userIndex = 0;
+        block->label = labelPrefix + " " + loremWords[random(24)] + " " + QString::number(i);
+        block->data = comment(block->label);
+        if(anchored)
+        {
+            int file = random(m_sources.size());
+            int first = random(m_sources[file].size() - 4);
+            block->fileName = QString("src/file_%1.cpp").arg(file);
+            int nextLines = random(4);
+            block->linesNumbers.append(first);
+            for(int j=1; j<=nextLines; j++)
+                block->linesNumbers.append(j);
+            block->firstLineData = m_sources[file][first].toAscii();
+        }
+    }
+    m_blocksCount += elements.size();
+}
+
+QByteArray ProjectGenerator::comment(const QString &label)
+{
+    QString html = "<html><head><meta name=\"qrichtext\" content=\"1\" /></head><body><p><b>" + label + "</b> ";
+    int textLength = 0;
+    while(textLength < m_shape.commentBytes)
+    {
+        QString word = loremWords[random(24)];
+        html += word + ((random(12) == 0) ? ".</p><p>" : " ");
+        textLength += word.length() + 1;
+    }
+    html += "</p>";
+
+    // Images are embedded the way the text editor does
+    for(int i=0; i<m_shape.imagesPerComment; i++)
+    {
+        QByteArray image(m_shape.imageBytes, 0);
+        for(int j=0; j<image.size(); j++)
+            image[j] = (char)random(256);
+        html += "<img alt=\"\" src=\"data:image//png;base64," + QString(image.toBase64()) + " //>";
+    }
+    html += "</body></html>";
+    return html.toUtf8();
+}
+
+// C++-looking code, every few lines are unique so anchors can be found again
+QStringList ProjectGenerator::sourceFile(int file)
+{
+    QStringList lines;
+    lines << QString("// Synthetic code file %1").arg(file) << "#include <stdio.h>" << "";
+    for(int f=0; lines.size() < m_shape.sourceLines; f++)
+    {
+        lines << QString("/* Function %1 of file %2, it computes something */").arg(f).arg(file)
+              << QString("static int compute_%1_%2(int value, const char *name)").arg(file).arg(f)
+              << "{"
+              << QString("    int result = value * %1 + 0x%2; // Scale").arg(f).arg(random(0xFFFF), 0, 16)
+              << QString("    if(result > %1)").arg(random(100000))
+              << "        printf(\"%s: %d\\n\", name, result);"
+              << "    return result;"
+              << "}"
+              << "";
+    }
+    return lines;
+}
+
+bool ProjectGenerator::writeLevel(const QString &projectDir, const QString &levelFile,
+                                  QVector<dbDataStructure*> &elements)
+{
+    bool ok = LevelStorage::writeLevelFile(QDir(projectDir).filePath(levelFile), elements);
+    if(!ok)
+        qWarning() << "Cannot write" << levelFile;
+    LevelStorage::freeElements(elements);
+    m_levelsCount++;
+    return ok;
+}
@@ -0,0 +1,59 @@
+#ifndef PROJECTGENERATOR_H
+#define PROJECTGENERATOR_H
+
+// Writes synthetic gds projects (level files and the code files they document) of a given shape, used by the
+// benchmarks. The same shape and seed always produce the same project
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "gdsdbreader.h"
+
+struct projectShape
+{
+    int fanOut;             // Children of every block
+    int depth;              // Levels of blocks below the root of each graph
+    int levelTwoGraphs;     // Level 1 blocks zooming into a level 2 graph
+    int levelThreeGraphs;   // Level 2 blocks zooming into a level 3 graph (spread over the level 2 graphs)
+    int commentBytes;       // Text in every block's comment
+    int imagesPerComment;   // Images embedded (base64) in every comment
+    int imageBytes;         // Size of every embedded image
+    int sourceFiles;        // Code files documented by level 2/3 blocks
+    int sourceLines;        // Lines of every code file
+    int drift;              // Lines inserted in every code file after anchoring, they move the anchors
+    uint seed;
+
+    projectShape();
+    // Reads the shape options (--fanout, --depth, ...) from a command line, unknown arguments are ignored.
+    // Returns false if a value isn't valid
+    bool parseArguments(const QStringList &args);
+    QStringList describe() const;
+    static QString usage();
+};
+
+class ProjectGenerator
+{
+public:
+    explicit ProjectGenerator(const projectShape &shape);
+
+    // Creates the project into a directory (level files go into its GDS_DIR, code files into src/), the
+    // project's level and code files are overwritten. Returns false on errors
+    bool generate(const QString &projectDir);
+
+    int levelsCount() const { return m_levelsCount; }
+    int blocksCount() const { return m_blocksCount; }
+
+private:
+    projectShape m_shape;
+    int m_levelsCount;
+    int m_blocksCount;
+    QVector<QStringList> m_sources; // Code files content, as anchored (before the drift)
+
+    int random(int max);
+    void buildTree(QVector<dbDataStructure*> &elements, const QString &labelPrefix, bool anchored);
+    QByteArray comment(const QString &label);
+    QStringList sourceFile(int file);
+    bool writeLevel(const QString &projectDir, const QString &levelFile, QVector<dbDataStructure*> &elements);
+};
+
+#endif // PROJECTGENERATOR_H
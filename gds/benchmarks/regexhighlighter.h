@@ -0,0 +1,41 @@
+#ifndef REGEXHIGHLIGHTER_H
+#define REGEXHIGHLIGHTER_H
+
+// The QRegExp highlighter the code pane used before CppLexer, kept here unchanged (same rules, same order) as
+// the baseline of the highlight benchmark. It isn't used by the application
+
+#include <QSyntaxHighlighter>
+#include <QVector>
+#include <QRegExp>
+#include <QTextCharFormat>
+
+class RegexHighlighter : public QSyntaxHighlighter
+{
+public:
+    explicit RegexHighlighter(QTextDocument *parent = 0);
+
+protected:
+    void highlightBlock(const QString &text);
+
+private:
+    struct HighlightingRule
+    {
+        QRegExp pattern;
+        QTextCharFormat format;
+    };
+
+    // The vector that contains all the rules for the text
+    QVector<HighlightingRule> highlightingRules;
+
+    QRegExp commentStartExpression;
+    QRegExp commentEndExpression;
+
+    QTextCharFormat keywordFormat;
+    QTextCharFormat classFormat;
+    QTextCharFormat singleLineCommentFormat;
+    QTextCharFormat multiLineCommentFormat;
+    QTextCharFormat quotationFormat;
+    QTextCharFormat functionFormat;
+};
+
+#endif // REGEXHIGHLIGHTER_H
@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# gds-cli: headless command line tool over the documentation database
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+TARGET = gds-cli
+TEMPLATE = app
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+SOURCES += main.cpp
+
+include(../storage.pri)
+include(../siteexport/siteexport.pri)
@@ -0,0 +1,918 @@
+#include "levelstorage.h"
+#include "projectreader.h"
+#include "reanchorer.h"
+#include "searchindex.h"
+#include "logger.h"
+#include "richtextformat.h"
+#include "richtextcodec.h"
+#include "siteexporter.h"
+#include "diagramwidget/diagramrenderer.h"
+
+#include <QApplication>
+#include <QTextDocument>
+#include <QImage>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <QHash>
+#include <QSet>
+#include <QDebug>
+#include <stdio.h>
+
+// gds-cli: headless operations on the documentation database, it doesn't need a display. It's linked with the
+// storage code (see storage.pri) and with the site exporter and the rich text codec, which need QtGui but no
+// display. Usage:
+//   gds-cli [-C <project dir>] [--app-dir <gds dir>] [--threads <n>] [--log <levels>] <command> [arguments]
+// The project directory is the one containing GDS_DIR (the current one by default). Code file paths are stored
+// relative to the gds executable, --app-dir tells where it is (the project directory by default).
+// Every command returns a non-zero exit code on failure so that it can be used in CI
+
+// Decoding threads used by the project-wide commands, 0 uses one per core
+static int readerThreads = 0;
+
+static QTextStream &standardOutput()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static void printUsage()
+{
+    QTextStream err(stderr);
+    err << "Usage: gds-cli [-C <project dir>] [--app-dir <gds dir>] [--threads <n>] [--log <levels>] <command> [arguments]" << endl
+        << "Commands:" << endl
+        << "  levels                                 lists every level file with its blocks" << endl
+        << "  dump <level file> [--comments]         prints the tree of blocks of a level" << endl
+        << "  validate                               checks the integrity of every level file" << endl
+        << "  reanchor [--dry-run] [--report <file>] re-anchors every block to its code file" << endl
+        << "  compact [--dry-run] [--remove-orphans] rewrites every level file" << endl
+        << "  convert-comments [--dry-run]           stores html comments as compact rich text" << endl
+        << "  export [<file>]                        writes the whole documentation as a text outline" << endl
+        << "  export-site <directory>                writes the whole documentation as a static web site" << endl
+        << "  render <level file> <png file> [--size <w>x<h>] [--no-labels]" << endl
+        << "                                         draws the graph of a level into an image" << endl
+        << "  thumbnails <directory> [--size <w>x<h>] [--no-labels]" << endl
+        << "                                         draws every level into <directory>/<level>.png" << endl
+        << "  decode                                 decodes every level and prints the throughput" << endl;
+}
+
+static QString levelName(level lvl)
+{
+    switch(lvl)
+    {
+        case LEVEL_ONE: return "1";
+        case LEVEL_TWO: return "2";
+        case LEVEL_THREE: return "3";
+    }
+    return "?";
+}
+
+// Level files can be given by name only (e.g. level2_5.gds), they're searched into GDS_DIR
+static QString resolveLevelFile(const QString &name)
+{
+    if(QFile::exists(name) || name.contains('/'))
+        return name;
+    return QString(GDS_DIR) + "/" + name;
+}
+
+// Returns the level file containing the block a level zooms into (empty for level one)
+static QString parentLevelFile(const QString &levelFile, quint64 *parentID)
+{
+    level lvl;
+    quint64 levelOneID, levelTwoID;
+    if(!LevelStorage::parseLevelFileName(levelFile, &lvl, &levelOneID, &levelTwoID))
+        return QString();
+    switch(lvl)
+    {
+        case LEVEL_TWO:
+            *parentID = levelOneID;
+            return LevelStorage::levelFilePath(LEVEL_ONE, 0, 0);
+        case LEVEL_THREE:
+            *parentID = levelTwoID;
+            return LevelStorage::levelFilePath(LEVEL_TWO, levelOneID, 0);
+        default:
+            return QString();
+    }
+}
+
+// Returns the level file a block zooms into (empty for level three blocks)
+static QString childLevelFile(const QString &levelFile, const dbDataStructure *block)
+{
+    level lvl;
+    quint64 levelOneID, levelTwoID;
+    if(!LevelStorage::parseLevelFileName(levelFile, &lvl, &levelOneID, &levelTwoID))
+        return QString();
+    if(lvl == LEVEL_ONE)
+        return LevelStorage::levelFilePath(LEVEL_TWO, block->uniqueID, 0);
+    if(lvl == LEVEL_TWO)
+        return LevelStorage::levelFilePath(LEVEL_THREE, levelOneID, block->uniqueID);
+    return QString();
+}
+
+static int countAnchoredBlocks(const QVector<dbDataStructure*> &elements)
+{
+    int count = 0;
+    for(int i=0; i<elements.size(); i++)
+    {
+        if(!elements[i]->fileName.isEmpty() && elements[i]->linesNumbers.size() > 0)
+            count++;
+    }
+    return count;
+}
+
+//// levels
+
+class levelsLister : public ProjectLevelConsumer
+{
+public:
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(index);
+        level lvl = LEVEL_ONE;
+        LevelStorage::parseLevelFileName(levelFile, &lvl, NULL, NULL);
+        standardOutput() << levelFile << "\t" << levelName(lvl) << "\t" << elements.size() << "\t"
+                         << countAnchoredBlocks(elements) << "\t" << QFileInfo(levelFile).size() << endl;
+        return false;
+    }
+    void levelFailed(int index, const QString &levelFile)
+    {
+        Q_UNUSED(index);
+        standardOutput() << levelFile << "\tUNREADABLE" << endl;
+    }
+};
+
+static int commandLevels(const QStringList &args)
+{
+    Q_UNUSED(args);
+    QStringList levelFiles = LevelStorage::allLevelFiles();
+    if(levelFiles.isEmpty())
+    {
+        qWarning() << "No documentation level found in" << GDS_DIR;
+        return EXIT_FAILURE;
+    }
+
+    standardOutput() << "# level file, level, blocks, anchored blocks, bytes" << endl;
+    levelsLister lister;
+    ProjectReader reader;
+    reader.setMaxThreadCount(readerThreads);
+    reader.read(levelFiles, &lister);
+    return (reader.failedCount() > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//// dump and export
+
+// Writes the tree of blocks of a level, one line per block indented by its depth. If recursive is set the levels
+// every block zooms into are written right below it
+static bool writeLevelTree(QTextStream &out, const QString &levelFile, int baseDepth, bool recursive, bool comments)
+{
+    QVector<dbDataStructure*> elements;
+    QString error;
+    if(!LevelStorage::readLevelFile(levelFile, elements, &error))
+    {
+        qWarning() << "Cannot read" << levelFile << "-" << error;
+        return false;
+    }
+
+    bool ok = true;
+
+    // Depth-first from the root(s), children in their stored order. Visited blocks are marked so that a
+    // corrupted tree can't make us loop
+    QVector<const dbDataStructure*> stack;
+    QVector<int> depths;
+    for(int i=elements.size()-1; i>=0; i--)
+    {
+        if(elements[i]->father == NULL)
+        {
+            stack.append(elements[i]);
+            depths.append(0);
+        }
+    }
+    QSet<const dbDataStructure*> visited;
+    while(!stack.isEmpty())
+    {
+        const dbDataStructure *block = stack.last();
+        int depth = depths.last();
+        stack.pop_back();
+        depths.pop_back();
+        if(visited.contains(block))
+            continue;
+        visited.insert(block);
+
+        QString indent((baseDepth + depth) * 2, ' ');
+        out << indent << "- " << block->label << "  [#" << block->uniqueID << "]";
+        if(!block->fileName.isEmpty() && block->linesNumbers.size() > 0)
+        {
+            out << "  (" << block->fileName << ":" << block->linesNumbers[0];
+            if(block->linesNumbers.size() > 1)
+                out << " +" << (block->linesNumbers.size() - 1) << " lines";
+            out << ")";
+        }
+        out << endl;
+
+        if(comments && !block->data.isEmpty())
+        {
+            QStringList lines = SearchIndex::commentToPlainText(block->data).split('\n', QString::SkipEmptyParts);
+            for(int i=0; i<lines.size(); i++)
+            {
+                QString line = lines[i].trimmed();
+                if(!line.isEmpty())
+                    out << indent << "    " << line << endl;
+            }
+        }
+
+        if(recursive)
+        {
+            QString childLevel = childLevelFile(levelFile, block);
+            if(!childLevel.isEmpty() && QFile::exists(childLevel))
+                ok = writeLevelTree(out, childLevel, baseDepth + depth + 1, true, comments) && ok;
+        }
+
+        for(int i=block->nextItems.size()-1; i>=0; i--)
+        {
+            stack.append(block->nextItems[i]);
+            depths.append(depth + 1);
+        }
+    }
+
+    LevelStorage::freeElements(elements);
+    return ok;
+}
+
+static int commandDump(const QStringList &args)
+{
+    if(args.isEmpty())
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    QString levelFile = resolveLevelFile(args[0]);
+    bool comments = args.contains("--comments");
+    return writeLevelTree(standardOutput(), levelFile, 0, false, comments) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int commandExport(const QStringList &args)
+{
+    QString rootLevel = LevelStorage::levelFilePath(LEVEL_ONE, 0, 0);
+    if(!QFile::exists(rootLevel))
+    {
+        qWarning() << "No documentation level found in" << GDS_DIR;
+        return EXIT_FAILURE;
+    }
+
+    QFile file;
+    if(args.isEmpty() || args[0] == "-")
+    {
+        if(!file.open(stdout, QFile::WriteOnly | QFile::Text))
+            return EXIT_FAILURE;
+    }
+    else
+    {
+        file.setFileName(args[0]);
+        if(!file.open(QFile::WriteOnly | QFile::Text))
+        {
+            qWarning() << "Cannot write" << args[0];
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Levels are read one branch at a time, no more than three of them are in memory
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    bool ok = writeLevelTree(out, rootLevel, 0, true, true);
+    out.flush();
+    file.close();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//// validate
+
+// Checks the structure of every level as it's decoded and collects the uniqueIDs, levels are checked against
+// their parent level once everything has been read
+class levelValidator : public ProjectLevelConsumer
+{
+public:
+    bool m_report; // If not set, problems are just counted
+    int m_errors;
+    int m_warnings;
+    QHash<QString, QSet<quint64> > m_levelIDs;
+
+    levelValidator()
+    {
+        m_report = true;
+        m_errors = 0;
+        m_warnings = 0;
+    }
+
+    void error(const QString &levelFile, const QString &message)
+    {
+        if(m_report)
+            standardOutput() << "ERROR\t" << levelFile << "\t" << message << endl;
+        m_errors++;
+    }
+    void warning(const QString &levelFile, const QString &message)
+    {
+        if(m_report)
+            standardOutput() << "WARNING\t" << levelFile << "\t" << message << endl;
+        m_warnings++;
+    }
+
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(index);
+        if(elements.isEmpty())
+        {
+            error(levelFile, "the level has no blocks");
+            return false;
+        }
+
+        QSet<quint64> &ids = m_levelIDs[levelFile];
+
+        const dbDataStructure *root = NULL;
+        int roots = 0;
+        for(int i=0; i<elements.size(); i++)
+        {
+            const dbDataStructure *block = elements[i];
+            if(ids.contains(block->uniqueID))
+                error(levelFile, QString("uniqueID %1 is used by more than a block").arg(block->uniqueID));
+            ids.insert(block->uniqueID);
+
+            if(block->father == NULL)
+            {
+                root = block;
+                roots++;
+            }
+            else if(!block->father->nextItems.contains(elements[i]))
+                error(levelFile, QString("block %1 isn't among its father's children").arg(i));
+            for(int j=0; j<block->nextItems.size(); j++)
+            {
+                if(block->nextItems[j]->father != block)
+                    error(levelFile, QString("block %1 has a child whose father is another block").arg(i));
+            }
+
+            if(!block->fileName.isEmpty() && block->linesNumbers.size() > 0 &&
+               !QFile::exists(LevelStorage::convertToAbsolutePath(block->fileName)))
+                warning(levelFile, QString("block %1 is anchored to a missing code file: %2").arg(i).arg(block->fileName));
+        }
+        if(roots != 1)
+        {
+            error(levelFile, QString("the level has %1 root blocks").arg(roots));
+            return false;
+        }
+
+        // Every block must be reachable from the root
+        QSet<const dbDataStructure*> visited;
+        QVector<const dbDataStructure*> stack;
+        stack.append(root);
+        while(!stack.isEmpty())
+        {
+            const dbDataStructure *block = stack.last();
+            stack.pop_back();
+            if(visited.contains(block))
+                continue;
+            visited.insert(block);
+            for(int j=0; j<block->nextItems.size(); j++)
+                stack.append(block->nextItems[j]);
+        }
+        if(visited.size() != elements.size())
+            error(levelFile, QString("%1 blocks aren't reachable from the root").arg(elements.size() - visited.size()));
+        return false;
+    }
+
+    void levelFailed(int index, const QString &levelFile)
+    {
+        Q_UNUSED(index);
+        // Read it again just to know why
+        QVector<dbDataStructure*> elements;
+        QString reason;
+        if(LevelStorage::readLevelFile(levelFile, elements, &reason))
+            LevelStorage::freeElements(elements);
+        error(levelFile, "unreadable level: " + reason);
+    }
+
+    // Levels zooming into a block which doesn't exist anymore
+    QStringList orphanLevels(const QStringList &levelFiles) const
+    {
+        QStringList orphans;
+        for(int i=0; i<levelFiles.size(); i++)
+        {
+            quint64 parentID = 0;
+            QString parentLevel = parentLevelFile(levelFiles[i], &parentID);
+            if(parentLevel.isEmpty())
+                continue;
+            if(!m_levelIDs.value(parentLevel).contains(parentID))
+                orphans.append(levelFiles[i]);
+        }
+        return orphans;
+    }
+};
+
+static int commandValidate(const QStringList &args)
+{
+    Q_UNUSED(args);
+    QStringList levelFiles = LevelStorage::allLevelFiles();
+    if(levelFiles.isEmpty())
+    {
+        qWarning() << "No documentation level found in" << GDS_DIR;
+        return EXIT_FAILURE;
+    }
+
+    levelValidator validator;
+    ProjectReader reader;
+    reader.setMaxThreadCount(readerThreads);
+    reader.read(levelFiles, &validator);
+
+    QStringList orphans = validator.orphanLevels(levelFiles);
+    for(int i=0; i<orphans.size(); i++)
+        validator.error(orphans[i], "the block this level belongs to doesn't exist");
+
+    standardOutput() << "# " << reader.summary() << ", " << validator.m_errors << " errors, "
+                     << validator.m_warnings << " warnings" << endl;
+    return (validator.m_errors > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//// reanchor
+
+static int commandReanchor(const QStringList &args)
+{
+    bool dryRun = args.contains("--dry-run");
+    QString reportFile;
+    int reportIndex = args.indexOf("--report");
+    if(reportIndex != -1 && reportIndex+1 < args.size())
+        reportFile = args[reportIndex+1];
+
+    BatchReanchorJob job(!dryRun);
+    if(!job.run())
+    {
+        qWarning() << "No documentation level found in" << GDS_DIR;
+        return EXIT_FAILURE;
+    }
+    job.writeReport(reportFile);
+
+    // Broken anchors fail the command so that CI notices them
+    return (job.brokenCount() > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//// compact
+
+// Rewrites every decoded level: indices are recalculated and trailing garbage is dropped. The new file is
+// written aside and renamed, a failure never leaves a truncated level behind
+class levelCompactor : public ProjectLevelConsumer
+{
+public:
+    bool m_dryRun;
+    QSet<QString> m_skip;
+    int m_rewritten;
+    int m_failed;
+    qint64 m_bytesBefore;
+    qint64 m_bytesAfter;
+
+    levelCompactor()
+    {
+        m_dryRun = false;
+        m_rewritten = 0;
+        m_failed = 0;
+        m_bytesBefore = 0;
+        m_bytesAfter = 0;
+    }
+
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(index);
+        if(m_skip.contains(levelFile))
+            return false;
+
+        m_bytesBefore += QFileInfo(levelFile).size();
+        if(m_dryRun)
+        {
+            m_bytesAfter += QFileInfo(levelFile).size();
+            return false;
+        }
+
+        QString tempFile = levelFile + ".tmp";
+        QFile::remove(tempFile);
+        if(!LevelStorage::writeLevelFile(tempFile, elements) || !QFile::remove(levelFile) ||
+           !QFile::rename(tempFile, levelFile))
+        {
+            qWarning() << "Cannot rewrite" << levelFile;
+            m_bytesAfter += QFileInfo(levelFile).size();
+            m_failed++;
+            return false;
+        }
+        m_bytesAfter += QFileInfo(levelFile).size();
+        m_rewritten++;
+        return false;
+    }
+    void levelFailed(int index, const QString &levelFile)
+    {
+        Q_UNUSED(index);
+        qWarning() << "Cannot read" << levelFile << "- the file is left untouched";
+        m_failed++;
+    }
+};
+
+static int commandCompact(const QStringList &args)
+{
+    bool dryRun = args.contains("--dry-run");
+    bool removeOrphans = args.contains("--remove-orphans");
+
+    QStringList levelFiles = LevelStorage::allLevelFiles();
+    if(levelFiles.isEmpty())
+    {
+        qWarning() << "No documentation level found in" << GDS_DIR;
+        return EXIT_FAILURE;
+    }
+
+    // 1) Find out the orphan levels (their parent block is gone, the application can't reach them anymore)
+    levelValidator validator;
+    validator.m_report = false;
+    ProjectReader reader;
+    reader.setMaxThreadCount(readerThreads);
+    reader.read(levelFiles, &validator);
+    QStringList orphans = validator.orphanLevels(levelFiles);
+    for(int i=0; i<orphans.size(); i++)
+    {
+        standardOutput() << "ORPHAN\t" << orphans[i] << endl;
+        if(removeOrphans && !dryRun && !QFile::remove(orphans[i]))
+            qWarning() << "Cannot remove" << orphans[i];
+    }
+
+    // 2) Rewrite everything else
+    levelCompactor compactor;
+    compactor.m_dryRun = dryRun;
+    if(removeOrphans)
+        compactor.m_skip = orphans.toSet();
+    reader.read(levelFiles, &compactor);
+
+    standardOutput() << "# " << compactor.m_rewritten << " levels rewritten, " << compactor.m_bytesBefore << " -> "
+                     << compactor.m_bytesAfter << " bytes, " << orphans.size() << " orphan levels"
+                     << ((removeOrphans && !dryRun) ? " removed" : "") << endl;
+    return (compactor.m_failed > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//// export-site
+
+static int commandExportSite(const QStringList &args)
+{
+    if(args.isEmpty())
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    SiteExporter exporter;
+    exporter.setMaxThreadCount(readerThreads);
+    if(!exporter.exportSite(args[0]))
+    {
+        qWarning() << "Cannot export the documentation into" << args[0];
+        return EXIT_FAILURE;
+    }
+    standardOutput() << "# " << exporter.summary() << endl;
+    return (exporter.failedCount() > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//// render, thumbnails
+
+// Image options shared by render and thumbnails, the size is given as <width>x<height>
+static bool parseRenderOptions(const QStringList &args, QSize *size, DiagramRenderer *renderer)
+{
+    int sizeOption = args.indexOf("--size");
+    if(sizeOption != -1)
+    {
+        QStringList dimensions = (sizeOption + 1 < args.size()) ? args[sizeOption + 1].split('x') : QStringList();
+        if(dimensions.size() != 2 || dimensions[0].toInt() <= 0 || dimensions[1].toInt() <= 0)
+            return false;
+        *size = QSize(dimensions[0].toInt(), dimensions[1].toInt());
+    }
+    renderer->setLabelsVisible(!args.contains("--no-labels"));
+    return true;
+}
+
+static bool renderLevel(const DiagramRenderer &renderer, const QVector<dbDataStructure*> &elements,
+                        const QSize &size, const QString &imageFile)
+{
+    SceneModel scene;
+    DiagramRenderer::buildScene(elements, scene);
+    if(!renderer.render(scene, size).save(imageFile, "PNG"))
+    {
+        qWarning() << "Cannot write" << imageFile;
+        return false;
+    }
+    return true;
+}
+
+static int commandRender(const QStringList &args)
+{
+    QSize size(1024, 768);
+    DiagramRenderer renderer;
+    if(args.size() < 2 || !parseRenderOptions(args, &size, &renderer))
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    QString levelFile = resolveLevelFile(args[0]);
+    QVector<dbDataStructure*> elements;
+    QString error;
+    if(!LevelStorage::readLevelFile(levelFile, elements, &error))
+    {
+        qWarning() << "Cannot read" << levelFile << "-" << error;
+        return EXIT_FAILURE;
+    }
+    bool ok = renderLevel(renderer, elements, size, args[1]);
+    LevelStorage::freeElements(elements);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Levels are decoded in parallel and drawn on the main thread, labels need fonts
+class thumbnailWriter : public ProjectLevelConsumer
+{
+public:
+    DiagramRenderer m_renderer;
+    QSize m_size;
+    QDir m_outputDir;
+    int m_written;
+    int m_failed;
+
+    thumbnailWriter()
+    {
+        m_written = 0;
+        m_failed = 0;
+    }
+
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(index);
+        if(renderLevel(m_renderer, elements, m_size,
+                       m_outputDir.filePath(SiteExporter::graphName(levelFile) + ".png")))
+            m_written++;
+        else
+            m_failed++;
+        return false;
+    }
+    void levelFailed(int index, const QString &levelFile)
+    {
+        Q_UNUSED(index);
+        qWarning() << "Cannot read" << levelFile;
+        m_failed++;
+    }
+};
+
+static int commandThumbnails(const QStringList &args)
+{
+    thumbnailWriter writer;
+    writer.m_size = QSize(320, 200);
+    if(args.isEmpty() || !parseRenderOptions(args, &writer.m_size, &writer.m_renderer))
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    QStringList levelFiles = LevelStorage::allLevelFiles();
+    if(levelFiles.isEmpty())
+    {
+        qWarning() << "No documentation level found in" << GDS_DIR;
+        return EXIT_FAILURE;
+    }
+    if(!QDir().mkpath(args[0]))
+    {
+        qWarning() << "Cannot create" << args[0];
+        return EXIT_FAILURE;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    writer.m_outputDir = QDir(args[0]);
+    ProjectReader reader;
+    reader.setMaxThreadCount(readerThreads);
+    reader.read(levelFiles, &writer);
+    standardOutput() << "# " << writer.m_written << " thumbnails (" << writer.m_size.width() << "x"
+                     << writer.m_size.height() << ") written in " << timer.elapsed() << " ms, " << writer.m_failed
+                     << " failed" << endl;
+    return (writer.m_failed > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//// convert-comments
+
+// Converts the html comments of every level to the compact rich text format (see RichTextFormat). Comments the
+// format can't represent (tables) stay html. Levels are rewritten as compact does, a dry run only measures
+class commentConverter : public ProjectLevelConsumer
+{
+public:
+    bool m_dryRun;
+    int m_converted;
+    int m_kept;
+    int m_failed;
+    qint64 m_htmlBytes;
+    qint64 m_compactBytes;
+    qint64 m_htmlLoadNs;
+    qint64 m_compactLoadNs;
+
+    commentConverter()
+    {
+        m_dryRun = false;
+        m_converted = 0;
+        m_kept = 0;
+        m_failed = 0;
+        m_htmlBytes = 0;
+        m_compactBytes = 0;
+        m_htmlLoadNs = 0;
+        m_compactLoadNs = 0;
+    }
+
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(index);
+        int converted = 0;
+        for(int i=0; i<elements.size(); i++)
+        {
+            QByteArray &comment = elements[i]->data;
+            if(comment.isEmpty() || RichTextFormat::isCompact(comment))
+                continue;
+
+            QTextDocument document;
+            document.setUndoRedoEnabled(false);
+            QElapsedTimer timer;
+            timer.start();
+            document.setHtml(QString(comment));
+            qint64 htmlLoad = timer.nsecsElapsed();
+
+            QByteArray compact = RichTextCodec::encode(document);
+            if(compact.isEmpty())
+            {
+                m_kept++;
+                continue;
+            }
+
+            timer.restart();
+            RichTextCodec::decode(compact, document);
+            m_compactLoadNs += timer.nsecsElapsed();
+            m_htmlLoadNs += htmlLoad;
+            m_htmlBytes += comment.size();
+            m_compactBytes += compact.size();
+            comment = compact;
+            converted++;
+        }
+        m_converted += converted;
+        if(converted == 0 || m_dryRun)
+            return false;
+
+        QString tempFile = levelFile + ".tmp";
+        QFile::remove(tempFile);
+        if(!LevelStorage::writeLevelFile(tempFile, elements) || !QFile::remove(levelFile) ||
+           !QFile::rename(tempFile, levelFile))
+        {
+            qWarning() << "Cannot rewrite" << levelFile;
+            m_failed++;
+        }
+        return false;
+    }
+    void levelFailed(int index, const QString &levelFile)
+    {
+        Q_UNUSED(index);
+        qWarning() << "Cannot read" << levelFile << "- the file is left untouched";
+        m_failed++;
+    }
+};
+
+static int commandConvertComments(const QStringList &args)
+{
+    QStringList levelFiles = LevelStorage::allLevelFiles();
+    if(levelFiles.isEmpty())
+    {
+        qWarning() << "No documentation level found in" << GDS_DIR;
+        return EXIT_FAILURE;
+    }
+
+    commentConverter converter;
+    converter.m_dryRun = args.contains("--dry-run");
+    ProjectReader reader;
+    reader.setMaxThreadCount(readerThreads);
+    reader.read(levelFiles, &converter);
+
+    // Sizes are uncompressed, level files compress every comment
+    standardOutput() << "# " << converter.m_converted << " comments " << (converter.m_dryRun ? "convertible" : "converted")
+                     << ", " << converter.m_kept << " kept as html" << endl
+                     << "# size: html " << converter.m_htmlBytes << " bytes, compact " << converter.m_compactBytes
+                     << " bytes" << endl
+                     << "# load: html " << converter.m_htmlLoadNs / 1000000 << " ms, compact "
+                     << converter.m_compactLoadNs / 1000000 << " ms" << endl;
+    return (converter.m_failed > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//// decode
+
+class levelDiscarder : public ProjectLevelConsumer
+{
+public:
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(index);
+        Q_UNUSED(levelFile);
+        Q_UNUSED(elements);
+        return false;
+    }
+};
+
+static int commandDecode(const QStringList &args)
+{
+    Q_UNUSED(args);
+    QStringList levelFiles = LevelStorage::allLevelFiles();
+    if(levelFiles.isEmpty())
+    {
+        qWarning() << "No documentation level found in" << GDS_DIR;
+        return EXIT_FAILURE;
+    }
+
+    levelDiscarder discarder;
+    ProjectReader reader;
+    reader.setMaxThreadCount(readerThreads);
+    reader.read(levelFiles, &discarder);
+    standardOutput() << reader.summary() << endl;
+    return (reader.failedCount() > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    // Text documents need QtGui (fonts), not a display
+    QApplication app(argc, argv, false);
+    QStringList args = app.arguments();
+    args.removeFirst();
+
+    // Global options come before the command
+    QString appDir;
+    while(!args.isEmpty() && args[0].startsWith("-"))
+    {
+        QString option = args.takeFirst();
+        if(args.isEmpty())
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        if(option == "-C")
+        {
+            QString projectDir = args.takeFirst();
+            if(!QDir::setCurrent(projectDir))
+            {
+                qWarning() << "Cannot change directory to" << projectDir;
+                return EXIT_FAILURE;
+            }
+        }
+        else if(option == "--app-dir")
+            appDir = args.takeFirst();
+        else if(option == "--threads")
+            readerThreads = args.takeFirst().toInt();
+        else if(option == "--log")
+        {
+            // Same syntax as gds' --log, e.g. storage=info
+            QString levels = args.takeFirst();
+            if(!Logger::configure(levels))
+            {
+                qWarning() << "Invalid log levels" << levels;
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    if(args.isEmpty())
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    // gds runs from the project directory, code file paths are relative to it
+    LevelStorage::setApplicationDir(appDir.isEmpty() ? QDir::currentPath() : appDir);
+
+    QString command = args.takeFirst();
+    if(command == "levels")
+        return commandLevels(args);
+    if(command == "dump")
+        return commandDump(args);
+    if(command == "validate")
+        return commandValidate(args);
+    if(command == "reanchor")
+        return commandReanchor(args);
+    if(command == "compact")
+        return commandCompact(args);
+    if(command == "convert-comments")
+        return commandConvertComments(args);
+    if(command == "export")
+        return commandExport(args);
+    if(command == "export-site")
+        return commandExportSite(args);
+    if(command == "render")
+        return commandRender(args);
+    if(command == "thumbnails")
+        return commandThumbnails(args);
+    if(command == "decode")
+        return commandDecode(args);
+
+    printUsage();
+    return EXIT_FAILURE;
+}
@@ -1,41 +1,59 @@
-#ifndef CODEEDITORWIDGET_H
-#define CODEEDITORWIDGET_H
-
-#include <QTextEdit>
-#include <QDebug>
-#include <QTextBlock>
-#include <QMouseEvent>
-#include <QPainter>
-#include <QLayout>
-#include <QScrollBar>
-#include <QApplication>
-
-class CodeEditorWidget : public QTextEdit
-{
-    Q_OBJECT
-public:
-    explicit CodeEditorWidget(QTextEdit &lineCounter, QWidget *parent = 0);
-
-    // This vector stores the line numbers currently selected
-    QVector<quint32> m_selectedLines;
-    void highlightLines(QVector<quint32> linesNumbers);
-    QString getLineData(quint32 blockNum);
-    void clearAllCodeHighlights();
-
-    bool m_editMode; // Need to be set if in view mode
-
-protected:
-    void mouseReleaseEvent(QMouseEvent *e);
-
-private:
-    // A friend textedit to count lines
-    QTextEdit *m_lineCounter;
-
-signals:
-     void updateScrollBarValueChanged(int newValue);
-
-private slots:
-    void updateFriendLineCounter();
-};
-
-#endif // CODEEDITORWIDGET_H
+#ifndef CODEEDITORWIDGET_H
+#define CODEEDITORWIDGET_H
+
+#include <QTextEdit>
+#include <QDebug>
+#include <QTextBlock>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QLayout>
+#include <QScrollBar>
+#include <QApplication>
+
+class CppHighlighter;
+
+class CodeEditorWidget : public QTextEdit
+{
+    Q_OBJECT
+public:
+    explicit CodeEditorWidget(QTextEdit &lineCounter, QWidget *parent = 0);
+
+    // This vector stores the line numbers currently selected
+    QVector<quint32> m_selectedLines;
+    void highlightLines(QVector<quint32> linesNumbers);
+    QString getLineData(quint32 blockNum);
+    void clearAllCodeHighlights();
+
+    bool m_editMode; // Need to be set if in view mode
+
+    // The highlighter is told which blocks are on screen so it can highlight them first
+    void setHighlighter(CppHighlighter *highlighter);
+
+    // Loads a code file content, if it's the same content already loaded only the highlighted lines are
+    // cleared. Returns false if the document wasn't reloaded
+    bool loadCode(const QByteArray &data);
+
+protected:
+    void mouseReleaseEvent(QMouseEvent *e);
+    void resizeEvent(QResizeEvent *e);
+
+private:
+    // A friend textedit to count lines
+    QTextEdit *m_lineCounter;
+    CppHighlighter *m_highlighter;
+
+    // What has been loaded last with loadCode()
+    QByteArray m_loadedContentHash;
+    int m_loadedCharacterCount;
+
+signals:
+     void updateScrollBarValueChanged(int newValue);
+     // The user highlighted or cleared some lines (lines set with highlightLines() don't emit it)
+     void selectedLinesChanged();
+
+private slots:
+    void updateFriendLineCounter();
+    void updateVisibleBlocks();
+};
+
+#endif // CODEEDITORWIDGET_H
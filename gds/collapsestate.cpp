@@ -0,0 +1,44 @@
+#include "collapsestate.h"
+#include <QSettings>
+#include <QStringList>
+#include <QFileInfo>
+#include <QCryptographicHash>
+
+// Paths can't be used as keys (slashes are groups), their hash is
+QString CollapseState::settingsKey(const QString &levelFile)
+{
+    QByteArray path = QFileInfo(levelFile).absoluteFilePath().toUtf8();
+    return "collapsedBlocks/" + QString(QCryptographicHash::hash(path, QCryptographicHash::Md5).toHex());
+}
+
+QSet<quint64> CollapseState::collapsedBlocks(const QString &levelFile)
+{
+    QSettings settings(QSettings::UserScope, "gds", "gds");
+    QStringList ids = settings.value(settingsKey(levelFile)).toStringList();
+    QSet<quint64> blocks;
+    for(int i=0; i<ids.size(); i++)
+    {
+        bool ok = false;
+        quint64 id = ids[i].toULongLong(&ok);
+        if(ok)
+            blocks.insert(id);
+    }
+    return blocks;
+}
+
+void CollapseState::setCollapsed(const QString &levelFile, quint64 uniqueID, bool collapsed)
+{
+    QSettings settings(QSettings::UserScope, "gds", "gds");
+    QString key = settingsKey(levelFile);
+    QStringList ids = settings.value(key).toStringList();
+    QString id = QString::number(uniqueID);
+    ids.removeAll(id);
+    if(collapsed)
+        ids.append(id);
+
+    // Levels with nothing collapsed leave nothing behind
+    if(ids.isEmpty())
+        settings.remove(key);
+    else
+        settings.setValue(key, ids);
+}
@@ -0,0 +1,22 @@
+#ifndef COLLAPSESTATE_H
+#define COLLAPSESTATE_H
+
+// The blocks every user has collapsed in the diagram, per level file. It's a reading preference, not part of the
+// documentation: it's kept in the user's settings (QSettings: the registry on Windows, ~/.config elsewhere), never
+// in the level files. Blocks are identified by their uniqueID, levels by their absolute path so that different
+// projects don't share their state
+
+#include <QString>
+#include <QSet>
+
+class CollapseState
+{
+public:
+    static QSet<quint64> collapsedBlocks(const QString &levelFile);
+    static void setCollapsed(const QString &levelFile, quint64 uniqueID, bool collapsed);
+
+private:
+    static QString settingsKey(const QString &levelFile);
+};
+
+#endif // COLLAPSESTATE_H
@@ -0,0 +1,108 @@
+#include "commentcache.h"
+#include "profiler.h"
+#include "richtextcodec.h"
+#include <QTextDocument>
+#include <QCryptographicHash>
+
+static QByteArray documentKey(const QByteArray &html)
+{
+    return QCryptographicHash::hash(html, QCryptographicHash::Md5);
+}
+
+CommentDocumentCache::CommentDocumentCache()
+{
+    m_usedBytes = 0;
+}
+
+CommentDocumentCache::~CommentDocumentCache()
+{
+    clear();
+}
+
+void CommentDocumentCache::setDefaultFont(const QFont &font)
+{
+    m_defaultFont = font;
+}
+
+QTextDocument *CommentDocumentCache::document(const QByteArray &html)
+{
+    QByteArray key = documentKey(html);
+    m_shown = key;
+
+    if(m_documents.contains(key))
+    {
+        touch(key);
+        return m_documents[key].document;
+    }
+    return parse(key, html);
+}
+
+bool CommentDocumentCache::preload(const QByteArray &html)
+{
+    QByteArray key = documentKey(html);
+    if(m_documents.contains(key))
+        return false;
+    parse(key, html);
+    return true;
+}
+
+bool CommentDocumentCache::contains(const QByteArray &html) const
+{
+    return m_documents.contains(documentKey(html));
+}
+
+void CommentDocumentCache::clear()
+{
+    QHash<QByteArray, cachedDocument>::iterator itr = m_documents.begin();
+    while(itr != m_documents.end())
+    {
+        delete itr.value().document;
+        itr++;
+    }
+    m_documents.clear();
+    m_usageOrder.clear();
+    m_shown.clear();
+    m_usedBytes = 0;
+}
+
+QTextDocument *CommentDocumentCache::parse(const QByteArray &key, const QByteArray &html)
+{
+    PROFILE_SCOPE("parseCommentDocument");
+
+    // Nobody edits them, undo history would just take memory
+    QTextDocument *document = new QTextDocument();
+    document->setUndoRedoEnabled(false);
+    document->setDefaultFont(m_defaultFont);
+    RichTextCodec::load(html, *document);
+
+    cachedDocument entry;
+    entry.document = document;
+    entry.cost = html.size();
+    m_documents.insert(key, entry);
+    m_usedBytes += entry.cost;
+    touch(key);
+    evict();
+    return document;
+}
+
+void CommentDocumentCache::touch(const QByteArray &key)
+{
+    m_usageOrder.removeOne(key);
+    m_usageOrder.append(key);
+}
+
+void CommentDocumentCache::evict()
+{
+    for(int i=0; i<m_usageOrder.size() && m_usedBytes > (qint64)MEMORY_BUDGET_KB * 1024; )
+    {
+        if(m_usageOrder[i] == m_shown)
+        {
+            i++;
+            continue;
+        }
+        cachedDocument entry = m_documents.take(m_usageOrder[i]);
+        delete entry.document;
+        m_usedBytes -= entry.cost;
+        m_usageOrder.removeAt(i);
+    }
+}
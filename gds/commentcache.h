@@ -0,0 +1,54 @@
+#ifndef COMMENTCACHE_H
+#define COMMENTCACHE_H
+
+// Parsed comment documents of the blocks recently shown and of the ones likely to be shown next. Loading a
+// comment (images are embedded into it, older ones are html) and laying it out is most of the time spent showing
+// a block in view mode, a cached document is just swapped into the comments pane. Documents are keyed by a hash
+// of the stored comment, an edited comment never gets an old document
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QFont>
+
+class QTextDocument;
+
+class CommentDocumentCache
+{
+public:
+    CommentDocumentCache();
+    ~CommentDocumentCache();
+
+    // Font of the pane the documents are shown in
+    void setDefaultFont(const QFont &font);
+
+    // The document for this html, parsed now if it isn't cached. The document is owned by the cache and it's the
+    // shown one until the next call: it won't be evicted in the meanwhile
+    QTextDocument *document(const QByteArray &html);
+    // Parses a document ahead of time, returns false if it was already cached
+    bool preload(const QByteArray &html);
+    bool contains(const QByteArray &html) const;
+    void clear();
+
+    // Approximated memory used by the documents (their stored size) before the least recently used are freed
+    static const int MEMORY_BUDGET_KB = 64 * 1024;
+
+private:
+    struct cachedDocument
+    {
+        QTextDocument *document;
+        int cost;
+    };
+
+    QTextDocument *parse(const QByteArray &key, const QByteArray &html);
+    void touch(const QByteArray &key);
+    void evict();
+
+    QHash<QByteArray, cachedDocument> m_documents;
+    QList<QByteArray> m_usageOrder; // Least recently used first
+    QByteArray m_shown;             // Never evicted
+    qint64 m_usedBytes;
+    QFont m_defaultFont;
+};
+
+#endif // COMMENTCACHE_H
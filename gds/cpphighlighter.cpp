@@ -1,126 +1,276 @@
-#include "cpphighlighter.h"
-
-CppHighlighter::CppHighlighter(QTextDocument *parent) :
-    QSyntaxHighlighter(parent)
-{
-    // Defines a set of syntax rules structures with the couple
-    // QRegExp pattern; -> the matching regex on the text
-    // QTextCharFormat format; -> the format to apply to the matching text
-    //
-    // This is pretty much the same method used in the richtext-syntaxhighlighter demo
-    HighlightingRule rule;
-
-    // Define C/C++ keywords and their color
-    keywordFormat.setForeground(Qt::blue);
-    keywordFormat.setFontWeight(QFont::Bold);
-    QStringList keywordPatterns;
-    keywordPatterns << "\\bchar\\b" << "\\bclass\\b" << "\\bconst\\b"
-                    << "\\bdouble\\b" << "\\benum\\b" << "\\bexplicit\\b"
-                    << "\\bfriend\\b" << "\\binline\\b" << "\\bint\\b"
-                    << "\\blong\\b" << "\\bnamespace\\b" << "\\boperator\\b"
-                    << "\\bprivate\\b" << "\\bprotected\\b" << "\\bpublic\\b"
-                    << "\\bshort\\b" << "\\bsignals\\b" << "\\bsigned\\b"
-                    << "\\bslots\\b" << "\\bstatic\\b" << "\\bstruct\\b"
-                    << "\\btemplate\\b" << "\\btypedef\\b" << "\\btypename\\b"
-                    << "\\bunion\\b" << "\\bunsigned\\b" << "\\bvirtual\\b"
-                    << "\\bvoid\\b" << "\\bvolatile\\b";
-    // Insert each of the above keywords in the vector that contains all the text rules
-    foreach (const QString &pattern, keywordPatterns)
-    {
-        rule.pattern = QRegExp(pattern);
-        rule.format = keywordFormat;
-        highlightingRules.append(rule);
-    }
-
-    // Rule: Qt class name or keyword
-    classFormat.setFontWeight(QFont::Bold);
-    classFormat.setForeground(Qt::darkMagenta);
-    rule.pattern = QRegExp("\\bQ[A-Za-z]+\\b");
-    rule.format = classFormat;
-    highlightingRules.append(rule);
-
-    // Rule: single line text comment
-    singleLineCommentFormat.setForeground(Qt::darkGreen);
-    rule.pattern = QRegExp("//[^\n]*");
-    rule.format = singleLineCommentFormat;
-    highlightingRules.append(rule);
-
-    // Multiline comments cannot be applied with a single regex but are handled with "blocks" of text in the
-    // highlightBlock function
-    multiLineCommentFormat.setForeground(Qt::darkGreen);
-
-    // Rule: text between quotation marks
-    quotationFormat.setForeground(Qt::darkYellow);
-    rule.pattern = QRegExp("\".*\"");
-    rule.format = quotationFormat;
-    highlightingRules.append(rule);
-
-    // Rule: function name()
-    //functionFormat.setFontItalic(true);
-    //functionFormat.setFontWeight(QFont::Bold);
-    functionFormat.setForeground(Qt::darkRed);
-    rule.pattern = QRegExp("\\b[A-Za-z0-9_]+(?=\\()");
-    rule.format = functionFormat;
-    highlightingRules.append(rule);
-
-    // Multiline comments start and end regex, used in the "highlighBlock" function
-    commentStartExpression = QRegExp("/\\*");
-    commentEndExpression = QRegExp("\\*/");
-}
-
-// This function is called whenever a text block changes or whenever the
-// entire document needs to. The "text" variable is each line that has been changed, this
-// function is called multiple times
-void CppHighlighter::highlightBlock(const QString &text)
-{
-    // Try to apply each rule to this changed block of text
-    foreach (const HighlightingRule &rule, highlightingRules)
-    {
-        // If this rule matches the text, store the initial index
-        QRegExp expression(rule.pattern);
-        int index = expression.indexIn(text);
-        // Index is negative if there was no match with the regex
-        while (index >= 0)
-        {
-            // Apply the rule format to this portion of text
-            int length = expression.matchedLength();
-            setFormat(index, length, rule.format);
-            // Continue searching the text block for other matches
-            index = expression.indexIn(text, index + length);
-        }
-    }
-
-    // Now handle the /**/ multiline comment
-
-    // Set this block to 0 - not in comment
-    setCurrentBlockState(0);
-
-    // Try to find a /* occurrence
-    int startIndex = 0;
-    // If the previous block wasn't in comment, try to find a /*
-    if (previousBlockState() != 1)
-        startIndex = commentStartExpression.indexIn(text);
-
-    while (startIndex >= 0)
-    {
-        // There's a /* occurrence in this block or there was one in one of the previous ones
-        int endIndex = commentEndExpression.indexIn(text, startIndex);
-        int commentLength;
-
-        if (endIndex == -1)
-        {
-            // No */ occurrence, just get the total length of this block and comment everything
-            setCurrentBlockState(1);
-            commentLength = text.length() - startIndex;
-        }
-        else
-        {
-            // If there's a /* in this line, comment just what's before it
-            commentLength = endIndex - startIndex
-                    + commentEndExpression.matchedLength(); // plus the "/*" size, alias 2
-        }
-        setFormat(startIndex, commentLength, multiLineCommentFormat);
-        // Search for other occurrences on this line (if we're totally commented, the commentLength will take us to the end)
-        startIndex = commentStartExpression.indexIn(text, startIndex + commentLength);
-    }
-}
+#include "cpphighlighter.h"
+#include "profiler.h"
+#include <QTextDocument>
+#include <QTextLayout>
+
+// A block state is final if it was lexed after a block with a final state
+static inline bool isFinalState(int state)
+{
+    return state >= 0 && (state & (CppHighlighter::BLOCK_PROVISIONAL | CppHighlighter::BLOCK_PENDING)) == 0;
+}
+
+// Best guess of the lexer state stored into a block state
+static inline int lexerStateOf(int state)
+{
+    if(state < 0)
+        return CppLexer::STATE_NORMAL;
+    return state & ~(CppHighlighter::BLOCK_PROVISIONAL | CppHighlighter::BLOCK_PENDING);
+}
+
+CppHighlighter::CppHighlighter(QTextDocument *parent) :
+    QSyntaxHighlighter(parent)
+{
+    // Every line is scanned just once by the CppLexer, which splits it into tokens: here we just
+    // define the format to apply to each token type
+
+    // C/C++ keywords
+    tokenFormats[TOKEN_KEYWORD].setForeground(Qt::blue);
+    tokenFormats[TOKEN_KEYWORD].setFontWeight(QFont::Bold);
+
+    // Qt class names
+    tokenFormats[TOKEN_QT_CLASS].setFontWeight(QFont::Bold);
+    tokenFormats[TOKEN_QT_CLASS].setForeground(Qt::darkMagenta);
+
+    // Single line and multiline comments
+    tokenFormats[TOKEN_COMMENT].setForeground(Qt::darkGreen);
+
+    // Text between quotation marks (raw strings too) and character literals
+    tokenFormats[TOKEN_STRING].setForeground(Qt::darkYellow);
+    tokenFormats[TOKEN_CHAR].setForeground(Qt::darkYellow);
+
+    // #directives
+    tokenFormats[TOKEN_PREPROCESSOR].setForeground(Qt::darkBlue);
+
+    // Numeric literals
+    tokenFormats[TOKEN_NUMBER].setForeground(Qt::darkCyan);
+
+    // function name()
+    tokenFormats[TOKEN_FUNCTION].setForeground(Qt::darkRed);
+
+    // Plain identifiers are left with the default format
+
+    m_frontier = 0;
+    m_firstVisibleBlock = -1;
+    m_lastVisibleBlock = -1;
+    m_sliceActive = false;
+    m_hasCachedData = false;
+    m_recording = false;
+
+    // A zero-interval timer fires as soon as the event loop has nothing else to do
+    m_idleTimer = new QTimer(this);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(0);
+    connect(m_idleTimer, SIGNAL(timeout()), this, SLOT(highlightNextSlice()));
+}
+
+void CppHighlighter::setVisibleBlocks(int firstBlock, int lastBlock)
+{
+    m_firstVisibleBlock = firstBlock;
+    m_lastVisibleBlock = lastBlock;
+
+    // Visible blocks might need to be highlighted
+    if(!isHighlightingComplete())
+        m_idleTimer->start();
+}
+
+bool CppHighlighter::isHighlightingComplete() const
+{
+    return document() == NULL || m_frontier >= document()->blockCount();
+}
+
+void CppHighlighter::setContentHash(const QByteArray &contentHash)
+{
+    m_contentHash = contentHash;
+    m_recordedData = highlightData();
+    m_hasCachedData = HighlightCache::find(contentHash, m_cachedData);
+    if(!m_hasCachedData)
+        m_cachedData = highlightData();
+    // Nothing to record if we already have it
+    m_recording = !m_hasCachedData;
+}
+
+// Every synchronous highlighting run gets its own time budget, it ends when the event loop gets control back
+void CppHighlighter::startSlice()
+{
+    m_sliceActive = true;
+    m_sliceTimer.start();
+    m_idleTimer->start();
+}
+
+// This function is called whenever a text block changes or whenever the
+// entire document needs to. The "text" variable is each line that has been changed, this
+// function is called multiple times
+void CppHighlighter::highlightBlock(const QString &text)
+{
+    PROFILE_SCOPE("highlightBlock");
+    if(!m_sliceActive)
+        startSlice();
+
+    QTextBlock block = currentBlock();
+    int blockNumber = block.blockNumber();
+    int previousState = previousBlockState();
+    bool previousIsFinal = (blockNumber == 0 || isFinalState(previousState));
+
+    if(previousIsFinal && m_sliceTimer.elapsed() < SLICE_BUDGET_MS)
+    {
+        // The right state is known and there's still time: final highlighting
+        lexCurrentBlock(text, previousState, false);
+    }
+    else if(blockNumber >= m_firstVisibleBlock && blockNumber <= m_lastVisibleBlock)
+    {
+        // On screen, highlight it anyway with the best guess for its previous state
+        lexCurrentBlock(text, previousState, !previousIsFinal);
+    }
+    else
+    {
+        // Defer it: keep the formats it already has (if any) and mark it as pending. Leaving the state
+        // unchanged for blocks already pending also stops Qt from going on with the next blocks
+        int state = currentBlockState();
+        if(state >= 0)
+        {
+            const QList<QTextLayout::FormatRange> formats = block.layout()->additionalFormats();
+            for(int i=0; i<formats.size(); i++)
+                setFormat(formats[i].start, formats[i].length, formats[i].format);
+            setCurrentBlockState(state | BLOCK_PENDING);
+        }
+        // The background pass has to come back here
+        if(blockNumber < m_frontier)
+            m_frontier = blockNumber;
+    }
+}
+
+void CppHighlighter::lexCurrentBlock(const QString &text, int previousState, bool provisional)
+{
+    int blockNumber = currentBlock().blockNumber();
+
+    // Final highlighting might be already in the cache
+    if(!provisional && applyCachedBlock(blockNumber, text.length(), previousState))
+        return;
+
+    // The previous block state tells the lexer if we're inside a multiline comment or raw string
+    m_tokens.resize(0);
+    int state = CppLexer::lexLine(text, lexerStateOf(previousState), m_tokens);
+    if(!provisional)
+        recordBlock(blockNumber, text.length(), state);
+
+    // Apply the format of each token found
+    for(int i=0; i<m_tokens.size(); i++)
+    {
+        const cppToken &token = m_tokens[i];
+        setFormat(token.start, token.length, tokenFormats[token.type]);
+    }
+
+    // If the state changes, the next block will be highlighted again
+    setCurrentBlockState(provisional ? (state | BLOCK_PROVISIONAL) : state);
+}
+
+bool CppHighlighter::applyCachedBlock(int blockNumber, int textLength, int previousState)
+{
+    if(!m_hasCachedData || blockNumber >= m_cachedData.lineCount())
+        return false;
+
+    // The cached tokens are valid only if the line and the state it starts with are the same
+    int cachedPreviousState = (blockNumber == 0) ? CppLexer::STATE_NORMAL : m_cachedData.lineStates[blockNumber-1];
+    if(m_cachedData.lineLengths[blockNumber] != textLength || cachedPreviousState != lexerStateOf(previousState))
+        return false;
+
+    for(int i=m_cachedData.firstToken[blockNumber]; i<m_cachedData.firstToken[blockNumber+1]; i++)
+    {
+        const cppToken &token = m_cachedData.tokens[i];
+        setFormat(token.start, token.length, tokenFormats[token.type]);
+    }
+    setCurrentBlockState(m_cachedData.lineStates[blockNumber]);
+    return true;
+}
+
+// Final highlighting proceeds from the first block to the last one, lines are appended as they're lexed
+void CppHighlighter::recordBlock(int blockNumber, int textLength, int state)
+{
+    if(!m_recording)
+        return;
+
+    int recordedLines = m_recordedData.lineCount();
+    if(blockNumber < recordedLines)
+        return; // Highlighted again (e.g. a block format changed), already recorded
+    if(blockNumber > recordedLines)
+    {
+        // A line has been skipped, the recording isn't usable anymore
+        m_recording = false;
+        m_recordedData = highlightData();
+        return;
+    }
+
+    m_recordedData.lineLengths.append(textLength);
+    m_recordedData.lineStates.append(state);
+    m_recordedData.firstToken.append(m_recordedData.tokens.size());
+    for(int i=0; i<m_tokens.size(); i++)
+        m_recordedData.tokens.append(m_tokens[i]);
+}
+
+void CppHighlighter::storeRecordedHighlighting()
+{
+    if(!m_recording)
+        return;
+    m_recording = false;
+
+    if(m_recordedData.lineCount() != document()->blockCount())
+    {
+        m_recordedData = highlightData();
+        return;
+    }
+    m_recordedData.firstToken.append(m_recordedData.tokens.size());
+    HighlightCache::insert(m_contentHash, m_recordedData);
+
+    // From now on use it like any other cached content
+    m_cachedData = m_recordedData;
+    m_hasCachedData = true;
+    m_recordedData = highlightData();
+}
+
+// Idle-time work: first the visible blocks, then the frontier is moved forward until the budget expires
+void CppHighlighter::highlightNextSlice()
+{
+    PROFILE_SCOPE("highlightNextSlice");
+    QTextDocument *doc = document();
+    if(doc == NULL)
+        return;
+
+    m_sliceActive = true;
+    m_sliceTimer.start();
+
+    // 1) Visible blocks still pending (highlighting one of them goes on with the following ones by itself)
+    if(m_firstVisibleBlock >= 0)
+    {
+        QTextBlock block = doc->findBlockByNumber(m_firstVisibleBlock);
+        while(block.isValid() && block.blockNumber() <= m_lastVisibleBlock)
+        {
+            int state = block.userState();
+            if(state < 0 || (state & BLOCK_PENDING))
+                rehighlightBlock(block);
+            block = block.next();
+        }
+    }
+
+    // 2) Background pass from the frontier, Qt keeps calling highlightBlock on the next blocks as long as
+    // their state changes and we're within the budget
+    QTextBlock block = doc->findBlockByNumber(m_frontier);
+    while(block.isValid() && m_sliceTimer.elapsed() < SLICE_BUDGET_MS)
+    {
+        if(!isFinalState(block.userState()))
+            rehighlightBlock(block);
+        if(!isFinalState(block.userState()))
+            break; // Out of budget
+        // Skip everything that became final
+        while(block.isValid() && isFinalState(block.userState()))
+            block = block.next();
+        m_frontier = block.isValid() ? block.blockNumber() : doc->blockCount();
+    }
+
+    m_sliceActive = false;
+
+    // Come back later if there's still something to do
+    if(!isHighlightingComplete())
+        m_idleTimer->start();
+    else
+        storeRecordedHighlighting();
+}
@@ -1,44 +1,89 @@
-#ifndef CPPHIGHLIGHTER_H
-#define CPPHIGHLIGHTER_H
-
-#include <QSyntaxHighlighter>
-
-#include <QVector>
-#include <QTextCharFormat>
-
-class CppHighlighter : public QSyntaxHighlighter
-{
-    Q_OBJECT
-public:
-    explicit CppHighlighter(QTextDocument *parent = 0);
-
-protected:
-    void highlightBlock(const QString &text);
-    
-signals:
-    
-public slots:
-
-private:
-    struct HighlightingRule
-    {
-        QRegExp pattern;
-        QTextCharFormat format;
-    };
-
-    // The vector that contains all the rules for the text
-    QVector<HighlightingRule> highlightingRules;
-
-    QRegExp commentStartExpression;
-    QRegExp commentEndExpression;
-
-    QTextCharFormat keywordFormat;
-    QTextCharFormat classFormat;
-    QTextCharFormat singleLineCommentFormat;
-    QTextCharFormat multiLineCommentFormat;
-    QTextCharFormat quotationFormat;
-    QTextCharFormat functionFormat;
-    
-};
-
-#endif // CPPHIGHLIGHTER_H
+#ifndef CPPHIGHLIGHTER_H
+#define CPPHIGHLIGHTER_H
+
+#include <QSyntaxHighlighter>
+
+#include <QVector>
+#include <QTextCharFormat>
+#include <QTextBlock>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "cpplexer.h"
+#include "highlightcache.h"
+
+// Highlighting is lazy and viewport-first: a synchronous highlighting run (e.g. the one triggered by
+// setPlainText) only lexes blocks until its time budget expires, the remaining blocks are left pending
+// and highlighted later in idle-time slices. Visible blocks are highlighted as soon as possible, even if
+// the blocks before them aren't ready yet (their previous state is guessed, and they will be highlighted
+// again when the background pass reaches them)
+class CppHighlighter : public QSyntaxHighlighter
+{
+    Q_OBJECT
+public:
+    explicit CppHighlighter(QTextDocument *parent = 0);
+
+    // Block states used on top of the CppLexer ones
+    enum blockStateFlags
+    {
+        BLOCK_PROVISIONAL = 0x4000000,  // Highlighted with a guessed previous state
+        BLOCK_PENDING = 0x8000000       // Not highlighted yet or stale (-1 is pending too)
+    };
+
+    // Time budget of each highlighting slice
+    static const int SLICE_BUDGET_MS = 8;
+
+    // The code editor tells us which blocks are on screen
+    void setVisibleBlocks(int firstBlock, int lastBlock);
+    // True when every block has been highlighted with its right state
+    bool isHighlightingComplete() const;
+
+    // Must be called before loading a new content into the document: if the content was highlighted
+    // before, its cached tokens are applied instead of lexing it again, otherwise the highlighting
+    // output is recorded and cached once complete
+    void setContentHash(const QByteArray &contentHash);
+
+protected:
+    void highlightBlock(const QString &text);
+    
+signals:
+    
+public slots:
+
+private slots:
+    void highlightNextSlice();
+
+private:
+    void startSlice();
+    void lexCurrentBlock(const QString &text, int previousState, bool provisional);
+    bool applyCachedBlock(int blockNumber, int textLength, int previousState);
+    void recordBlock(int blockNumber, int textLength, int state);
+    void storeRecordedHighlighting();
+
+    // One format for each token type emitted by the lexer
+    QTextCharFormat tokenFormats[TOKEN_TYPES_COUNT];
+
+    // Tokens buffer, reused for every line to avoid allocations
+    QVector<cppToken> m_tokens;
+
+    // Every block before this one is highlighted with its final state
+    int m_frontier;
+    // Blocks currently on screen
+    int m_firstVisibleBlock;
+    int m_lastVisibleBlock;
+
+    // The current slice and its time budget
+    bool m_sliceActive;
+    QElapsedTimer m_sliceTimer;
+    // Fires when the event loop is idle to highlight another slice
+    QTimer *m_idleTimer;
+
+    // Cached output of the current content (if found) or the one being recorded
+    QByteArray m_contentHash;
+    bool m_hasCachedData;
+    highlightData m_cachedData;
+    bool m_recording;
+    highlightData m_recordedData;
+    
+};
+
+#endif // CPPHIGHLIGHTER_H
@@ -0,0 +1,381 @@
+#include "cpplexer.h"
+
+// Keyword lookup table, generated offline. Each keyword is hashed with keywordHash() into one of the
+// KEYWORD_HASH_SLOTS slots, the seed has been chosen so that there are no collisions between keywords:
+// a lookup is just a hash and a single comparison. Slots contain the keyword index plus one (0 = empty)
+#define KEYWORD_HASH_SEED 5067
+#define KEYWORD_HASH_SLOTS 512
+#define KEYWORD_MAX_LENGTH 16
+static const char *cppKeywords[] =
+{
+    "signed", "alignas", "signals", "foreach", "thread_local", "or_eq", "case", "const_cast", "virtual",
+    "enum", "protected", "mutable", "alignof", "int", "true", "volatile", "if", "switch", "sizeof", "default",
+    "and_eq", "register", "xor_eq", "unsigned", "class", "compl", "char", "and", "using", "double",
+    "namespace", "extern", "struct", "this", "bitor", "not_eq", "char32_t", "final", "float", "static_assert",
+    "typedef", "export", "while", "not", "reinterpret_cast", "operator", "override", "auto", "typeid", "try",
+    "delete", "return", "typename", "constexpr", "noexcept", "bool", "dynamic_cast", "explicit", "static",
+    "for", "asm", "private", "const", "forever", "template", "break", "slots", "new", "friend", "or", "union",
+    "inline", "continue", "void", "bitand", "catch", "wchar_t", "static_cast", "public", "nullptr", "false",
+    "emit", "throw", "else", "do", "long", "char16_t", "xor", "short", "goto", "decltype"
+};
+static const unsigned char cppKeywordSlots[512] =
+{
+    0,0,1,0,0,0,0,0,0,0,0,0,0,2,3,0,0,4,0,0,0,0,5,0,0,0,0,6,0,0,0,7,
+    8,0,0,0,0,0,9,0,0,0,0,0,0,0,0,10,0,0,0,11,0,0,0,0,0,12,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,0,0,0,0,14,0,0,0,0,0,
+    0,0,0,0,0,0,15,16,0,0,0,0,0,0,0,17,0,0,0,0,0,0,0,0,0,18,0,19,0,0,0,20,
+    0,0,0,21,0,0,22,23,24,0,0,0,0,0,0,0,0,0,0,0,0,0,0,25,0,0,0,0,0,0,0,0,
+    26,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,27,0,0,0,28,0,0,29,0,30,0,0,0,0,0,0,31,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,32,0,0,0,0,33,0,0,0,0,34,0,0,35,0,0,36,0,0,0,0,0,0,0,37,0,
+    0,38,0,0,0,0,0,0,39,0,40,0,0,0,0,0,0,0,0,0,0,0,0,0,41,0,42,0,0,43,0,44,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,45,0,46,47,0,0,0,0,0,0,0,0,0,0,0,
+    48,49,0,0,0,0,0,0,0,50,0,51,0,52,0,0,0,0,0,53,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,54,0,0,55,0,0,56,0,0,0,0,0,57,0,0,58,0,0,0,0,0,0,0,0,0,0,59,60,0,0,0,
+    0,0,61,0,0,62,63,0,0,64,65,0,0,0,0,0,66,0,0,67,0,0,0,0,0,0,0,0,0,68,0,69,
+    0,0,0,70,71,72,73,74,0,75,0,0,76,77,0,78,0,0,0,0,0,0,0,0,0,79,80,0,0,81,0,0,
+    0,0,0,82,0,0,0,0,0,83,0,0,0,0,0,0,0,0,0,0,0,84,0,0,0,0,0,85,0,0,86,0,
+    0,0,0,0,0,87,0,0,0,0,0,0,0,88,89,0,0,0,0,0,0,0,90,0,0,91,0,0,0,0,0,0
+};
+
+static inline quint32 keywordHash(const QChar *text, int length)
+{
+    quint32 x = KEYWORD_HASH_SEED;
+    for(int i=0; i<length; i++)
+        x = (x ^ text[i].unicode()) * 16777619u;
+    return (x ^ (x >> 15)) & (KEYWORD_HASH_SLOTS-1);
+}
+
+bool CppLexer::isKeyword(const QChar *text, int length)
+{
+    if(length < 2 || length > KEYWORD_MAX_LENGTH)
+        return false;
+
+    unsigned char slot = cppKeywordSlots[keywordHash(text, length)];
+    if(slot == 0)
+        return false;
+
+    // The slot might be taken by another word with the same hash, compare it
+    const char *keyword = cppKeywords[slot-1];
+    for(int i=0; i<length; i++)
+    {
+        if(keyword[i] == '\0' || text[i].unicode() != (ushort)keyword[i])
+            return false;
+    }
+    return keyword[length] == '\0';
+}
+
+// Character classes
+static inline bool isDigitChar(ushort c)
+{
+    return c >= '0' && c <= '9';
+}
+static inline bool isIdentifierStart(QChar c)
+{
+    ushort u = c.unicode();
+    return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || u == '_' || (u > 127 && c.isLetter());
+}
+static inline bool isIdentifierChar(QChar c)
+{
+    ushort u = c.unicode();
+    return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || u == '_' || isDigitChar(u)
+            || (u > 127 && c.isLetterOrNumber());
+}
+static inline bool isRawDelimiterChar(ushort c)
+{
+    return c != ' ' && c != '(' && c != ')' && c != '\\' && c != '\t' && c != '\n' && c != '"';
+}
+
+// Raw string delimiters are stored into the line state as a 24 bit hash
+#define RAW_DELIMITER_MAX_LENGTH 16
+static inline quint32 delimiterHash(const QChar *text, int length)
+{
+    quint32 x = 2166136261u;
+    for(int i=0; i<length; i++)
+        x = (x ^ text[i].unicode()) * 16777619u;
+    return x & 0xFFFFFF;
+}
+
+// Returns the position right after the )delimiter" sequence closing a raw string or -1
+static int findRawStringEnd(const QChar *text, int from, int length, quint32 hash)
+{
+    for(int i=from; i<length; i++)
+    {
+        if(text[i] != QLatin1Char(')'))
+            continue;
+        for(int k=0; k<=RAW_DELIMITER_MAX_LENGTH && i+1+k < length; k++)
+        {
+            ushort c = text[i+1+k].unicode();
+            if(c == '"')
+            {
+                if(delimiterHash(text+i+1, k) == hash)
+                    return i+1+k+1;
+                break;
+            }
+            if(!isRawDelimiterChar(c))
+                break;
+        }
+    }
+    return -1;
+}
+
+// Returns the position of the */ closing a multi-line comment or -1
+static int findCommentEnd(const QChar *text, int from, int length)
+{
+    for(int i=from; i+1<length; i++)
+    {
+        if(text[i] == QLatin1Char('*') && text[i+1] == QLatin1Char('/'))
+            return i;
+    }
+    return -1;
+}
+
+// Returns the position right after a quoted literal (escapes are skipped), or the line end if unterminated
+static int scanQuoted(const QChar *text, int pos, int length, ushort quote)
+{
+    int i = pos+1;
+    while(i < length)
+    {
+        ushort c = text[i].unicode();
+        if(c == '\\')
+        {
+            i += 2;
+            continue;
+        }
+        if(c == quote)
+            return i+1;
+        i++;
+    }
+    return length;
+}
+
+// Returns the position right after a numeric literal (integers, floats, hex, suffixes and ' separators)
+static int scanNumber(const QChar *text, int pos, int length)
+{
+    bool hex = (text[pos] == QLatin1Char('0') && pos+1 < length
+                && (text[pos+1] == QLatin1Char('x') || text[pos+1] == QLatin1Char('X')));
+    int i = pos;
+    while(i < length)
+    {
+        ushort c = text[i].unicode();
+        if(isIdentifierChar(text[i]) || c == '.')
+            i++;
+        else if(c == '\'' && i > pos && i+1 < length && isIdentifierChar(text[i+1]))
+            i++; // Digit separator
+        else if((c == '+' || c == '-') && i > pos)
+        {
+            // Exponent sign
+            ushort previous = text[i-1].unicode();
+            if(((previous == 'e' || previous == 'E') && !hex) || previous == 'p' || previous == 'P')
+                i++;
+            else
+                break;
+        }
+        else
+            break;
+    }
+    return i;
+}
+
+static inline void appendToken(QVector<cppToken> &tokens, int start, int length, int type)
+{
+    if(length <= 0)
+        return;
+    cppToken token;
+    token.start = start;
+    token.length = length;
+    token.type = type;
+    tokens.append(token);
+}
+
+// Literal prefixes: L u U u8 for strings and characters
+static inline bool isLiteralPrefix(const QChar *text, int length)
+{
+    if(length == 1)
+        return text[0] == QLatin1Char('L') || text[0] == QLatin1Char('u') || text[0] == QLatin1Char('U');
+    return length == 2 && text[0] == QLatin1Char('u') && text[1] == QLatin1Char('8');
+}
+
+int CppLexer::lexLine(const QChar *text, int length, int previousState, QVector<cppToken> &tokens,
+                      bool emitIdentifiers)
+{
+    int pos = 0;
+
+    // 1) Continue what the previous line left open
+    if(previousState == STATE_MULTILINE_COMMENT)
+    {
+        int end = findCommentEnd(text, 0, length);
+        if(end == -1)
+        {
+            // No */ occurrence, comment everything
+            appendToken(tokens, 0, length, TOKEN_COMMENT);
+            return STATE_MULTILINE_COMMENT;
+        }
+        appendToken(tokens, 0, end+2, TOKEN_COMMENT);
+        pos = end+2;
+    }
+    else if(previousState >= STATE_RAW_STRING && previousState < STATE_MAX)
+    {
+        int end = findRawStringEnd(text, 0, length, previousState - STATE_RAW_STRING);
+        if(end == -1)
+        {
+            appendToken(tokens, 0, length, TOKEN_STRING);
+            return previousState;
+        }
+        appendToken(tokens, 0, end, TOKEN_STRING);
+        pos = end;
+    }
+
+    // 2) Preprocessor directives: the first non-blank character is #
+    int first = pos;
+    while(first < length && text[first].isSpace())
+        first++;
+    if(first < length && text[first] == QLatin1Char('#'))
+    {
+        int end = first+1;
+        while(end < length && text[end].isSpace())
+            end++;
+        int directiveStart = end;
+        while(end < length && isIdentifierChar(text[end]))
+            end++;
+        appendToken(tokens, first, end-first, TOKEN_PREPROCESSOR);
+        pos = end;
+
+        // #include <file> is a string too
+        QString directive(text+directiveStart, end-directiveStart);
+        if(directive == QLatin1String("include") || directive == QLatin1String("import"))
+        {
+            while(pos < length && text[pos].isSpace())
+                pos++;
+            if(pos < length && text[pos] == QLatin1Char('<'))
+            {
+                int close = pos+1;
+                while(close < length && text[close] != QLatin1Char('>'))
+                    close++;
+                close = qMin(close+1, length);
+                appendToken(tokens, pos, close-pos, TOKEN_STRING);
+                pos = close;
+            }
+        }
+        // The rest of the directive is lexed as normal code
+    }
+
+    // 3) Everything else, just one scan
+    while(pos < length)
+    {
+        ushort c = text[pos].unicode();
+        ushort next = (pos+1 < length) ? text[pos+1].unicode() : 0;
+
+        if(c == '/' && next == '/')
+        {
+            // Single line comment, till the end
+            appendToken(tokens, pos, length-pos, TOKEN_COMMENT);
+            return STATE_NORMAL;
+        }
+        if(c == '/' && next == '*')
+        {
+            int end = findCommentEnd(text, pos+2, length);
+            if(end == -1)
+            {
+                // The comment continues on the next lines
+                appendToken(tokens, pos, length-pos, TOKEN_COMMENT);
+                return STATE_MULTILINE_COMMENT;
+            }
+            appendToken(tokens, pos, end+2-pos, TOKEN_COMMENT);
+            pos = end+2;
+            continue;
+        }
+        if(c == '"')
+        {
+            int end = scanQuoted(text, pos, length, '"');
+            appendToken(tokens, pos, end-pos, TOKEN_STRING);
+            pos = end;
+            continue;
+        }
+        if(c == '\'')
+        {
+            int end = scanQuoted(text, pos, length, '\'');
+            appendToken(tokens, pos, end-pos, TOKEN_CHAR);
+            pos = end;
+            continue;
+        }
+        if(isDigitChar(c) || (c == '.' && isDigitChar(next)))
+        {
+            int end = scanNumber(text, pos, length);
+            appendToken(tokens, pos, end-pos, TOKEN_NUMBER);
+            pos = end;
+            continue;
+        }
+        if(isIdentifierStart(text[pos]))
+        {
+            int start = pos;
+            pos++;
+            while(pos < length && isIdentifierChar(text[pos]))
+                pos++;
+            int identifierLength = pos-start;
+
+            // Prefixed literals: u8"", L'', R"delimiter()delimiter", LR"()" and so on
+            if(pos < length && (text[pos] == QLatin1Char('"') || text[pos] == QLatin1Char('\'')))
+            {
+                bool raw = (text[pos] == QLatin1Char('"') && text[pos-1] == QLatin1Char('R')
+                            && (identifierLength == 1 || isLiteralPrefix(text+start, identifierLength-1)));
+                if(raw)
+                {
+                    int delimiterEnd = pos+1;
+                    while(delimiterEnd < length && delimiterEnd-(pos+1) < RAW_DELIMITER_MAX_LENGTH
+                          && isRawDelimiterChar(text[delimiterEnd].unicode()))
+                        delimiterEnd++;
+                    if(delimiterEnd < length && text[delimiterEnd] == QLatin1Char('('))
+                    {
+                        quint32 hash = delimiterHash(text+pos+1, delimiterEnd-(pos+1));
+                        int end = findRawStringEnd(text, delimiterEnd+1, length, hash);
+                        if(end == -1)
+                        {
+                            // The raw string continues on the next lines
+                            appendToken(tokens, start, length-start, TOKEN_STRING);
+                            return STATE_RAW_STRING + hash;
+                        }
+                        appendToken(tokens, start, end-start, TOKEN_STRING);
+                        pos = end;
+                        continue;
+                    }
+                    // Malformed raw string, R is just an identifier
+                }
+                else if(isLiteralPrefix(text+start, identifierLength))
+                {
+                    ushort quote = text[pos].unicode();
+                    int end = scanQuoted(text, pos, length, quote);
+                    appendToken(tokens, start, end-start, (quote == '"') ? TOKEN_STRING : TOKEN_CHAR);
+                    pos = end;
+                    continue;
+                }
+            }
+
+            if(isKeyword(text+start, identifierLength))
+            {
+                appendToken(tokens, start, identifierLength, TOKEN_KEYWORD);
+                continue;
+            }
+
+            // Qt class names are Q followed by letters only
+            bool qtClass = (identifierLength >= 2 && text[start] == QLatin1Char('Q'));
+            for(int i=start+1; qtClass && i<pos; i++)
+            {
+                ushort u = text[i].unicode();
+                qtClass = (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z');
+            }
+            if(qtClass)
+                appendToken(tokens, start, identifierLength, TOKEN_QT_CLASS);
+            else if(pos < length && text[pos] == QLatin1Char('('))
+                appendToken(tokens, start, identifierLength, TOKEN_FUNCTION);
+            else if(emitIdentifiers)
+                appendToken(tokens, start, identifierLength, TOKEN_IDENTIFIER);
+            continue;
+        }
+
+        // Whitespace, operators and punctuation are not interesting
+        pos++;
+    }
+
+    return STATE_NORMAL;
+}
@@ -0,0 +1,60 @@
+#ifndef CPPLEXER_H
+#define CPPLEXER_H
+
+// A single-pass C/C++ lexer working one line at a time. Each line is scanned just once and split
+// into tokens (only the interesting ones are emitted, whitespace and punctuation are skipped), the
+// state returned at the end of a line has to be passed to the next one (multi-line comments and
+// raw strings span several lines). This has no dependencies on the GUI so it can run on any thread
+
+#include <QString>
+#include <QVector>
+
+enum cppTokenType
+{
+    TOKEN_KEYWORD,
+    TOKEN_QT_CLASS,     // Q[A-Za-z]+ class names
+    TOKEN_COMMENT,      // Both single-line and multi-line comments
+    TOKEN_STRING,       // String literals, raw strings included
+    TOKEN_CHAR,         // Character literals
+    TOKEN_PREPROCESSOR, // The #directive part of a preprocessor line
+    TOKEN_NUMBER,
+    TOKEN_FUNCTION,     // An identifier followed by (
+    TOKEN_IDENTIFIER,   // Any other identifier, emitted only if requested
+
+    TOKEN_TYPES_COUNT
+};
+
+struct cppToken
+{
+    int start;
+    int length;
+    int type;
+};
+
+class CppLexer
+{
+public:
+    // Line states, every raw string state is STATE_RAW_STRING plus a hash of its delimiter
+    enum lexerState
+    {
+        STATE_NORMAL = 0,
+        STATE_MULTILINE_COMMENT = 1,
+        STATE_RAW_STRING = 0x100,
+        STATE_MAX = 0x1000100 // Every state is below this value
+    };
+
+    // Lexes a line and appends its tokens, returns the state at the end of the line. A negative
+    // previous state (no previous line) is considered STATE_NORMAL
+    static int lexLine(const QChar *text, int length, int previousState, QVector<cppToken> &tokens,
+                       bool emitIdentifiers = false);
+    static int lexLine(const QString &line, int previousState, QVector<cppToken> &tokens,
+                       bool emitIdentifiers = false)
+    {
+        return lexLine(line.constData(), line.length(), previousState, tokens, emitIdentifiers);
+    }
+
+    // Keyword lookup through a perfect hash, no collisions are possible between keywords
+    static bool isKeyword(const QChar *text, int length);
+};
+
+#endif // CPPLEXER_H
@@ -0,0 +1,155 @@
+#include "diagramrenderer.h"
+#include "gdsdbreader.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QLinearGradient>
+#include <QFontMetrics>
+#include <QHash>
+
+DiagramRenderer::DiagramRenderer()
+{
+    m_labelsVisible = true;
+    m_selectionVisible = true;
+    // The diagram widget's clear color
+    m_backgroundColor = QColor::fromRgbF(0.2, 0.0, 0.6);
+}
+
+void DiagramRenderer::buildScene(const QVector<dbDataStructure*> &elements, SceneModel &scene)
+{
+    scene.clear();
+    QHash<const dbDataStructure*, int> nodes;
+    for(int i=0; i<elements.size(); i++)
+    {
+        int father = elements[i]->father ? nodes.value(elements[i]->father, -1) : -1;
+        nodes.insert(elements[i], scene.addNode(elements[i]->label, father));
+    }
+    scene.layout();
+}
+
+QTransform DiagramRenderer::layoutTransform(const SceneModel &scene, const QSize &size)
+{
+    if(scene.isEmpty() || scene.m_x.size() != scene.size())
+        return QTransform();
+
+    // Layout Y grows upwards (negative depths), the image Y grows downwards
+    // Blocks hidden by a collapsed node don't count (the root is never hidden)
+    long minX = scene.m_x[0], maxX = minX, minY = -scene.m_y[0], maxY = minY;
+    for(int node=1; node<scene.size(); node++)
+    {
+        if(scene.isHidden(node))
+            continue;
+        minX = qMin(minX, scene.m_x[node]);
+        maxX = qMax(maxX, scene.m_x[node]);
+        minY = qMin(minY, -scene.m_y[node]);
+        maxY = qMax(maxY, -scene.m_y[node]);
+    }
+
+    // Fit the graph plus half a block of margin on every side
+    qreal width = (maxX - minX) + BLOCK_WIDTH * 2;
+    qreal height = (maxY - minY) + BLOCK_HEIGHT * 2;
+    qreal scale = qMin((qreal)MAX_SCALE, qMin(size.width() / width, size.height() / height));
+    QTransform transform;
+    transform.translate(size.width() / 2.0, size.height() / 2.0);
+    transform.scale(scale, scale);
+    transform.translate(-(minX + maxX) / 2.0, -(minY + maxY) / 2.0);
+    return transform;
+}
+
+QImage DiagramRenderer::render(const SceneModel &scene, const QSize &size) const
+{
+    if(size.width() <= 0 || size.height() <= 0)
+        return QImage();
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(m_backgroundColor.rgba());
+    if(scene.isEmpty() || scene.m_x.size() != scene.size())
+        return image;
+
+    QTransform transform = layoutTransform(scene, size);
+    qreal scale = transform.m11();
+    QVector<QPointF> points(scene.size());
+    for(int node=0; node<scene.size(); node++)
+        points[node] = transform.map(QPointF(scene.m_x[node], -scene.m_y[node]));
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // Connection lines first, blocks are drawn over them (red as the widget draws them)
+    QVector<QLineF> lines;
+    lines.reserve(scene.size());
+    for(int node=0; node<scene.size(); node++)
+    {
+        if(scene.m_parent[node] != -1 && !scene.isHidden(node))
+            lines.append(QLineF(points[scene.m_parent[node]], points[node]));
+    }
+    painter.setPen(QPen(QColor(255, 0, 0), qMax((qreal)1.0, scale / 10)));
+    painter.drawLines(lines);
+
+    qreal blockWidth = BLOCK_WIDTH * scale, blockHeight = BLOCK_HEIGHT * scale;
+    QPainterPath block;
+    block.addRoundedRect(QRectF(-blockWidth / 2, -blockHeight / 2, blockWidth, blockHeight), blockHeight / 4,
+                         blockHeight / 4);
+
+    // The block textures are vertical gradients, the same colors the site viewer uses
+    QLinearGradient normal(0, -blockHeight / 2, 0, blockHeight / 2);
+    normal.setColorAt(0, QColor(0xfa, 0xf8, 0xff));
+    normal.setColorAt(1, QColor(0xc8, 0xc0, 0xe4));
+    QLinearGradient selected(normal);
+    selected.setColorAt(0, QColor(0xff, 0xf0, 0xc0));
+    selected.setColorAt(1, QColor(0xff, 0xc8, 0x30));
+
+    bool labels = m_labelsVisible && blockHeight >= MIN_LABEL_HEIGHT;
+    if(labels)
+    {
+        QFont font = painter.font();
+        font.setPixelSize(qMax(8, qRound(blockHeight / 3)));
+        painter.setFont(font);
+    }
+    QRectF imageRect(0, 0, size.width(), size.height());
+    for(int node=0; node<scene.size(); node++)
+    {
+        if(scene.isHidden(node))
+            continue;
+
+        // Whole large graphs in a small image: blocks would vanish, they're kept as dots
+        if(blockHeight < MIN_BLOCK_HEIGHT)
+        {
+            bool highlighted = m_selectionVisible && (scene.m_flags[node] & SceneModel::NODE_SELECTED);
+            painter.fillRect(QRectF(points[node].x() - 1, points[node].y() - 1, 2, 2),
+                             highlighted ? QColor(0xff, 0xc8, 0x30) : QColor(0xc8, 0xc0, 0xe4));
+            continue;
+        }
+
+        QRectF bounds(points[node].x() - blockWidth / 2, points[node].y() - blockHeight / 2, blockWidth, blockHeight);
+        if(!imageRect.intersects(bounds))
+            continue;
+
+        painter.save();
+        painter.translate(points[node]);
+        painter.setPen(Qt::NoPen);
+        bool highlighted = m_selectionVisible && (scene.m_flags[node] & SceneModel::NODE_SELECTED);
+        painter.setBrush(highlighted ? selected : normal);
+        if(scene.isCollapsed(node))
+        {
+            // A summary block: another block peeks out behind it
+            painter.save();
+            painter.translate(blockHeight / 6, blockHeight / 6);
+            painter.setOpacity(0.6);
+            painter.drawPath(block);
+            painter.restore();
+        }
+        painter.drawPath(block);
+        if(labels)
+        {
+            QRectF textRect(-blockWidth / 2 + 2, -blockHeight / 2, blockWidth - 4, blockHeight);
+            QString label = painter.fontMetrics().elidedText(scene.m_labels[node], Qt::ElideRight,
+                                                             (int)textRect.width());
+            painter.setPen(QColor(0x1a, 0x10, 0x30));
+            painter.drawText(textRect, Qt::AlignCenter, label);
+        }
+        painter.restore();
+    }
+
+    painter.end();
+    return image;
+}
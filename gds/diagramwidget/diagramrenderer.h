@@ -0,0 +1,55 @@
+#ifndef DIAGRAMRENDERER_H
+#define DIAGRAMRENDERER_H
+
+// Software rendering of a laid out scene into an image: the same blocks and connection lines the diagram widget
+// draws, fitted into the image. It paints with QPainter on a QImage (the raster engine), no OpenGL context and no
+// display are needed, so it works in gds-cli on a headless box and from worker threads. Used for the level
+// thumbnails (gds-cli render/thumbnails) and for the previews of the static site export.
+// With labels off the output only depends on the scene and the size, those images can be kept as golden images
+
+#include <QImage>
+#include <QSize>
+#include <QColor>
+#include <QTransform>
+#include <QVector>
+#include "scenemodel.h"
+
+class dbDataStructure;
+
+class DiagramRenderer
+{
+public:
+    DiagramRenderer();
+
+    // Labels are drawn on blocks big enough to read them. Text needs fonts: leave them off when rendering from
+    // worker threads or when the images are compared pixel by pixel
+    void setLabelsVisible(bool visible) { m_labelsVisible = visible; }
+    void setBackgroundColor(const QColor &color) { m_backgroundColor = color; }
+    // Images cached across selection changes (the diagram widget's minimap) draw every block alike
+    void setSelectionVisible(bool visible) { m_selectionVisible = visible; }
+
+    // The whole scene (already laid out) centered in an image of the given size, blocks are never drawn bigger
+    // than MAX_SCALE pixels per layout unit. Returns a null image for an invalid size
+    QImage render(const SceneModel &scene, const QSize &size) const;
+    // Maps layout coordinates (m_x, -m_y: Y grows with the depth) to the pixels of an image rendered at that size
+    static QTransform layoutTransform(const SceneModel &scene, const QSize &size);
+
+    // Inserts the elements of a level (parents first, as levels are stored) and lays them out as the windows do
+    static void buildScene(const QVector<dbDataStructure*> &elements, SceneModel &scene);
+
+    // Block size in layout units, the layout keeps blocks MINSPACE_BLOCKS_X/Y apart
+    static const int BLOCK_WIDTH = 8;
+    static const int BLOCK_HEIGHT = 3;
+    static const int MAX_SCALE = 40;
+    // Blocks smaller than this (pixels) don't get a label
+    static const int MIN_LABEL_HEIGHT = 12;
+    // Blocks smaller than this (pixels) are drawn as dots
+    static const int MIN_BLOCK_HEIGHT = 2;
+
+private:
+    bool m_labelsVisible;
+    bool m_selectionVisible;
+    QColor m_backgroundColor;
+};
+
+#endif // DIAGRAMRENDERER_H
@@ -1,158 +1,173 @@
-#ifndef QGLDIAGRAMWIDGET_H
-#define QGLDIAGRAMWIDGET_H
-
-#include "gl/glew.h" // Include this before other QtGL files
-#include <QGLWidget>
-#include <QGLShader>
-#include <QResizeEvent>
-#include <QVector>
-#include <QtAlgorithms>
-#include <QTimer>
-#include <QMainWindow>
-
-// Forward declaration
-class MainWindowEditMode;
-class MainWindowViewMode;
-
-// Forward declaration
-class dataToDraw;
-
-// The data to be drawn
-class dataToDraw
-{
-private:
-    static unsigned char gColorID[3]; // A static variable to keep track of the next color available for all objects
-
-public:
-    QString m_label;        // The data label
-    long m_depth;   // The depth this node lies at
-
-    // Positioning data (calculated once at the beginning of this diagram)
-    long m_Xdisp;
-    long m_Ydisp;
-    // Color picking data, a unique color assigned to this object
-    unsigned char m_colorID[3];
-
-    // All the next items linked to this one
-    QVector<dataToDraw*> m_nextItems;
-
-    // Constructor to initialize the unique color
-    dataToDraw();
-};
-
-// Every depth level of the tree has an array of elements to let the parent
-// of these nodes calculate its own displacement with respect of their children's
-struct dataSeries
-{
-    QVector<long> m_allElementsForThisLevel;
-};
-
-// Based on how our rounded blocks are drawn, we have a minimum (object coords) on the
-// model matrix to avoid blocks overlap
-#define MINSPACE_BLOCKS_X 10
-#define MINSPACE_BLOCKS_Y 5
-
-
-class QGLDiagramWidget : public QGLWidget
-{
-    Q_OBJECT
-
-    friend class dataToDraw; // Let dataToDraw access "m_backgroundColor" to choose a unique color for each element
-
-public:
-    explicit QGLDiagramWidget(QMainWindow *referringWindow, QWidget *parent = 0);
-    ~QGLDiagramWidget();
-
-    void *insertTreeData(QString label, void *father);
-    void calculateDisplacement();
-    void changeSelectedElement(void *newElement);
-    void clearGraphData();
-
-    // Other classes' support variables
-    bool m_gdsEditMode; // If this is true, we don't need to animate the selection of an element
-    bool m_swapInProgress; // If this is true, a swap is in progress and we can't repaint until it has finished
-    bool m_readyToDraw; // Compiling shaders takes time, if this is true the associated window can send us data to draw
-    bool m_associatedWindowRepaintScheduled; // As soon as we are ready to draw, call the associated window's handler
-    bool firstTimeDrawing; // If this is set, a root element is selected and base view matrix operations (adjustView) are made
-signals:
-    
-private slots:
-    void slotTransitionSelected();
-
-protected:
-    // Overrides
-    void closeEvent(QCloseEvent *evt);
-    void paintEvent(QPaintEvent *event);
-    void initializeGL();
-    void paintGL();
-
-    void mousePressEvent(QMouseEvent * e);
-    void wheelEvent(QWheelEvent * e);
-    void keyPressEvent(QKeyEvent *e);
-    bool eventFilter( QObject *o, QEvent *e );
-
-private:
-    QMainWindow *m_referringWindow; // The main window we're being created on
-
-    dataToDraw *m_diagramData; // The main data pointer, this points to the tree's root
-    QVector<dataToDraw*> m_diagramDataVector; // A list sometimes can be slow and uneasy to access, this is equivalent to the above
-
-    static float m_backgroundColor[3]; // This ensures that we won't be interfering with the background in color picking
-
-    QGLShaderProgram *ShaderProgramNormal, *ShaderProgramSelected, *ShaderProgramPicking;
-    QGLShader *VertexShader, *FragmentShader;
-    void loadShadersFromResources(QString vShader, QString fShader, QGLShaderProgram **progShader);
-    void initBlockBuffers();
-    void freeBlockBuffers();
-    void initBlockTextures();
-    void freeBlockTextures();
-    void postOrderTraversal(dataToDraw *tree);
-    long findMaximumTreeDepth(dataToDraw *tree);
-    void postOrderDrawBlocks(dataToDraw *tree, QMatrix4x4 gl_view, QMatrix4x4 gl_model, GLuint uMVMatrix,
-                                               GLuint TextureID);
-    // A depthMax values vector, each one contains all the children of a given node and their X displacement,
-    // it's used to calculate their parent's middle position among them
-    QVector<dataSeries> m_depthIntervals;
-    long m_maximumXreached;
-    bool dataDisplacementComplete; // Used to indicate whether the data is ready to be painted
-    void deallocateAllMemory();
-
-    void adjustView();
-    // Mouse zooming factor (wheel)
-    float zoomFactor;
-    bool needForZoomRepaint;
-
-    // This is updated by keyboard arrows and specify a new view direction to be drawn
-    bool needForDirectionRepaint;
-    QVector3D moveNewDirection;
-
-    bool m_pickingRunning;
-    QVector2D m_mouseClickPoint;
-    // A selected element will have a different texture (not normal gradient)
-    dataToDraw *m_selectedItem;
-    bool m_goToSelectedRunning;
-
-    //-> Block GL data
-        // This will identify our vertex/normal/UVcoords buffer
-        GLuint blockVertexBuffer;
-        // This will identify our indices buffer
-        GLuint blockIndicesBuffer;
-        // Create OpenGL textures
-        GLuint blockTextureID_normal;
-        GLuint blockTextureID_selected;
-    //<-
-
-    void drawConnectionLinesBetweenBlocks();
-    QTimer *m_selectionTransitionTimer;
-    QMatrix4x4 m_destinationViewMatrix;
-    qreal xAmount, yAmount, zAmount;
-
-    QMatrix4x4 gl_projection;
-    QMatrix4x4 gl_view;
-    QMatrix4x4 gl_previousUserView;
-    QMatrix4x4 gl_model;
-    QMatrix4x4 gl_MVP;
-    QMatrix4x4 gl_modelView;
-};
-
-#endif // QGLDIAGRAMWIDGET_H
+#ifndef QGLDIAGRAMWIDGET_H
+#define QGLDIAGRAMWIDGET_H
+
+#include "gl/glew.h" // Include this before other QtGL files
+#include <QGLWidget>
+#include <QGLShader>
+#include <QResizeEvent>
+#include <QVector>
+#include <QtAlgorithms>
+#include <QTimer>
+#include <QMainWindow>
+#include <QImage>
+#include <QTransform>
+#include <QMutex>
+#include <QThreadPool>
+#include "scenemodel.h"
+
+// Forward declaration
+class MainWindowEditMode;
+class MainWindowViewMode;
+class QPainter;
+
+// GPU timer queries in flight, results are read a few frames later so that we never wait for the GPU
+#define GPU_TIMER_QUERIES 4
+
+// Minimap (top-right corner, pixels), shown on graphs with at least MINIMAP_MIN_NODES blocks
+#define MINIMAP_WIDTH 200
+#define MINIMAP_HEIGHT 130
+#define MINIMAP_MARGIN 10
+#define MINIMAP_MIN_NODES 30
+
+// Graphs with at least this many nodes are laid out by a worker thread, the last laid out graph is drawn meanwhile
+#define BACKGROUND_LAYOUT_MIN_NODES PARALLEL_LAYOUT_MIN_NODES
+
+
+class QGLDiagramWidget : public QGLWidget
+{
+    Q_OBJECT
+
+public:
+    explicit QGLDiagramWidget(QMainWindow *referringWindow, QWidget *parent = 0);
+    ~QGLDiagramWidget();
+
+    // Nodes are identified by the integer IDs returned here (-1 is the root's father or an invalid node)
+    int insertTreeData(QString label, int father);
+    void calculateDisplacement();
+    void changeSelectedElement(int newElement);
+    void clearGraphData();
+    void saveRenderData(diagramRenderData &renderData);
+    bool restoreRenderData(const diagramRenderData &renderData);
+    // Collapsed nodes are drawn as summary blocks and their subtrees are skipped by layout, drawing and picking.
+    // Setting the state doesn't emit nodeCollapseChanged(), the keyboard (+/-) and revealing a node do. Returns
+    // false if nothing changed
+    bool setNodeCollapsed(int node, bool collapsed);
+    bool isNodeCollapsed(int node) const;
+
+    // Other classes' support variables
+    bool m_gdsEditMode; // If this is true, we don't need to animate the selection of an element
+    bool m_swapInProgress; // If this is true, a swap is in progress and we can't repaint until it has finished
+    bool m_readyToDraw; // Compiling shaders takes time, if this is true the associated window can send us data to draw
+    bool m_associatedWindowRepaintScheduled; // As soon as we are ready to draw, call the associated window's handler
+    bool firstTimeDrawing; // If this is set, a root element is selected and base view matrix operations (adjustView) are made
+signals:
+    // The user collapsed or expanded a node, the window keeps the state
+    void nodeCollapseChanged(int node, bool collapsed);
+
+private slots:
+    void slotTransitionSelected();
+    void layoutFinished();
+
+protected:
+    // Overrides
+    void closeEvent(QCloseEvent *evt);
+    void paintEvent(QPaintEvent *event);
+    void initializeGL();
+    void paintGL();
+
+    void mousePressEvent(QMouseEvent * e);
+    void wheelEvent(QWheelEvent * e);
+    void keyPressEvent(QKeyEvent *e);
+    bool eventFilter( QObject *o, QEvent *e );
+
+private:
+    QMainWindow *m_referringWindow; // The main window we're being created on
+
+    SceneModel m_scene; // The tree to draw (structure of arrays), it also holds the selected node
+
+    static float m_backgroundColor[3]; // This ensures that we won't be interfering with the background in color picking
+
+    QGLShaderProgram *ShaderProgramNormal, *ShaderProgramSelected, *ShaderProgramPicking;
+    QGLShader *VertexShader, *FragmentShader;
+    void loadShadersFromResources(QString vShader, QString fShader, QGLShaderProgram **progShader);
+    void initBlockBuffers();
+    void freeBlockBuffers();
+    void initBlockTextures();
+    void freeBlockTextures();
+    void drawBlocks(const QMatrix4x4 &gl_view, const QMatrix4x4 &gl_model, GLuint uMVMatrix);
+    bool dataDisplacementComplete; // Used to indicate whether the data is ready to be painted
+    void deallocateAllMemory();
+
+    // Background layout of large graphs (see calculateDisplacement()). While it runs m_scene is the previous graph,
+    // it's drawn but can't be picked or collapsed, and selections are applied when the new one is swapped in
+    friend class sceneLayoutTask;
+    QThreadPool m_layoutPool;
+    QMutex m_layoutMutex;
+    SceneModel m_laidOutScene;      // Written by the worker, taken by layoutFinished()
+    int m_laidOutGeneration;
+    int m_layoutGeneration;         // Bumped when the graph is cleared, results of older layouts are dropped
+    bool m_layoutRunning;
+    SceneModel m_previousScene;     // The last laid out graph, drawn while the next one is laid out
+    int m_pendingSelection;
+
+    void adjustView();
+    // Mouse zooming factor (wheel)
+    float zoomFactor;
+    bool needForZoomRepaint;
+
+    // This is updated by keyboard arrows and specify a new view direction to be drawn
+    bool needForDirectionRepaint;
+    QVector3D moveNewDirection;
+
+    bool m_pickingRunning;
+    QVector2D m_mouseClickPoint;
+    bool m_goToSelectedRunning;
+
+    //-> Block GL data
+        // This will identify our vertex/normal/UVcoords buffer
+        GLuint blockVertexBuffer;
+        // This will identify our indices buffer
+        GLuint blockIndicesBuffer;
+        // Create OpenGL textures
+        GLuint blockTextureID_normal;
+        GLuint blockTextureID_selected;
+    //<-
+
+    void drawConnectionLinesBetweenBlocks();
+    void revealNode(int node);
+
+    // Profiler overlay (F12) and GPU frame times
+    bool m_profilerOverlay;
+    bool m_profilerEnabledByOverlay; // The profiler is stopped again when the overlay is hidden
+    bool m_gpuTimerAvailable;
+    GLuint m_gpuTimerQueries[GPU_TIMER_QUERIES];
+    bool m_gpuTimerPending[GPU_TIMER_QUERIES];
+    int m_gpuTimerNext;
+    void collectGpuTimes();
+    void drawProfilerOverlay(QPainter &painter);
+
+    // Minimap (F10): the whole layout is rendered into an image once per tree (DiagramRenderer), the visible area
+    // is drawn over it on every frame. A click on it moves the view there
+    bool m_minimapVisible;
+    bool m_minimapDirty; // The tree has changed, the image has to be rendered again
+    QImage m_minimap;
+    QTransform m_minimapTransform; // Layout coordinates to minimap pixels
+    bool minimapShown() const;
+    QRect minimapRect() const;
+    void drawMinimap(QPainter &painter);
+    void jumpToMinimapPoint(const QPoint &point);
+    bool screenToLayout(const QPointF &screen, QPointF *layout) const;
+
+    QTimer *m_selectionTransitionTimer;
+    QMatrix4x4 m_destinationViewMatrix;
+    qreal xAmount, yAmount, zAmount;
+
+    QMatrix4x4 gl_projection;
+    QMatrix4x4 gl_view;
+    QMatrix4x4 gl_previousUserView;
+    QMatrix4x4 gl_model;
+    QMatrix4x4 gl_MVP;
+    QMatrix4x4 gl_modelView;
+};
+
+#endif // QGLDIAGRAMWIDGET_H
@@ -0,0 +1,460 @@
+#include "scenemodel.h"
+#include <QRunnable>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QThread>
+#include <QtAlgorithms>
+#include <QPair>
+
+// Subtrees handed to the pool: a few per thread so that a thread done early picks up more work
+#define PARALLEL_LAYOUT_TASKS_PER_THREAD 8
+// Fewer nodes than this aren't worth a task, small sibling subtrees are laid out together until they reach it
+#define PARALLEL_LAYOUT_MIN_TASK_NODES 256
+
+// Lays out a range of sibling subtrees as if nothing was on its left (see SceneModel::layoutParallel())
+class subtreeLayoutTask : public QRunnable
+{
+public:
+    SceneModel *m_scene;
+    int m_first;
+    int m_last;
+    long *m_reached;
+    QSemaphore *m_done;
+
+    void run()
+    {
+        *m_reached = m_scene->layoutRange(m_first, m_last, 0);
+        m_done->release();
+    }
+};
+
+// Moves an already laid out range of sibling subtrees right, once the space on its left is known. The subtrees'
+// roots have already been moved
+class subtreeShiftTask : public QRunnable
+{
+public:
+    SceneModel *m_scene;
+    int m_first;
+    int m_last;
+    long m_offset;
+    QSemaphore *m_done;
+
+    void run()
+    {
+        long *x = m_scene->m_x.data();
+        long *maxXBefore = m_scene->m_maxXBefore.data();
+        const int *postOrder = m_scene->m_postOrder.constData();
+        const int *postIndex = m_scene->m_postIndex.constData();
+        const int *parents = m_scene->m_parent.constData();
+        const unsigned char *flags = m_scene->m_flags.constData();
+        for(int i=m_first; i<=m_last; i++)
+        {
+            maxXBefore[i] += m_offset;
+            int node = postOrder[i];
+            // A root's parent comes after the range in post-order
+            bool root = (parents[node] == -1 || postIndex[parents[node]] > m_last);
+            if(!root && !(flags[node] & SceneModel::NODE_HIDDEN))
+                x[node] += m_offset;
+        }
+        m_done->release();
+    }
+};
+
+SceneModel::SceneModel()
+{
+    m_selected = -1;
+}
+
+void SceneModel::clear()
+{
+    m_parent.clear();
+    m_firstChild.clear();
+    m_childCount.clear();
+    m_depth.clear();
+    m_x.clear();
+    m_y.clear();
+    m_flags.clear();
+    m_labels.clear();
+    m_children.clear();
+    m_postOrder.clear();
+    m_postIndex.clear();
+    m_subtreeSize.clear();
+    m_maxXBefore.clear();
+    m_selected = -1;
+}
+
+int SceneModel::addNode(const QString &label, int parent)
+{
+    if(parent == -1 && !m_parent.isEmpty())
+        return -1; // Root element already set
+    if(parent != -1 && (parent < 0 || parent >= m_parent.size()))
+        return -1; // The father must exist already
+
+    int id = m_parent.size();
+    m_parent.append(parent);
+    m_depth.append(parent == -1 ? 0 : m_depth[parent] + 1);
+    m_x.append(0);
+    m_y.append(0);
+    // Added under a collapsed node, it starts hidden
+    m_flags.append((parent != -1 && (m_flags[parent] & (NODE_COLLAPSED | NODE_HIDDEN))) ? NODE_HIDDEN : 0);
+    m_labels.append(label);
+
+    // Children lists have to be built again
+    m_firstChild.clear();
+
+    return id;
+}
+
+// Groups children IDs by parent (a counting sort on the parents' IDs), children keep their insertion order
+void SceneModel::buildChildrenLists()
+{
+    int count = m_parent.size();
+    m_childCount.fill(0, count);
+    for(int i=0; i<count; i++)
+    {
+        if(m_parent[i] != -1)
+            m_childCount[m_parent[i]]++;
+    }
+
+    m_firstChild.resize(count);
+    int offset = 0;
+    for(int i=0; i<count; i++)
+    {
+        m_firstChild[i] = offset;
+        offset += m_childCount[i];
+    }
+
+    m_children.resize(offset);
+    QVector<int> filled(count, 0);
+    for(int i=0; i<count; i++)
+    {
+        int parent = m_parent[i];
+        if(parent != -1)
+            m_children[m_firstChild[parent] + filled[parent]++] = i;
+    }
+
+    // Post-order without recursion: an explicit stack and, for every node, the next child to go down to
+    m_postOrder.clear();
+    m_postOrder.reserve(count);
+    if(count == 0)
+        return;
+    QVector<int> stack;
+    QVector<int> nextChild(count, 0);
+    stack.append(0);
+    while(!stack.isEmpty())
+    {
+        int node = stack.last();
+        if(nextChild[node] < m_childCount[node])
+        {
+            // Go down to the next child
+            stack.append(m_children[m_firstChild[node] + nextChild[node]]);
+            nextChild[node]++;
+        }
+        else
+        {
+            // Every child has been visited
+            m_postOrder.append(node);
+            stack.pop_back();
+        }
+    }
+    buildSubtreeSizes();
+}
+
+// Subtree sizes and post-order positions: a subtree is a contiguous range of the post-order ending at its root
+void SceneModel::buildSubtreeSizes()
+{
+    int count = m_parent.size();
+    m_postIndex.resize(count);
+    m_subtreeSize.fill(1, count);
+    for(int i=0; i<m_postOrder.size(); i++)
+    {
+        int node = m_postOrder[i];
+        m_postIndex[node] = i;
+        if(m_parent[node] != -1)
+            m_subtreeSize[m_parent[node]] += m_subtreeSize[node];
+    }
+}
+
+void SceneModel::layout(int maxThreads)
+{
+    buildChildrenLists();
+    int threads = (maxThreads > 0) ? maxThreads : QThread::idealThreadCount();
+    if(threads > 1 && m_parent.size() >= PARALLEL_LAYOUT_MIN_NODES)
+        layoutParallel(threads);
+    else
+        layoutFrom(0);
+}
+
+void SceneModel::relayout(int id)
+{
+    if(!hasChildrenLists() || m_maxXBefore.size() != m_parent.size())
+    {
+        // Never laid out here (or the layout was restored from a saved one): everything has to be calculated
+        layout();
+        return;
+    }
+    layoutFrom(m_postIndex[id] - m_subtreeSize[id] + 1);
+}
+
+// The layout pass from a post-order position onwards, everything before it keeps its displacements
+void SceneModel::layoutFrom(int first)
+{
+    m_maxXBefore.resize(m_postOrder.size());
+    layoutRange(first, m_postOrder.size() - 1, (first > 0) ? m_maxXBefore[first] : 0);
+}
+
+// The layout pass over a range of the post-order, starting with the rightmost X reached before it. Returns the
+// rightmost X reached at its end. Ranges covering disjoint subtrees can be laid out by different threads
+long SceneModel::layoutRange(int first, int last, long maximumXreached)
+{
+    // Raw arrays: the ranges of different threads never touch the same node
+    long *xs = m_x.data();
+    long *ys = m_y.data();
+    long *maxXBefore = m_maxXBefore.data();
+    const int *postOrder = m_postOrder.constData();
+    const unsigned char *flags = m_flags.constData();
+    const int *depths = m_depth.constData();
+    const int *childCounts = m_childCount.constData();
+    const int *firstChildren = m_firstChild.constData();
+    const int *allChildren = m_children.constData();
+    for(int i=first; i<=last; i++)
+    {
+        maxXBefore[i] = maximumXreached;
+        int node = postOrder[i];
+        // Hidden nodes take no room, their displacements are left as they were
+        if(flags[node] & NODE_HIDDEN)
+            continue;
+
+        // Y are easy: take this node's depth and put it on its Y coord * Y_space_between_blocks
+        ys[node] = - (depths[node] * MINSPACE_BLOCKS_Y);
+
+        // A collapsed node is laid out as a leaf
+        int childCount = (flags[node] & NODE_COLLAPSED) ? 0 : childCounts[node];
+        if(childCount == 0)
+        {
+            // A leaf, it needs to be put at least min_space_between_blocks_X away from everything on its left
+            xs[node] = maximumXreached + MINSPACE_BLOCKS_X;
+        }
+        else if(childCount == 1)
+        {
+            // Just one child, no need for a middle calculation, let's just take the child's X coord
+            xs[node] = xs[allChildren[firstChildren[node]]];
+        }
+        else
+        {
+            // Put the parent in the exact middle of its children
+            const int *children = allChildren + firstChildren[node];
+            long min = xs[children[0]], max = min;
+            for(int j=1; j<childCount; j++)
+            {
+                long x = xs[children[j]];
+                if(x < min)
+                    min = x;
+                if(x > max)
+                    max = x;
+            }
+            xs[node] = (max+min)/2;
+        }
+
+        if(xs[node] > maximumXreached)
+            maximumXreached = xs[node];
+    }
+    return maximumXreached;
+}
+
+// Leaves only depend on the rightmost X reached before them, so a subtree laid out as if nothing was on its left
+// is the right layout moved by that X (parents are in the middle of their children, still all positive). The
+// graph is split into ranges of sibling subtrees of about the same size, laid out in parallel, then the nodes
+// above them are laid out on this thread (their children are either above too or subtree roots) and every range
+// is moved right in parallel. The result is the same as the sequential pass
+void SceneModel::layoutParallel(int threads)
+{
+    int count = m_postOrder.size();
+    m_maxXBefore.resize(count);
+    // Detach the arrays now, the tasks write into them
+    m_x.data();
+    m_y.data();
+    m_maxXBefore.data();
+
+    // Subtrees bigger than the grain are split into their children, their root stays on this thread. Consecutive
+    // small children are grouped until they reach the grain: siblings are contiguous in post-order, so a group is
+    // a range too. Hidden nodes are never reached: their collapsed ancestor is small enough or it's a subtree root
+    int grain = qMax(PARALLEL_LAYOUT_MIN_TASK_NODES, count / (threads * PARALLEL_LAYOUT_TASKS_PER_THREAD));
+    QVector< QPair<int, int> > ranges; // First and last post-order position
+    QVector<int> stack;
+    if(m_subtreeSize[0] <= grain || (m_flags[0] & NODE_COLLAPSED) || m_childCount[0] == 0)
+        ranges.append(qMakePair(0, count - 1));
+    else
+        stack.append(0);
+    while(!stack.isEmpty())
+    {
+        int node = stack.last();
+        stack.pop_back();
+        const int *children = m_children.constData() + m_firstChild[node];
+        int groupFirst = -1, groupLast = -1, groupSize = 0;
+        for(int j=0; j<m_childCount[node]; j++)
+        {
+            int child = children[j];
+            if(m_subtreeSize[child] > grain && !(m_flags[child] & NODE_COLLAPSED) && m_childCount[child] > 0)
+            {
+                // Split it too, it interrupts the group
+                if(groupSize > 0)
+                    ranges.append(qMakePair(groupFirst, groupLast));
+                groupSize = 0;
+                stack.append(child);
+                continue;
+            }
+            if(groupSize == 0)
+                groupFirst = m_postIndex[child] - m_subtreeSize[child] + 1;
+            groupLast = m_postIndex[child];
+            groupSize += m_subtreeSize[child];
+            if(groupSize >= grain)
+            {
+                ranges.append(qMakePair(groupFirst, groupLast));
+                groupSize = 0;
+            }
+        }
+        if(groupSize > 0)
+            ranges.append(qMakePair(groupFirst, groupLast));
+    }
+    qSort(ranges);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore done;
+    QVector<long> reached(ranges.size());
+    for(int k=0; k<ranges.size(); k++)
+    {
+        subtreeLayoutTask *task = new subtreeLayoutTask();
+        task->m_scene = this;
+        task->m_first = ranges[k].first;
+        task->m_last = ranges[k].second;
+        task->m_reached = &reached[k];
+        task->m_done = &done;
+        pool->start(task);
+    }
+    done.acquire(ranges.size());
+
+    // The nodes above the ranges in post-order, a range is skipped by moving its subtrees' roots only and
+    // remembering where it starts (their parents read nothing else from it)
+    QVector<long> offsets(ranges.size());
+    long maximumXreached = 0;
+    int next = 0;
+    for(int i=0; i<count; )
+    {
+        if(next < ranges.size() && i == ranges[next].first)
+        {
+            offsets[next] = maximumXreached;
+            // Roots from the last one backwards, every subtree ends at its root
+            for(int root = ranges[next].second; root >= ranges[next].first; root -= m_subtreeSize[m_postOrder[root]])
+                m_x[m_postOrder[root]] += maximumXreached;
+            maximumXreached += reached[next];
+            i = ranges[next].second + 1;
+            next++;
+        }
+        else
+        {
+            maximumXreached = layoutRange(i, i, maximumXreached);
+            i++;
+        }
+    }
+
+    // Every range but its roots is moved right
+    for(int k=0; k<ranges.size(); k++)
+    {
+        subtreeShiftTask *task = new subtreeShiftTask();
+        task->m_scene = this;
+        task->m_first = ranges[k].first;
+        task->m_last = ranges[k].second;
+        task->m_offset = offsets[k];
+        task->m_done = &done;
+        pool->start(task);
+    }
+    done.acquire(ranges.size());
+}
+
+// The ID plus one (zero is never used) is the 24-bit color, colors from the background onwards are shifted by one
+void SceneModel::colorForNode(int id, const float backgroundColor[3], unsigned char rgb[3])
+{
+    quint32 background = ((quint32)(unsigned char)(backgroundColor[0]*255.0f) << 16) |
+                         ((quint32)(unsigned char)(backgroundColor[1]*255.0f) << 8) |
+                          (quint32)(unsigned char)(backgroundColor[2]*255.0f);
+    quint32 color = (quint32)id + 1;
+    if(color >= background)
+        color++;
+    rgb[0] = (color >> 16) & 0xFF;
+    rgb[1] = (color >> 8) & 0xFF;
+    rgb[2] = color & 0xFF;
+}
+
+// Returns -1 for the background or for colors that don't belong to any node
+int SceneModel::nodeFromColor(const unsigned char rgb[3], const float backgroundColor[3]) const
+{
+    quint32 background = ((quint32)(unsigned char)(backgroundColor[0]*255.0f) << 16) |
+                         ((quint32)(unsigned char)(backgroundColor[1]*255.0f) << 8) |
+                          (quint32)(unsigned char)(backgroundColor[2]*255.0f);
+    quint32 color = ((quint32)rgb[0] << 16) | ((quint32)rgb[1] << 8) | (quint32)rgb[2];
+    if(color == background || color == 0)
+        return -1;
+    if(color > background)
+        color--;
+    int id = (int)color - 1;
+    if(id >= m_parent.size())
+        return -1;
+    return id;
+}
+
+qint64 SceneModel::byteSize() const
+{
+    qint64 size = 0;
+    size += (m_parent.capacity() + m_firstChild.capacity() + m_childCount.capacity() + m_depth.capacity()) * sizeof(int);
+    size += (m_children.capacity() + m_postOrder.capacity() + m_postIndex.capacity() + m_subtreeSize.capacity()) * sizeof(int);
+    size += (m_x.capacity() + m_y.capacity() + m_maxXBefore.capacity()) * sizeof(long);
+    size += m_flags.capacity();
+    for(int i=0; i<m_labels.size(); i++)
+        size += sizeof(QString) + m_labels[i].size() * sizeof(QChar);
+    return size;
+}
+
+void SceneModel::setSelected(int id)
+{
+    if(m_selected != -1 && m_selected < m_flags.size())
+        m_flags[m_selected] &= ~NODE_SELECTED;
+    m_selected = id;
+    if(m_selected != -1)
+        m_flags[m_selected] |= NODE_SELECTED;
+}
+
+bool SceneModel::setCollapsed(int id, bool collapsed)
+{
+    if(id < 0 || id >= m_parent.size())
+        return false;
+    if(!hasChildrenLists())
+        buildChildrenLists();
+    if(m_childCount[id] == 0 || isCollapsed(id) == collapsed)
+        return false;
+
+    if(collapsed)
+        m_flags[id] |= NODE_COLLAPSED;
+    else
+        m_flags[id] &= ~NODE_COLLAPSED;
+
+    // Only this subtree's visibility changes: a node is hidden if its parent is hidden or collapsed
+    QVector<int> stack;
+    stack.append(id);
+    while(!stack.isEmpty())
+    {
+        int node = stack.last();
+        stack.pop_back();
+        bool hideChildren = (m_flags[node] & (NODE_COLLAPSED | NODE_HIDDEN)) != 0;
+        const int *children = m_children.constData() + m_firstChild[node];
+        for(int j=0; j<m_childCount[node]; j++)
+        {
+            if(hideChildren)
+                m_flags[children[j]] |= NODE_HIDDEN;
+            else
+                m_flags[children[j]] &= ~NODE_HIDDEN;
+            stack.append(children[j]);
+        }
+    }
+    return true;
+}
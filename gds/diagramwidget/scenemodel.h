@@ -0,0 +1,109 @@
+#ifndef SCENEMODEL_H
+#define SCENEMODEL_H
+
+#include <QVector>
+#include <QString>
+#include <QImage>
+#include <QTransform>
+
+// Based on how our rounded blocks are drawn, we have a minimum (object coords) on the
+// model matrix to avoid blocks overlap
+#define MINSPACE_BLOCKS_X 10
+#define MINSPACE_BLOCKS_Y 5
+
+// Graphs with fewer nodes are laid out on the calling thread, waking the pool up would cost more than the pass
+#define PARALLEL_LAYOUT_MIN_NODES 20000
+
+// The tree drawn by the diagram widget, stored as a structure of arrays. Every node is identified by an integer ID
+// (its insertion index) which is also stored in the dbDataStructure it represents, all the per-node data lives in
+// parallel arrays indexed by that ID so that the layout, drawing and picking passes are linear sweeps over a few
+// contiguous arrays instead of pointer chasing through the tree
+class SceneModel
+{
+public:
+    enum nodeFlags
+    {
+        NODE_SELECTED = 0x1,
+        NODE_COLLAPSED = 0x2,   // Drawn as a summary block, its descendants are hidden
+        NODE_HIDDEN = 0x4       // A descendant of a collapsed node: not laid out, drawn or picked
+    };
+
+    SceneModel();
+
+    void clear();
+    // Adds a node and returns its ID, parent is -1 for the root (there can be just one). Parents must be added
+    // before their children. Returns -1 on error
+    int addNode(const QString &label, int parent);
+    int size() const { return m_parent.size(); }
+    bool isEmpty() const { return m_parent.isEmpty(); }
+    int root() const { return m_parent.isEmpty() ? -1 : 0; }
+
+    // Builds the contiguous children lists (once every node has been added) and calculates every node's
+    // displacement: leaves are put side by side, a parent goes in the middle of its children. Large graphs are
+    // split into independent subtrees laid out by the global thread pool, maxThreads 1 keeps it on this thread
+    // (0 uses every core). Both give the same displacements
+    void layout(int maxThreads = 0);
+    // Children of a node, valid after layout(): m_children[m_firstChild[id] .. m_firstChild[id]+m_childCount[id]-1]
+    bool hasChildrenLists() const { return m_firstChild.size() == m_parent.size(); }
+
+    // Collapsing a node hides its whole subtree, the layout treats it as a leaf. Returns false if nothing changed
+    // (leaves can't be collapsed). Only the flags are updated, call relayout() on a laid out scene
+    bool setCollapsed(int id, bool collapsed);
+    bool isCollapsed(int id) const { return (m_flags[id] & NODE_COLLAPSED) != 0; }
+    bool isHidden(int id) const { return (m_flags[id] & NODE_HIDDEN) != 0; }
+    // Descendants of a node (the blocks a collapsed node stands for), valid after layout()
+    int descendantsCount(int id) const { return m_subtreeSize[id] - 1; }
+    // Lays out again after the subtree of a node has been collapsed or expanded. Nodes on its left keep their
+    // displacements, the pass restarts from the subtree's first node in post-order
+    void relayout(int id);
+
+    // Picking colors: each node is drawn with a unique color derived from its ID, the background color is skipped
+    static void colorForNode(int id, const float backgroundColor[3], unsigned char rgb[3]);
+    int nodeFromColor(const unsigned char rgb[3], const float backgroundColor[3]) const;
+
+    void setSelected(int id);
+    int selected() const { return m_selected; }
+
+    // An approximation of the heap memory used by the arrays
+    qint64 byteSize() const;
+
+    // Parallel arrays indexed by node ID
+    QVector<int> m_parent;          // -1 for the root
+    QVector<int> m_firstChild;      // Index of the first child in m_children
+    QVector<int> m_childCount;
+    QVector<int> m_depth;
+    QVector<long> m_x;              // Displacements, valid after layout() (or after restoring a saved layout)
+    QVector<long> m_y;
+    QVector<unsigned char> m_flags;
+    QVector<QString> m_labels;
+
+    QVector<int> m_children;        // Children IDs grouped by parent, in insertion order
+    QVector<int> m_postOrder;       // Node IDs in post-order (children before their parent), valid after layout()
+    QVector<int> m_postIndex;       // Position of every node in m_postOrder
+    QVector<int> m_subtreeSize;     // Nodes in the subtree of every node (itself included)
+
+private:
+    void buildChildrenLists();
+    void buildSubtreeSizes();
+    void layoutFrom(int first);
+    long layoutRange(int first, int last, long maximumXreached);
+    void layoutParallel(int threads);
+    friend class subtreeLayoutTask;
+    friend class subtreeShiftTask;
+    QVector<long> m_maxXBefore;     // Rightmost X reached before every post-order position, for relayout()
+    int m_selected;
+};
+
+// Everything the diagram widget builds to draw a tree: the scene (structure, collapsed blocks and layout) and the
+// minimap image rendered from it (null if it hasn't been rendered). A tree drawn again can be given its render data
+// back instead of being inserted and laid out again. Copies are cheap, the arrays are implicitly shared
+struct diagramRenderData
+{
+    SceneModel m_scene;
+    QImage m_minimap;
+    QTransform m_minimapTransform;
+
+    qint64 byteSize() const { return m_scene.byteSize() + m_minimap.byteCount(); }
+};
+
+#endif // SCENEMODEL_H
@@ -1,50 +1,71 @@
-#-------------------------------------------------
-#
-# Project created by QtCreator 2012-07-22T23:10:11
-#
-#-------------------------------------------------
-
-QT       += core gui opengl
-
-TARGET = gds
-TEMPLATE = app
-
-SOURCES += main.cpp\
-        startupmodewin.cpp \
-    qtsingleapplication/singleapplication.cpp \
-    mainwindoweditmode.cpp \
-    diagramwidget/qgldiagramwidget.cpp \
-    cpphighlighter.cpp \
-    texteditorwin.cpp \
-    codeeditorwid.cpp \
-    mainwindowviewmode.cpp \
-    creditswin.cpp
-
-HEADERS  += startupmodewin.h \
-    qtsingleapplication/singleapplication.h \
-    mainwindoweditmode.h \
-    diagramwidget/roundedRectangle.h \
-    diagramwidget/qgldiagramwidget.h \
-    gdsdbreader.h \
-    texteditorwin.h \
-    cpphighlighter.h \
-    codeeditorwid.h \
-    mainwindowviewmode.h \
-    creditswin.h
-
-FORMS    += startupmodewin.ui \
-    mainwindoweditmode.ui \
-    mainwindowviewmode.ui \
-    creditswin.ui
-
-RESOURCES += \
-    GDSResources.qrc
-
-win32: LIBS += -L$$PWD/lib/ -lglew32
-
-INCLUDEPATH += $$PWD/
-DEPENDPATH += $$PWD/
-
-win32: PRE_TARGETDEPS += $$PWD/lib/glew32.lib
-
-win32:RC_FILE = gds_icon/gds.rc
+#-------------------------------------------------
+#
+# Project created by QtCreator 2012-07-22T23:10:11
+#
+#-------------------------------------------------
+
+QT       += core gui opengl
+
+TARGET = gds
+TEMPLATE = app
+
+SOURCES += main.cpp\
+        startupmodewin.cpp \
+    qtsingleapplication/singleapplication.cpp \
+    mainwindoweditmode.cpp \
+    diagramwidget/qgldiagramwidget.cpp \
+    cpphighlighter.cpp \
+    texteditorwin.cpp \
+    codeeditorwid.cpp \
+    mainwindowviewmode.cpp \
+    creditswin.cpp \
+    cpplexer.cpp \
+    highlightcache.cpp \
+    symbolindex.cpp \
+    levelcache.cpp \
+    tourengine.cpp \
+    commentcache.cpp \
+    richtextcodec.cpp \
+    collapsestate.cpp \
+    diagramwidget/scenemodel.cpp \
+    diagramwidget/diagramrenderer.cpp
+
+HEADERS  += startupmodewin.h \
+    qtsingleapplication/singleapplication.h \
+    mainwindoweditmode.h \
+    diagramwidget/roundedRectangle.h \
+    diagramwidget/qgldiagramwidget.h \
+    texteditorwin.h \
+    cpphighlighter.h \
+    codeeditorwid.h \
+    mainwindowviewmode.h \
+    creditswin.h \
+    cpplexer.h \
+    highlightcache.h \
+    symbolindex.h \
+    levelcache.h \
+    tourengine.h \
+    commentcache.h \
+    richtextcodec.h \
+    collapsestate.h \
+    diagramwidget/scenemodel.h \
+    diagramwidget/diagramrenderer.h
+
+FORMS    += startupmodewin.ui \
+    mainwindoweditmode.ui \
+    mainwindowviewmode.ui \
+    creditswin.ui
+
+include(storage.pri)
+
+RESOURCES += \
+    GDSResources.qrc
+
+win32: LIBS += -L$$PWD/lib/ -lglew32
+
+INCLUDEPATH += $$PWD/
+DEPENDPATH += $$PWD/
+
+win32: PRE_TARGETDEPS += $$PWD/lib/glew32.lib
+
+win32:RC_FILE = gds_icon/gds.rc
@@ -0,0 +1,158 @@
+#include "highlightcache.h"
+#include "gdsdbreader.h"
+#include "reanchorer.h"
+#include "logger.h"
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QDir>
+
+// Disk cache files start with this, the version must be increased if the lexer output changes
+#define HIGHLIGHT_CACHE_MAGIC 0x67647368
+#define HIGHLIGHT_CACHE_VERSION 1
+
+// Recently used files, the cost of each entry is its size in KB
+static QCache<QByteArray, highlightData> memoryCache(HighlightCache::MEMORY_BUDGET_KB);
+static QMutex memoryCacheMutex;
+
+int highlightData::byteSize() const
+{
+    return (lineLengths.size() + lineStates.size() + firstToken.size()) * sizeof(int)
+            + tokens.size() * sizeof(cppToken);
+}
+
+QByteArray HighlightCache::contentHash(const QByteArray &content)
+{
+    return QCryptographicHash::hash(content, QCryptographicHash::Md5);
+}
+
+bool HighlightCache::find(const QByteArray &hash, highlightData &data)
+{
+    {
+        QMutexLocker locker(&memoryCacheMutex);
+        highlightData *cached = memoryCache.object(hash);
+        if(cached != NULL)
+        {
+            data = *cached; // Vectors are implicitly shared, no copy here
+            return true;
+        }
+    }
+
+    if(!diskCacheEnabled() || !readFromDisk(hash, data))
+        return false;
+
+    // Keep it in memory too
+    QMutexLocker locker(&memoryCacheMutex);
+    memoryCache.insert(hash, new highlightData(data), data.byteSize() / 1024 + 1);
+    return true;
+}
+
+void HighlightCache::insert(const QByteArray &hash, const highlightData &data)
+{
+    // Too big entries would just flush everything else
+    int cost = data.byteSize() / 1024 + 1;
+    if(cost <= MEMORY_BUDGET_KB)
+    {
+        QMutexLocker locker(&memoryCacheMutex);
+        memoryCache.insert(hash, new highlightData(data), cost);
+    }
+
+    if(diskCacheEnabled() && !QFile::exists(diskCacheFile(hash)))
+        writeToDisk(hash, data);
+}
+
+void HighlightCache::lexContent(const QByteArray &content, highlightData &data)
+{
+    data = highlightData();
+    QStringList lines = Reanchorer::splitSourceLines(content);
+    int state = CppLexer::STATE_NORMAL;
+    for(int i=0; i<lines.size(); i++)
+    {
+        data.firstToken.append(data.tokens.size());
+        state = CppLexer::lexLine(lines[i], state, data.tokens);
+        data.lineLengths.append(lines[i].length());
+        data.lineStates.append(state);
+    }
+    data.firstToken.append(data.tokens.size());
+}
+
+bool HighlightCache::diskCacheEnabled()
+{
+    return QDir(QString(GDS_DIR) + "/cache").exists();
+}
+
+QString HighlightCache::diskCacheFile(const QByteArray &hash)
+{
+    return QString(GDS_DIR) + "/cache/" + QString(hash.toHex()) + ".hlc";
+}
+
+bool HighlightCache::readFromDisk(const QByteArray &hash, highlightData &data)
+{
+    QFile file(diskCacheFile(hash));
+    if(!file.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic, version;
+    qint32 numLines, numTokens;
+    in >> magic >> version;
+    if(magic != HIGHLIGHT_CACHE_MAGIC || version != HIGHLIGHT_CACHE_VERSION)
+        return false; // Stale format, it will be lexed again
+
+    in >> numLines >> numTokens;
+    if(in.status() != QDataStream::Ok || numLines < 0 || numTokens < 0)
+        return false;
+
+    data.lineLengths.resize(numLines);
+    data.lineStates.resize(numLines);
+    data.firstToken.resize(numLines+1);
+    data.tokens.resize(numTokens);
+    for(int i=0; i<numLines; i++)
+    {
+        qint32 length, state, first;
+        in >> length >> state >> first;
+        data.lineLengths[i] = length;
+        data.lineStates[i] = state;
+        data.firstToken[i] = first;
+    }
+    data.firstToken[numLines] = numTokens;
+    for(int i=0; i<numTokens; i++)
+    {
+        qint32 start, length;
+        quint8 type;
+        in >> start >> length >> type;
+        data.tokens[i].start = start;
+        data.tokens[i].length = length;
+        data.tokens[i].type = type;
+    }
+
+    file.close();
+
+    if(in.status() != QDataStream::Ok)
+    {
+        gdsWarning(LOGCAT_EDITOR) << "HighlightCache - corrupted cache file " << diskCacheFile(hash);
+        data = highlightData();
+        return false;
+    }
+    return true;
+}
+
+void HighlightCache::writeToDisk(const QByteArray &hash, const highlightData &data)
+{
+    QFile file(diskCacheFile(hash));
+    if(!file.open(QFile::WriteOnly))
+        return;
+
+    QDataStream out(&file);
+    out << (quint32)HIGHLIGHT_CACHE_MAGIC << (quint32)HIGHLIGHT_CACHE_VERSION;
+    out << (qint32)data.lineCount() << (qint32)data.tokens.size();
+    for(int i=0; i<data.lineCount(); i++)
+        out << (qint32)data.lineLengths[i] << (qint32)data.lineStates[i] << (qint32)data.firstToken[i];
+    for(int i=0; i<data.tokens.size(); i++)
+        out << (qint32)data.tokens[i].start << (qint32)data.tokens[i].length << (quint8)data.tokens[i].type;
+
+    file.close();
+}
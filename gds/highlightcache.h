@@ -0,0 +1,49 @@
+#ifndef HIGHLIGHTCACHE_H
+#define HIGHLIGHTCACHE_H
+
+// Highlighter output cache: the tokens and the final state of every line of a code file, keyed by a hash of
+// the file content. Recently viewed files are kept in memory; if the GDS_DIR/cache directory exists they're
+// also stored on disk so they survive restarts (just create the directory to enable it). Thread-safe, code files
+// can be highlighted ahead of time by worker threads (see TourEngine)
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "cpplexer.h"
+
+struct highlightData
+{
+    QVector<int> lineLengths;   // Used to validate each line before reusing its tokens
+    QVector<int> lineStates;    // Lexer state at the end of each line
+    QVector<int> firstToken;    // Index of the first token of each line, plus one past the last line
+    QVector<cppToken> tokens;   // Tokens of all lines
+
+    int lineCount() const { return lineLengths.size(); }
+    // Approximated memory footprint in bytes
+    int byteSize() const;
+};
+
+class HighlightCache
+{
+public:
+    // Key for a code file content
+    static QByteArray contentHash(const QByteArray &content);
+
+    // Searches the memory cache first and then the disk one, returns false if not found
+    static bool find(const QByteArray &hash, highlightData &data);
+    static void insert(const QByteArray &hash, const highlightData &data);
+    // Lexes a whole code file the way the highlighter does, line by line
+    static void lexContent(const QByteArray &content, highlightData &data);
+
+    static bool diskCacheEnabled();
+
+    // Memory budget for the in-memory cache
+    static const int MEMORY_BUDGET_KB = 32 * 1024;
+
+private:
+    static QString diskCacheFile(const QByteArray &hash);
+    static bool readFromDisk(const QByteArray &hash, highlightData &data);
+    static void writeToDisk(const QByteArray &hash, const highlightData &data);
+};
+
+#endif // HIGHLIGHTCACHE_H
@@ -0,0 +1,246 @@
+#include "levelcache.h"
+#include "levelstorage.h"
+#include "logger.h"
+#include <QRunnable>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+// Default budget, a level with a few hundreds documented blocks takes around 1 MB
+qint64 LevelCache::m_memoryBudget = 64 * 1024 * 1024;
+
+// Reads and decodes a level file on a worker thread, then hands it to the cache
+class levelPrefetchTask : public QRunnable
+{
+public:
+    LevelCache *m_cache;
+    QString m_levelFile;
+
+    void run()
+    {
+        QVector<dbDataStructure*> elements;
+        QDateTime modified = QFileInfo(m_levelFile).lastModified();
+        bool ok = LevelStorage::readLevelFile(m_levelFile, elements);
+        m_cache->deliver(m_levelFile, elements, modified, ok);
+    }
+};
+
+LevelCache::LevelCache()
+{
+    m_usedBytes = 0;
+    // Reading is mostly I/O bound, a couple of workers are enough
+    m_pool.setMaxThreadCount(2);
+}
+
+LevelCache::~LevelCache()
+{
+    m_pool.waitForDone();
+    clear();
+}
+
+void LevelCache::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = bytes;
+}
+
+qint64 LevelCache::memoryBudget()
+{
+    return m_memoryBudget;
+}
+
+// An approximation of the heap memory used by a decoded level
+qint64 LevelCache::estimateByteSize(const QVector<dbDataStructure*> &elements)
+{
+    qint64 size = 0;
+    for(int i=0; i<elements.size(); i++)
+    {
+        const dbDataStructure *element = elements[i];
+        size += sizeof(dbDataStructure);
+        size += (element->label.size() + element->fileName.size()) * sizeof(QChar);
+        size += element->data.size() + element->firstLineData.size();
+        size += element->nextItems.size() * (sizeof(dbDataStructure*) + sizeof(quint32));
+        size += element->linesNumbers.size() * sizeof(quint32);
+    }
+    return size;
+}
+
+void LevelCache::prefetch(const QString &levelFile)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(m_levels.contains(levelFile))
+    {
+        touch(levelFile);
+        return; // Already there or loading
+    }
+    if(!QFile::exists(levelFile))
+        return;
+
+    cachedLevel level;
+    level.byteSize = 0;
+    level.loading = true;
+    level.resident = false;
+    level.discard = false;
+    m_levels.insert(levelFile, level);
+    touch(levelFile);
+
+    levelPrefetchTask *task = new levelPrefetchTask();
+    task->m_cache = this;
+    task->m_levelFile = levelFile;
+    m_pool.start(task);
+}
+
+void LevelCache::deliver(const QString &levelFile, QVector<dbDataStructure*> &elements, const QDateTime &modified, bool ok)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QString, cachedLevel>::iterator itr = m_levels.find(levelFile);
+    if(!ok || itr == m_levels.end() || itr.value().discard)
+    {
+        // Nobody wants it anymore
+        LevelStorage::freeElements(elements);
+        if(itr != m_levels.end())
+        {
+            m_levels.erase(itr);
+            m_usageOrder.removeAll(levelFile);
+        }
+    }
+    else
+    {
+        itr.value().elements = elements;
+        itr.value().modified = modified;
+        itr.value().byteSize = estimateByteSize(elements);
+        itr.value().loading = false;
+        m_usedBytes += itr.value().byteSize;
+        evict();
+    }
+
+    m_delivered.wakeAll();
+}
+
+bool LevelCache::takeLevel(const QString &levelFile, QVector<dbDataStructure*> &elements, diagramRenderData *renderData)
+{
+    if(renderData != NULL)
+        *renderData = diagramRenderData();
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // If it's being prefetched, wait for it
+        while(m_levels.contains(levelFile) && m_levels[levelFile].loading)
+            m_delivered.wait(&m_mutex);
+
+        if(m_levels.contains(levelFile))
+        {
+            cachedLevel level = m_levels.take(levelFile);
+            m_usageOrder.removeAll(levelFile);
+            m_usedBytes -= level.byteSize;
+
+            if(level.modified == QFileInfo(levelFile).lastModified())
+            {
+                // Hit, just swap
+                elements += level.elements;
+                if(renderData != NULL)
+                    *renderData = level.renderData;
+                return true;
+            }
+
+            // Changed on disk in the meanwhile
+            LevelStorage::freeElements(level.elements);
+        }
+    }
+
+    // Miss, read it now
+    return LevelStorage::readLevelFile(levelFile, elements);
+}
+
+void LevelCache::storeLevel(const QString &levelFile, QVector<dbDataStructure*> &elements, const diagramRenderData &renderData)
+{
+    if(elements.isEmpty())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    // A prefetch of the same file would be a stale copy, let it finish and replace it
+    while(m_levels.contains(levelFile) && m_levels[levelFile].loading)
+        m_delivered.wait(&m_mutex);
+    if(m_levels.contains(levelFile))
+        dropLevel(levelFile);
+
+    // The window doesn't own them anymore, node IDs will be set again when they're drawn
+    cachedLevel level;
+    level.elements = elements;
+    level.modified = QFileInfo(levelFile).lastModified();
+    level.renderData = renderData;
+    level.byteSize = estimateByteSize(elements) + renderData.byteSize();
+    level.loading = false;
+    level.resident = true;
+    level.discard = false;
+    m_levels.insert(levelFile, level);
+    m_usedBytes += level.byteSize;
+    elements.clear();
+
+    touch(levelFile);
+    evict();
+}
+
+void LevelCache::invalidate(const QString &levelFile)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QString, cachedLevel>::iterator itr = m_levels.find(levelFile);
+    if(itr == m_levels.end())
+        return;
+    if(itr.value().loading)
+    {
+        itr.value().discard = true;
+        return;
+    }
+    dropLevel(levelFile);
+}
+
+void LevelCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QStringList levelFiles = m_levels.keys();
+    for(int i=0; i<levelFiles.size(); i++)
+    {
+        if(m_levels[levelFiles[i]].loading)
+            m_levels[levelFiles[i]].discard = true;
+        else
+            dropLevel(levelFiles[i]);
+    }
+}
+
+void LevelCache::dropLevel(const QString &levelFile)
+{
+    cachedLevel level = m_levels.take(levelFile);
+    LevelStorage::freeElements(level.elements);
+    m_usedBytes -= level.byteSize;
+    m_usageOrder.removeAll(levelFile);
+}
+
+void LevelCache::touch(const QString &levelFile)
+{
+    m_usageOrder.removeAll(levelFile);
+    m_usageOrder.append(levelFile);
+}
+
+void LevelCache::evict()
+{
+    // Prefetched levels go first, then the resident ones, least recently used first. Loading ones are skipped
+    for(int pass=0; pass<2 && m_usedBytes > m_memoryBudget; pass++)
+    {
+        for(int i=0; i<m_usageOrder.size() && m_usedBytes > m_memoryBudget; )
+        {
+            const cachedLevel &level = m_levels[m_usageOrder[i]];
+            if(level.loading || (pass == 0 && level.resident))
+            {
+                i++;
+                continue;
+            }
+            gdsDebug(LOGCAT_STORAGE) << "LevelCache: evicting" << m_usageOrder[i] << "-" << level.byteSize << "bytes";
+            dropLevel(m_usageOrder[i]); // Removes it from m_usageOrder too
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef LEVELCACHE_H
+#define LEVELCACHE_H
+
+// Decoded level files kept in memory: the levels we've just left stay resident (zooming back is just a swap)
+// and the level under the selected block is loaded and decoded in advance by a worker thread (prefetching),
+// so zooming in doesn't need to read anything either. Entries are checked against the file's modification
+// time, a level changed on disk is read again. Levels we've left are kept with the render data they were drawn with
+// (scene arrays, layout and minimap), so drawing them again skips building the scene too. The least recently used
+// levels are freed when the cache grows over its memory budget, render data included
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QDateTime>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include "gdsdbreader.h"
+#include "diagramwidget/scenemodel.h"
+
+class LevelCache
+{
+public:
+    LevelCache();
+    ~LevelCache();
+
+    // Starts loading a level file in the background (if it exists and isn't cached or loading yet)
+    void prefetch(const QString &levelFile);
+    // Moves a level's elements out of the cache (waiting for it if it's being prefetched) or reads them from
+    // disk. Elements are owned by the caller from now on. Returns false if the level cannot be read.
+    // If renderData isn't NULL it receives the render data stored with the level (an empty scene if there's none)
+    bool takeLevel(const QString &levelFile, QVector<dbDataStructure*> &elements, diagramRenderData *renderData = NULL);
+    // Moves the elements of a level we're leaving into the cache, they must match what's on disk
+    void storeLevel(const QString &levelFile, QVector<dbDataStructure*> &elements, const diagramRenderData &renderData);
+    // Drops a level (e.g. the file has been deleted)
+    void invalidate(const QString &levelFile);
+    void clear();
+
+    // Memory (approximated) used by all the cached levels before the least recently used are freed, levels we've
+    // left are evicted after the prefetched ones. Shared by every cache
+    static void setMemoryBudget(qint64 bytes);
+    static qint64 memoryBudget();
+    static qint64 estimateByteSize(const QVector<dbDataStructure*> &elements);
+
+    // Called by the prefetching tasks
+    void deliver(const QString &levelFile, QVector<dbDataStructure*> &elements, const QDateTime &modified, bool ok);
+
+private:
+    struct cachedLevel
+    {
+        QVector<dbDataStructure*> elements;
+        QDateTime modified;     // File modification time when it was read
+        diagramRenderData renderData; // Empty scene if the level hasn't been drawn yet
+        qint64 byteSize;        // Elements and render data
+        bool loading;           // A worker is reading it
+        bool resident;          // A level we've left, kept in memory with a higher priority
+        bool discard;           // Invalidated while loading, drop it as soon as it's delivered
+    };
+
+    void evict(); // Must be called with the mutex locked
+    void dropLevel(const QString &levelFile); // Same as above, frees a loaded level
+    void touch(const QString &levelFile);
+
+    QHash<QString, cachedLevel> m_levels;
+    QStringList m_usageOrder; // Least recently used first
+    qint64 m_usedBytes;
+    static qint64 m_memoryBudget;
+    QMutex m_mutex;
+    QWaitCondition m_delivered;
+    QThreadPool m_pool;
+};
+
+#endif // LEVELCACHE_H
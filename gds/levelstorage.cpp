@@ -0,0 +1,389 @@
+#include "levelstorage.h"
+#include "profiler.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QFile>
+#include <QDir>
+#include <QSet>
+
+QString LevelStorage::levelFilePath(level lvl, quint64 levelOneID, quint64 levelTwoID)
+{
+    switch(lvl)
+    {
+        case LEVEL_ONE:
+        {
+            // "level1_general.gds" file
+            return QString(GDS_DIR) + "/level1_general.gds";
+        }
+        case LEVEL_TWO:
+        {
+            // "level2_X1.gds" file
+            return QString(GDS_DIR) + "/level2_" + QString("%1").arg(levelOneID) + ".gds";
+        }
+        case LEVEL_THREE:
+        {
+            // "level3_X1_X2.gds" file
+            return QString(GDS_DIR) + "/level3_" + QString("%1").arg(levelOneID) + "_" +
+                    QString("%1").arg(levelTwoID) + ".gds";
+        }
+    }
+    return QString();
+}
+
+QStringList LevelStorage::allLevelFiles()
+{
+    QStringList levelFiles;
+    QDir gdsDir(GDS_DIR);
+    if(!gdsDir.exists())
+        return levelFiles;
+
+    // Sorting by name puts level1 before level2 files and these before level3 files
+    QStringList fileNames = gdsDir.entryList(QStringList() << "level*.gds", QDir::Files, QDir::Name);
+    for(int i=0; i<fileNames.size(); i++)
+    {
+        if(parseLevelFileName(fileNames[i], NULL, NULL, NULL))
+            levelFiles.append(QString(GDS_DIR) + "/" + fileNames[i]);
+    }
+    return levelFiles;
+}
+
+bool LevelStorage::parseLevelFileName(const QString &levelFile, level *lvl, quint64 *levelOneID, quint64 *levelTwoID)
+{
+    // Just take the name, the directory doesn't matter
+    QString name = levelFile.section('/', -1);
+    if(!name.endsWith(".gds"))
+        return false;
+    name.chop(4);
+
+    level m_lvl;
+    quint64 m_levelOneID = 0, m_levelTwoID = 0;
+    bool ok = true;
+    if(name == "level1_general")
+    {
+        m_lvl = LEVEL_ONE;
+    }
+    else if(name.startsWith("level2_"))
+    {
+        m_lvl = LEVEL_TWO;
+        m_levelOneID = name.mid(7).toULongLong(&ok);
+    }
+    else if(name.startsWith("level3_"))
+    {
+        m_lvl = LEVEL_THREE;
+        QStringList ids = name.mid(7).split('_');
+        if(ids.size() != 2)
+            return false;
+        bool ok2;
+        m_levelOneID = ids[0].toULongLong(&ok);
+        m_levelTwoID = ids[1].toULongLong(&ok2);
+        ok = ok && ok2;
+    }
+    else
+        return false;
+
+    if(!ok)
+        return false;
+
+    if(lvl)
+        *lvl = m_lvl;
+    if(levelOneID)
+        *levelOneID = m_levelOneID;
+    if(levelTwoID)
+        *levelTwoID = m_levelTwoID;
+    return true;
+}
+
+bool LevelStorage::readLevelFile(const QString &levelFile, QVector<dbDataStructure*> &elements, QString *error)
+{
+    // The whole file is read at once, decoding (and decompressing) it is timed apart
+    QByteArray m_fileData;
+    {
+        PROFILE_SCOPE("readLevelFile (disk)");
+        QFile file(levelFile);
+        if(!file.open(QFile::ReadOnly))
+        {
+            if(error)
+                *error = "cannot open the file";
+            return false;
+        }
+        m_fileData = file.readAll();
+        file.close();
+    }
+    PROFILE_SCOPE("readLevelFile (decode)");
+
+    // Thanks to our << and >> overloads, this will serialize just what we need
+    QDataStream in(m_fileData);
+
+    // Read the number of elements stored (every element takes more than a byte, a bigger number is garbage)
+    int m_numElements;
+    in >> m_numElements;
+    if(in.status() != QDataStream::Ok || m_numElements < 0 || m_numElements > m_fileData.size())
+    {
+        if(error)
+            *error = "invalid elements count";
+        return false;
+    }
+
+    // The level gets its own arena sized for all its elements: they lie in a single chunk and are freed with
+    // it, see freeElements(). Nobody else touches the arena, no locking is needed on the loader threads
+    QVector<dbDataStructure*> m_readElements;
+    m_readElements.reserve(m_numElements);
+    NodeArena<dbDataStructure> *m_arena = new NodeArena<dbDataStructure>(m_numElements);
+    dbDataStructure *m_tempPointer;
+    for(int i=0; i<m_numElements && in.status() == QDataStream::Ok; i++)
+    {
+        // Read one structure and allocate it into memory
+        m_tempPointer = m_arena->create();
+        m_tempPointer->arena = m_arena;
+        in >> *m_tempPointer;
+        m_readElements.append(m_tempPointer);
+    }
+    if(m_readElements.isEmpty())
+        delete m_arena;
+
+    // A truncated file or an index pointing outside the level would leave us with dangling pointers
+    QString m_error;
+    if(in.status() != QDataStream::Ok)
+        m_error = "truncated or corrupted data";
+    for(int i=0; i<m_readElements.size() && m_error.isEmpty(); i++)
+    {
+        if(!m_readElements[i]->noFatherRoot && m_readElements[i]->fatherIndex >= (quint32)m_numElements)
+            m_error = QString("block %1 has an invalid father index").arg(i);
+        for(int j=0; j<m_readElements[i]->nextItemsIndices.size(); j++)
+        {
+            if(m_readElements[i]->nextItemsIndices[j] >= (quint32)m_numElements)
+                m_error = QString("block %1 has an invalid child index").arg(i);
+        }
+    }
+    if(!m_error.isEmpty())
+    {
+        if(error)
+            *error = m_error;
+        freeElements(m_readElements);
+        return false;
+    }
+
+    // Data is unusable yet, we need to re-convert each index-pointer to a proper memory pointer first
+    convertDbDataToStorableData(m_readElements, false);
+    elements += m_readElements;
+
+    return true;
+}
+
+bool LevelStorage::writeLevelFile(const QString &levelFile, QVector<dbDataStructure*> &elements)
+{
+    PROFILE_SCOPE("writeLevelFile");
+
+    // This takes care of converting all memory pointers into indices
+    convertDbDataToStorableData(elements, true);
+
+    // Serialize our current data
+    QFile file(levelFile);
+    if(!file.open(QFile::WriteOnly))
+        return false;
+
+    // Thanks to our << and >> overloads, this will serialize just what we need
+    QDataStream out(&file);
+
+    // Write out the number of elements and all the data structures
+    out << elements.size();
+    for(int i=0; i<elements.size(); i++)
+    {
+        out << *(elements[i]); // Remember that these are pointers, they need to be dereferenced
+    }
+
+    file.close();
+    return true;
+}
+
+void LevelStorage::freeElement(dbDataStructure *element)
+{
+    if(element == NULL)
+        return;
+    if(element->arena != NULL)
+    {
+        // Levels never get new nodes from their arena once read, the last node freed takes the arena with it
+        NodeArena<dbDataStructure> *arena = element->arena;
+        arena->destroy(element);
+        if(arena->isEmpty())
+            delete arena;
+    }
+    else
+        delete element;
+}
+
+void LevelStorage::freeElements(QVector<dbDataStructure*> &elements)
+{
+    // Elements added by the editor are on the heap, the others are destroyed along with their level's arena
+    // in a single sweep (NodeArena::clear())
+    QSet< NodeArena<dbDataStructure>* > arenas;
+    for(int i=0; i<elements.size(); i++)
+    {
+        if(elements[i]->arena != NULL)
+            arenas.insert(elements[i]->arena);
+        else
+            delete elements[i];
+    }
+    QSet< NodeArena<dbDataStructure>* >::const_iterator itr;
+    for(itr = arenas.constBegin(); itr != arenas.constEnd(); ++itr)
+    {
+        (*itr)->clear();
+        delete *itr;
+    }
+    elements.clear();
+}
+
+// This function takes care of converting and marshalling all memory pointers of
+// the elements into QVector<quint32> nextItemsIndices indices to store on disk
+void LevelStorage::convertDbDataToStorableData(QVector<dbDataStructure*> &elements, bool m_towardsDiskFile)
+{
+    if(m_towardsDiskFile)
+    {
+        for(int i=0; i<elements.size(); i++)
+        {
+            // Convert all children
+            elements[i]->nextItemsIndices.clear();
+            for(int j=0; j<elements[i]->nextItems.size(); j++)
+            {
+                elements[i]->nextItemsIndices.append(elements.indexOf(elements[i]->nextItems[j]));
+            }
+            // Convert the father
+            if(elements[i]->father == NULL)
+            {
+                // Set this element as root - no father
+                elements[i]->fatherIndex = 0; // Just to put a placeholder value
+                elements[i]->noFatherRoot = true;
+            }
+            else
+            {
+                elements[i]->noFatherRoot = false;
+                elements[i]->fatherIndex = elements.indexOf(elements[i]->father);
+            }
+        }
+    }
+    else
+    {
+        for(int i=0; i<elements.size(); i++)
+        {
+            // De-convert all children
+            elements[i]->nextItems.clear();
+            elements[i]->nextItems.reserve(elements[i]->nextItemsIndices.size());
+            for(int j=0; j<elements[i]->nextItemsIndices.size(); j++)
+            {
+                elements[i]->nextItems.append(elements[elements[i]->nextItemsIndices[j]]);
+            }
+            // Convert the father (root hasn't one)
+            if(elements[i]->fatherIndex == 0 && elements[i]->noFatherRoot == true)
+                elements[i]->father = NULL;
+            else
+                elements[i]->father = elements[elements[i]->fatherIndex];
+        }
+    }
+}
+
+// Empty unless set by a tool not running from the gds directory
+QString LevelStorage::m_applicationDir;
+
+void LevelStorage::setApplicationDir(const QString &dir)
+{
+    m_applicationDir = QDir(dir).absolutePath();
+}
+
+QString LevelStorage::applicationFilePath()
+{
+    if(m_applicationDir.isEmpty())
+        return QCoreApplication::applicationFilePath();
+    // Just the directory matters, the application name is removed by the callers
+    return m_applicationDir + "/gds";
+}
+
+QString LevelStorage::convertToRelativePath(QString fileAbsolutePath)
+{
+    // Get current app absolute path
+    QString myAbsolutePath = applicationFilePath();
+
+    // Convert into relative file path from this directory
+    QStringList myPaths = myAbsolutePath.split(QRegExp("/"), QString::SkipEmptyParts);
+    QStringList filePaths = fileAbsolutePath.split(QRegExp("/"), QString::SkipEmptyParts);
+
+    // Delete the application name
+    myPaths.removeLast();
+
+    // if the file is on another drive, just take the entire path
+    if(filePaths.isEmpty() || myPaths.isEmpty() || filePaths[0] != myPaths[0])
+    {
+        // Different drive
+        return fileAbsolutePath;
+    }
+    else
+    {
+        // For each common path, delete this item
+        do
+        {
+            if(myPaths.size() < 1 || filePaths.size() < 1)
+                break;
+            if(myPaths[0] == filePaths[0])
+            {
+                myPaths.removeFirst();
+                filePaths.removeFirst();
+            }
+            else
+                break;
+        }while(1);
+        // Substitute every not-common part of myPaths with ..
+        if(myPaths.size() > 0)
+        {
+            for(int i=0; i<myPaths.size(); i++)
+                myPaths.replace(i, "..");
+        }
+        // Add every non-common part of filePaths and we're done
+        for(int i=0; i<filePaths.size(); i++)
+            myPaths.append(filePaths[i]);
+
+        // Restore the "/" separators
+        return myPaths.join("/");
+    }
+}
+
+QString LevelStorage::convertToAbsolutePath(QString relativePath)
+{
+    // Paths on another drive were stored as they were
+    if(QDir::isAbsolutePath(relativePath))
+        return relativePath;
+
+    // Split the file relative path
+    QStringList filePaths = relativePath.split(QRegExp("/"), QString::SkipEmptyParts);
+    if(filePaths.isEmpty())
+        return "";
+
+    // Get current app absolute path and split it
+    QString myAbsolutePath = applicationFilePath();
+    QStringList myPaths = myAbsolutePath.split(QRegExp("/"), QString::SkipEmptyParts);
+
+    // Delete the application name
+    myPaths.removeLast();
+
+    do
+    {
+        // Sanity check
+        if(myPaths.size() < filePaths.count(".."))
+            return "";
+
+        if(filePaths[0] == "..")
+        {
+            myPaths.removeLast();
+            filePaths.removeFirst();
+        }
+        else
+            break;
+    }while(!filePaths.isEmpty());
+
+    // Append the rest and rejoin
+    for(int i=0; i<filePaths.size(); i++)
+        myPaths.append(filePaths[i]);
+
+    // Restore the "/" separators (and the root one on unix-like systems)
+    if(myAbsolutePath.startsWith("/"))
+        return "/" + myPaths.join("/");
+    return myPaths.join("/");
+}
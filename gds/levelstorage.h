@@ -0,0 +1,52 @@
+#ifndef LEVELSTORAGE_H
+#define LEVELSTORAGE_H
+
+// Window-independent access to the level files stored into the GDS_DIR directory. Everything that needs
+// to read or write level databases without going through the main windows (batch jobs, command line
+// operations) should use these routines
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "gdsdbreader.h"
+
+class LevelStorage
+{
+public:
+    // Returns the relative path of the level file identified by the level and its parents' uniqueIDs
+    // (levelOneID is ignored for LEVEL_ONE, levelTwoID is ignored for LEVEL_ONE and LEVEL_TWO)
+    static QString levelFilePath(level lvl, quint64 levelOneID, quint64 levelTwoID);
+    // Returns every level file present in the GDS_DIR directory (relative paths), level one first
+    static QStringList allLevelFiles();
+    // Retrieves the level and the parents' uniqueIDs from a level file name, returns false if the name
+    // isn't a valid level file name
+    static bool parseLevelFileName(const QString &levelFile, level *lvl, quint64 *levelOneID, quint64 *levelTwoID);
+
+    // Reads a level file and allocates all its elements with father/children pointers already restored,
+    // returns false if the file cannot be opened or is corrupted (error, if not NULL, receives the reason)
+    static bool readLevelFile(const QString &levelFile, QVector<dbDataStructure*> &elements, QString *error = NULL);
+    // Writes all elements to a level file (indices are recalculated from the pointers first)
+    static bool writeLevelFile(const QString &levelFile, QVector<dbDataStructure*> &elements);
+    // Frees a single element, whether it comes from a level's arena or has been allocated with new. A level's
+    // arena is freed along with its last element
+    static void freeElement(dbDataStructure *element);
+    // Frees every element and empties the vector, the arenas of the levels read into the vector are freed as
+    // a whole (with every node still allocated from them)
+    static void freeElements(QVector<dbDataStructure*> &elements);
+
+    // Converts pointers to indices (towards disk) or indices to pointers (from disk)
+    static void convertDbDataToStorableData(QVector<dbDataStructure*> &elements, bool m_towardsDiskFile);
+
+    // Code file paths are stored relative to the application's directory
+    static QString convertToRelativePath(QString fileAbsolutePath);
+    static QString convertToAbsolutePath(QString relativePath);
+    // Tools not installed next to the gds executable (the command line tool) set its directory here, so that
+    // code file paths are resolved the same way
+    static void setApplicationDir(const QString &dir);
+
+private:
+    static QString applicationFilePath();
+    static QString m_applicationDir;
+};
+
+#endif // LEVELSTORAGE_H
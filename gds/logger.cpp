@@ -0,0 +1,206 @@
+#include "logger.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QVector>
+#include <QStringList>
+#include <QDateTime>
+#include <QFile>
+#include <stdio.h>
+
+static const char *levelNames[] = {"debug", "info", "warning", "error", "none"};
+static const char *categoryNames[] = {"general", "storage", "selection", "diagram", "editor", "index"};
+
+logLevel Logger::m_levels[LOGCAT_COUNT] = {LOGLEVEL_WARNING, LOGLEVEL_WARNING, LOGLEVEL_WARNING,
+                                           LOGLEVEL_WARNING, LOGLEVEL_WARNING, LOGLEVEL_WARNING};
+
+struct logEntry
+{
+    QDateTime time;
+    logCategory category;
+    logLevel level;
+    QString message;
+};
+
+// The ring buffer and its writer, everything is guarded by logMutex
+static QMutex logMutex;
+static QWaitCondition logAvailable;
+static QWaitCondition logDrained;
+static QVector<logEntry> logRing(Logger::RING_SIZE);
+static int logFirst = 0;
+static int logCount = 0;
+static int logDropped = 0;
+static bool logWriting = false;
+static bool logStopping = false;
+static QFile logFile;
+
+static QByteArray formatEntry(const logEntry &entry)
+{
+    return (entry.time.toString("hh:mm:ss.zzz") + " " + levelNames[entry.level] + " " +
+            categoryNames[entry.category] + ": " + entry.message + "\n").toLocal8Bit();
+}
+
+// Called by one thread at a time: the writer thread, or a synchronous write when there's no writer
+static void writeEntries(const QVector<logEntry> &entries, int dropped)
+{
+    QByteArray data;
+    if(dropped > 0)
+        data += QString("%1 log messages dropped\n").arg(dropped).toLocal8Bit();
+    for(int i=0; i<entries.size(); i++)
+        data += formatEntry(entries[i]);
+
+    fwrite(data.constData(), 1, data.size(), stderr);
+    fflush(stderr);
+    if(logFile.isOpen())
+    {
+        logFile.write(data);
+        logFile.flush();
+    }
+}
+
+class logWriterThread : public QThread
+{
+protected:
+    void run()
+    {
+        QVector<logEntry> entries;
+        QMutexLocker locker(&logMutex);
+        while(true)
+        {
+            while(logCount == 0 && !logStopping)
+                logAvailable.wait(&logMutex);
+            if(logCount == 0 && logStopping)
+                break;
+
+            // Take everything queued and write it without holding the lock
+            entries.resize(0);
+            for(int i=0; i<logCount; i++)
+                entries.append(logRing[(logFirst + i) % logRing.size()]);
+            logFirst = (logFirst + logCount) % logRing.size();
+            logCount = 0;
+            int dropped = logDropped;
+            logDropped = 0;
+            logWriting = true;
+
+            locker.unlock();
+            writeEntries(entries, dropped);
+            locker.relock();
+
+            logWriting = false;
+            logDrained.wakeAll();
+        }
+    }
+};
+
+static logWriterThread *logWriter = NULL;
+
+// Registered as a post routine: everything queued is written before the application goes away
+static void stopLogWriter()
+{
+    {
+        QMutexLocker locker(&logMutex);
+        logStopping = true;
+        logAvailable.wakeAll();
+    }
+    logWriter->wait();
+    delete logWriter;
+    logWriter = NULL;
+    logStopping = false;
+}
+
+void Logger::setLevel(logCategory category, logLevel level)
+{
+    m_levels[category] = level;
+}
+
+bool Logger::configure(const QString &spec)
+{
+    bool ok = true;
+    QStringList pairs = spec.split(',', QString::SkipEmptyParts);
+    for(int i=0; i<pairs.size(); i++)
+    {
+        QString category = pairs[i].section('=', 0, 0).trimmed().toLower();
+        QString level = pairs[i].section('=', 1).trimmed().toLower();
+
+        int levelIndex = -1;
+        for(int j=0; j<=LOGLEVEL_NONE; j++)
+        {
+            if(level == levelNames[j])
+                levelIndex = j;
+        }
+        bool found = false;
+        for(int j=0; j<LOGCAT_COUNT && levelIndex != -1; j++)
+        {
+            if(category == "*" || category == categoryNames[j])
+            {
+                m_levels[j] = (logLevel)levelIndex;
+                found = true;
+            }
+        }
+        if(!found)
+            ok = false;
+    }
+    return ok;
+}
+
+bool Logger::setLogFile(const QString &path)
+{
+    QMutexLocker locker(&logMutex);
+    if(logFile.isOpen())
+        logFile.close();
+    logFile.setFileName(path);
+    return logFile.open(QFile::WriteOnly | QFile::Append | QFile::Text);
+}
+
+void Logger::write(logCategory category, logLevel level, const QString &message)
+{
+    logEntry entry;
+    entry.time = QDateTime::currentDateTime();
+    entry.category = category;
+    entry.level = level;
+    entry.message = message;
+
+    // Without an application there's no post routine to stop the writer, write synchronously
+    if(QCoreApplication::instance() == NULL)
+    {
+        QMutexLocker locker(&logMutex);
+        writeEntries(QVector<logEntry>() << entry, 0);
+        return;
+    }
+
+    {
+        QMutexLocker locker(&logMutex);
+        if(logWriter == NULL)
+        {
+            logWriter = new logWriterThread();
+            logWriter->start(QThread::LowPriority);
+            qAddPostRoutine(stopLogWriter);
+        }
+
+        if(logCount == logRing.size())
+        {
+            // Full, drop the oldest message
+            logFirst = (logFirst + 1) % logRing.size();
+            logCount--;
+            logDropped++;
+        }
+        logRing[(logFirst + logCount) % logRing.size()] = entry;
+        logCount++;
+        logAvailable.wakeOne();
+    }
+
+    // Errors might precede a crash, don't leave them in the queue
+    if(level >= LOGLEVEL_ERROR)
+        flush();
+}
+
+void Logger::flush()
+{
+    QMutexLocker locker(&logMutex);
+    if(logWriter == NULL)
+        return;
+    while(logCount > 0 || logWriting)
+        logDrained.wait(&logMutex);
+}
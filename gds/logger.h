@@ -0,0 +1,80 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+// Categorized diagnostics. A message is formatted only if its category is enabled at its level, then it's queued
+// into a ring buffer and written to stderr (and to the log file, if any) by a background thread, so logging never
+// waits for the console. Levels below GDS_LOG_MIN_LEVEL are compiled out entirely. Categories log warnings and
+// errors by default, others are turned on with --log "category=level,..." or the GDS_LOG environment variable,
+// e.g. --log selection=debug,storage=info (* stands for every category)
+
+#include <QString>
+#include <QDebug>
+
+enum logLevel {LOGLEVEL_DEBUG, LOGLEVEL_INFO, LOGLEVEL_WARNING, LOGLEVEL_ERROR, LOGLEVEL_NONE};
+enum logCategory {LOGCAT_GENERAL, LOGCAT_STORAGE, LOGCAT_SELECTION, LOGCAT_DIAGRAM, LOGCAT_EDITOR, LOGCAT_INDEX,
+                  LOGCAT_COUNT};
+
+// Release builds don't even contain the debug messages
+#ifndef GDS_LOG_MIN_LEVEL
+#ifdef QT_NO_DEBUG
+#define GDS_LOG_MIN_LEVEL LOGLEVEL_INFO
+#else
+#define GDS_LOG_MIN_LEVEL LOGLEVEL_DEBUG
+#endif
+#endif
+
+class Logger
+{
+public:
+    static bool isEnabled(logCategory category, logLevel level)
+    {
+        return level >= GDS_LOG_MIN_LEVEL && level >= m_levels[category];
+    }
+    static void setLevel(logCategory category, logLevel level);
+    // Comma separated "category=level" pairs, returns false if something isn't valid (valid pairs are applied)
+    static bool configure(const QString &spec);
+    // Messages are also appended to this file
+    static bool setLogFile(const QString &path);
+
+    // Queues a message, if the writer can't keep up the oldest queued messages are dropped. Errors are
+    // written before returning
+    static void write(logCategory category, logLevel level, const QString &message);
+    // Waits until every queued message has been written
+    static void flush();
+
+    // Messages waiting to be written
+    static const int RING_SIZE = 1024;
+
+private:
+    static logLevel m_levels[LOGCAT_COUNT];
+};
+
+// Collects a message through QDebug's stream operators and queues it when it goes out of scope
+class LogMessage
+{
+public:
+    LogMessage(logCategory category, logLevel level) : m_category(category), m_level(level), m_debug(&m_text) {}
+    ~LogMessage()
+    {
+        Logger::write(m_category, m_level, m_text.trimmed());
+    }
+    QDebug &stream() { return m_debug; }
+
+private:
+    logCategory m_category;
+    logLevel m_level;
+    QString m_text;
+    QDebug m_debug; // Writes straight into m_text
+};
+
+// Use these as qDebug()/qWarning(): nothing after the macro is evaluated if the message isn't enabled. A loop
+// running at most once rather than an if, so that an else following the statement isn't captured
+#define GDS_LOG(category, level) \
+    for(bool gdsLogEnabled = Logger::isEnabled(category, level); gdsLogEnabled; gdsLogEnabled = false) \
+        LogMessage(category, level).stream()
+#define gdsDebug(category) GDS_LOG(category, LOGLEVEL_DEBUG)
+#define gdsInfo(category) GDS_LOG(category, LOGLEVEL_INFO)
+#define gdsWarning(category) GDS_LOG(category, LOGLEVEL_WARNING)
+#define gdsError(category) GDS_LOG(category, LOGLEVEL_ERROR)
+
+#endif // LOGGER_H
@@ -1,47 +1,83 @@
-#include "qtsingleapplication/singleapplication.h"
-#include "startupmodewin.h"
-#include "mainwindoweditmode.h"
-#include "mainwindowviewmode.h"
-
-#include <QDebug>
-
-int main(int argc, char *argv[])
-{
-    SingleApplication app(argc, argv, "gds#uids#");
-
-    if (app.isRunning())
-    {
-        // Another instance is already running
-        qWarning() << "Another instance is already running";
-        return EXIT_FAILURE;
-    }
-
-    //app.setQuitOnLastWindowClosed(true);
-
-    // First show the startup window and let the user choose between
-    // view mode and edit mode
-
-    startupModeWin *startWin = new startupModeWin();
-    if(startWin->exec())
-    {
-        MainWindowViewMode *mainViewWin;
-        MainWindowEditMode *mainEditWin;
-        if(startWin->m_viewMode)
-        {
-            qWarning() << "View mode";
-
-            mainViewWin = new MainWindowViewMode();
-            mainViewWin->show();
-        }
-        else
-        {
-            qWarning() << "Edit mode";
-
-            mainEditWin = new MainWindowEditMode();
-            mainEditWin->show();
-        }
-        return app.exec();
-    }
-
-    return -1;
-}
+#include "qtsingleapplication/singleapplication.h"
+#include "startupmodewin.h"
+#include "mainwindoweditmode.h"
+#include "mainwindowviewmode.h"
+#include "levelcache.h"
+#include "profiler.h"
+#include "logger.h"
+
+#include <QStringList>
+#include <stdlib.h>
+
+int main(int argc, char *argv[])
+{
+    // Command line options, headless operations (re-anchoring, validation...) are done by the gds-cli tool
+    QString traceFile;
+    // Log levels, e.g. GDS_LOG=selection=debug,storage=info (see logger.h), --log overrides the environment
+    if(getenv("GDS_LOG") != NULL && !Logger::configure(getenv("GDS_LOG")))
+        gdsWarning(LOGCAT_GENERAL) << "Invalid GDS_LOG levels" << getenv("GDS_LOG");
+    for(int i=1; i<argc; i++)
+    {
+        if(QString(argv[i]) == "--log" && i+1 < argc && !Logger::configure(argv[i+1]))
+            gdsWarning(LOGCAT_GENERAL) << "Invalid --log levels" << argv[i+1];
+        if(QString(argv[i]) == "--log-file" && i+1 < argc && !Logger::setLogFile(argv[i+1]))
+            gdsWarning(LOGCAT_GENERAL) << "Cannot open the log file" << argv[i+1];
+        // Profiling from the start (the overlay is shown with F12): --profile, or --trace <file> to also write
+        // a Chrome trace when gds is closed
+        if(QString(argv[i]) == "--profile")
+            Profiler::setEnabled(true);
+        if(QString(argv[i]) == "--trace" && i+1 < argc)
+        {
+            traceFile = QString(argv[i+1]);
+            Profiler::setEnabled(true);
+        }
+        // Memory budget of the decoded levels cache: --level-cache-mb <megabytes>
+        if(QString(argv[i]) == "--level-cache-mb" && i+1 < argc)
+        {
+            qint64 megabytes = QString(argv[i+1]).toLongLong();
+            if(megabytes > 0)
+                LevelCache::setMemoryBudget(megabytes * 1024 * 1024);
+        }
+    }
+
+    SingleApplication app(argc, argv, "gds#uids#");
+
+    if (app.isRunning())
+    {
+        // Another instance is already running
+        gdsWarning(LOGCAT_GENERAL) << "Another instance is already running";
+        return EXIT_FAILURE;
+    }
+
+    //app.setQuitOnLastWindowClosed(true);
+
+    // First show the startup window and let the user choose between
+    // view mode and edit mode
+
+    startupModeWin *startWin = new startupModeWin();
+    if(startWin->exec())
+    {
+        MainWindowViewMode *mainViewWin;
+        MainWindowEditMode *mainEditWin;
+        if(startWin->m_viewMode)
+        {
+            gdsInfo(LOGCAT_GENERAL) << "View mode";
+
+            mainViewWin = new MainWindowViewMode();
+            mainViewWin->show();
+        }
+        else
+        {
+            gdsInfo(LOGCAT_GENERAL) << "Edit mode";
+
+            mainEditWin = new MainWindowEditMode();
+            mainEditWin->show();
+        }
+        int result = app.exec();
+        if(!traceFile.isEmpty() && !Profiler::writeChromeTrace(traceFile))
+            gdsError(LOGCAT_GENERAL) << "Cannot write the profiler trace to" << traceFile;
+        return result;
+    }
+
+    return -1;
+}
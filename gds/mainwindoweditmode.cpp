@@ -1,1650 +1,1677 @@
-#include "mainwindoweditmode.h"
-#include "ui_mainwindoweditmode.h"
-
-MainWindowEditMode::MainWindowEditMode(QWidget *parent) :
-    QMainWindow(parent),
-    ui(new Ui::MainWindowEditMode)
-{
-    ui->setupUi(this);
-
-    m_swapRunning = false;
-    m_lastSelectedHasBeenDeleted = false;
-    m_currentGraphElements.clear();
-    m_selectedElement = NULL;
-    ui->spinBox->setEnabled(true);
-    // Still no element selected, and we're in level one
-    m_currentLevelOneID = -1;
-    m_currentLevelTwoID = -1;
-
-    // Add the textEditor widget to the right part
-    txtEditorWidget = new textEditorWin();
-    ui->rightArea->addWidget(txtEditorWidget);
-
-    // Create the code editor in the left pane and the line counter
-    codeEditorWidget = new CodeEditorWidget(*(ui->lineCounter));
-    // Create the code window on the left pane
-    txtHighlighter = new CppHighlighter(codeEditorWidget->document());
-    // Insert it into the window
-    ui->codeLayout->addWidget(codeEditorWidget);
-    codeEditorWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    codeEditorWidget->setMinimumWidth(200);
-
-    // Set the connection for the label box
-    connect(ui->txtLabel, SIGNAL(returnPressed()), this, SLOT(enterPressedOnLabelEditBox()));
-
-    // Enable multisampling (anti-aliasing) if supported
-    // for the following widgets
-    QGLFormat glf = QGLFormat::defaultFormat();
-    glf.setSampleBuffers(true);
-    glf.setSamples(4);
-    QGLFormat::setDefaultFormat(glf);
-
-    // SET FIRST LEVEL ACTIVE
-    //
-    // Notice: after the constructor, no one else is allowed to change this variable's value,
-    // use the proper method instead (that updates the code window too if needed)
-    m_currentActiveLevel = LEVEL_ONE;
-
-    // First time the edit mode is launched, we're in the first level (everyone can understand it), so
-    // we don't need any code file
-    this->ui->containerWidget->hide();
-    this->ui->goToPreviousLevel->setEnabled(false);
-
-    // Create the diagram widget
-    GLDiagramWidget = new QGLDiagramWidget((QMainWindow*)this);
-    GLDiagramWidget->m_gdsEditMode = true; // No animation while selecting
-    this->ui->graphLayout->addWidget(GLDiagramWidget);
-    // Assign the widget to this window
-    GLDiagramWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-
-    //
-    // DATABASE OPERATIONS ONGOING
-    //
-
-    // Try to load the level-1 documentation if present, otherwise create the db directory
-    // and set the "new graph" variable
-    tryToLoadLevelDb(LEVEL_ONE, false);
-}
-MainWindowEditMode::~MainWindowEditMode()
-{
-    delete ui;
-    delete txtEditorWidget;
-    delete GLDiagramWidget;
-    delete txtHighlighter;
-    delete codeEditorWidget;
-}
-
-// This method is called by the openGL widget every time the selection is changed on the graph
-void *MainWindowEditMode::GLWidgetNotifySelectionChanged(void *m_newSelection)
-{
-    // First save the right/left pane data for the old selected element
-    if(!m_lastSelectedHasBeenDeleted)
-    {
-        qWarning() << "GLWidgetNotifySelectionChanged.saveEverythingOnThePanesToMemory()";
-        saveEverythingOnThePanesToMemory();
-    }
-
-    if(m_swapRunning)
-    {
-        // There's a swap running, swap the selected element with the new selected element
-        GLDiagramWidget->m_swapInProgress = true;
-
-        dbDataStructure *m_newSelectedElement;
-        // Select our new element
-        long m_newSelectionIndex = -1;
-        long m_selectedElementIndex = -1;
-        int foundBoth = 0;
-        for(int i=0; i<m_currentGraphElements.size(); i++)
-        {
-            if(foundBoth == 2)
-                break;
-
-            if(m_currentGraphElements[i]->glPointer == m_newSelection)
-            {
-                m_newSelectedElement = m_currentGraphElements[i];
-                m_newSelectionIndex = i;
-                foundBoth++;
-            }
-            if(m_currentGraphElements[i]->glPointer == m_selectedElement->glPointer)
-            {
-                m_selectedElementIndex = i;
-                foundBoth++;
-            }
-        }
-
-        // Swap these two structure's data
-        QByteArray m_temp = m_newSelectedElement->data;
-        m_newSelectedElement->data = m_selectedElement->data;
-        m_selectedElement->data = m_temp;
-
-        QString m_temp2 = m_newSelectedElement->fileName;
-        m_newSelectedElement->fileName = m_selectedElement->fileName;
-        m_selectedElement->fileName = m_temp2;
-
-        m_temp2 = m_newSelectedElement->label;
-        m_newSelectedElement->label = m_selectedElement->label;
-        m_selectedElement->label = m_temp2;
-
-        long m_temp3 = m_newSelectedElement->userIndex;
-        m_newSelectedElement->userIndex = m_selectedElement->userIndex;
-        m_selectedElement->userIndex = m_temp3;
-
-        m_temp = m_newSelectedElement->firstLineData;
-        m_newSelectedElement->firstLineData = m_selectedElement->firstLineData;
-        m_selectedElement->firstLineData = m_temp;
-
-        QVector<quint32> m_temp4 = m_newSelectedElement->linesNumbers;
-        m_newSelectedElement->linesNumbers = m_selectedElement->linesNumbers;
-        m_selectedElement->linesNumbers = m_temp4;
-
-
-        // Avoid a recursive this-method recalling when selected element changes: set swapInProgress and avoid repainting
-
-        GLDiagramWidget->clearGraphData();
-        updateGLGraph();
-        // Data insertion ended, calculate elements displacement and start drawing data
-        GLDiagramWidget->calculateDisplacement();
-
-        GLDiagramWidget->m_swapInProgress = false;
-    }
-    else
-    {
-        // Select our new element
-        for(int i=0; i<m_currentGraphElements.size(); i++)
-        {
-            if(m_currentGraphElements[i]->glPointer == m_newSelection)
-            {
-                m_selectedElement = m_currentGraphElements[i];
-                break;
-            }
-        }
-    }
-
-    qWarning() << "New element selected: " + m_selectedElement->label;
-
-    // Load the selected element data in the panes, but first clear them
-    qWarning() << "GLWidgetNotifySelectionChanged.clearAllPanes() and loadSelectedElementDataInPanes()";
-    clearAllPanes();
-    loadSelectedElementDataInPanes();
-
-    if(m_swapRunning)
-    {
-        m_swapRunning = false;
-        ui->swapBtn->toggle();
-
-        // Return to the painting widget the new element to be selected (data has been modified)
-        return m_selectedElement->glPointer;
-    }
-    else
-        return NULL;
-}
-
-
-
-
-void MainWindowEditMode::on_goToNextLevel_clicked()
-{
-    // If there's no root, just deny it
-    if(m_firstTimeGraphInCurrentLevel || m_selectedElement == NULL)
-    {
-        QMessageBox::warning(this, "Zoom Error", "Cannot raise the zoom level if there's no element selected in the current graph");
-        return;
-    }
-
-    // We can't go further if we're on level three
-    if(m_currentActiveLevel == LEVEL_THREE)
-    {
-        QMessageBox::warning(this, "Zoom Error", "The maximum zoom level has already been reached");
-        return;
-    }
-
-    //////////////////////////////////////
-    //  Go to next level
-    //////////////////////////////////////
-
-    // 1) Save all panes and data to disk
-    saveEverythingOnThePanesToMemory();
-    saveCurrentLevelDb();
-
-    // 2) Save our current selected element's level and unique index
-    switch(m_currentActiveLevel)
-    {
-        case LEVEL_ONE:
-        {
-            // We just have to save this ID
-            m_currentLevelOneID = m_selectedElement->uniqueID;
-
-        }break;
-        case LEVEL_TWO:
-        {
-            // We already have one ID saved, the m_currentLevelOneID, save the other one
-            m_currentLevelTwoID = m_selectedElement->uniqueID;
-
-        }break;
-    }
-
-    // 3) Either if we were on level 1 or level 2 before, now we have to show the left pane, and clear the right pane too
-    this->ui->containerWidget->show();
-    txtEditorWidget->m_textEditorWin->clear();
-    codeEditorWidget->clearAllCodeHighlights();
-    this->ui->spinBox->setValue(0);
-    this->ui->txtLabel->setText("Block");
-
-    // 4) Check if the new appropriate file exists
-    QString m_nextDbFile;
-    switch(m_currentActiveLevel)
-    {
-        case LEVEL_ONE:
-        {
-
-            m_nextDbFile = QString(GDS_DIR) + "/level2_" + QString("%1").arg(m_currentLevelOneID) + ".gds";
-            m_currentActiveLevel = LEVEL_TWO;
-
-        }break;
-        case LEVEL_TWO:
-        {
-            m_nextDbFile = QString(GDS_DIR) + "/level3_" + QString("%1").arg(m_currentLevelOneID) + "_" +
-                    QString("%1").arg(m_currentLevelTwoID) + ".gds";
-            m_currentActiveLevel = LEVEL_THREE;
-
-        }break;
-    }
-
-    // 5) If the file doesn't exist: new graph, otherwise: load the data
-    if(!QFile(m_nextDbFile).exists())
-    {
-        // No file detected, new graph needed at this level
-        qWarning() << m_nextDbFile << " not detected, creating a new graph..";
-
-        // Clear all graph data and free memory
-        GLDiagramWidget->clearGraphData();
-        freeCurrentGraphElements();
-        // Also de-load the code file we've been using
-        codeEditorWidget->clear();
-        m_firstTimeGraphInCurrentLevel = true;
-    }
-    else
-    {
-        qWarning() << m_nextDbFile << " DETECTED, loading data..";
-
-        // File detected, load its data and display it
-        GLDiagramWidget->clearGraphData();
-        freeCurrentGraphElements();
-        tryToLoadLevelDb(m_currentActiveLevel, false);
-    }
-
-    // 6) Update navigation buttons and label
-    switch(m_currentActiveLevel)
-    {
-        // Warning: no level one since the "nextlevel" button can only take us to two or three..
-        case LEVEL_TWO:
-        {
-           ui->goToPreviousLevel->setEnabled(true);
-           ui->goToNextLevel->setEnabled(true);
-           ui->currentLevelLabel->setText("Currently in level 2 - A user with some technical skills should be able to understand this");
-
-        }break;
-
-        case LEVEL_THREE:
-        {
-           ui->goToPreviousLevel->setEnabled(true);
-           ui->goToNextLevel->setEnabled(false);
-           ui->currentLevelLabel->setText("Currently in level 3 - Programmers should be able to understand this");
-
-        }break;
-    }
-}
-void MainWindowEditMode::on_goToPreviousLevel_clicked()
-{
-    // We can't go back if we're on level one
-    if(m_currentActiveLevel == LEVEL_ONE)
-    {
-        QMessageBox::warning(this, "Zoom Error", "The minimum zoom level has already been reached");
-        return;
-    }
-
-    //////////////////////////////////////
-    //  Go to previous level
-    //////////////////////////////////////
-
-    // 1) Save all panes and data to disk if this graph isn't empty
-    saveEverythingOnThePanesToMemory();
-    saveCurrentLevelDb();
-
-    // 2) Show the left pane if we have to, and clear the right/left pane too
-    if(m_currentActiveLevel == LEVEL_TWO) // if we're returning to level one hide the left pane
-        this->ui->containerWidget->hide();
-    txtEditorWidget->m_textEditorWin->clear();
-    codeEditorWidget->clearAllCodeHighlights();
-    this->ui->spinBox->setValue(0);
-    this->ui->txtLabel->setText("Block");
-
-    // 3) Check if the new appropriate file exists, otherwise CRITICAL ERROR - BROKEN DOCUMENTATION - try to recreate another one
-    QString m_previousDbFile;
-    switch(m_currentActiveLevel)
-    {
-        case LEVEL_THREE:
-        {
-
-            m_previousDbFile = QString(GDS_DIR) + "/level2_" + QString("%1").arg(m_currentLevelOneID) + ".gds";
-            m_currentActiveLevel = LEVEL_TWO;
-
-        }break;
-        case LEVEL_TWO:
-        {
-            m_previousDbFile = QString(GDS_DIR) + "/level1_general.gds";
-            m_currentActiveLevel = LEVEL_ONE;
-        }break;
-    }
-
-    // 4) If the file doesn't exist: new graph, otherwise: load the data
-    if(!QFile(m_previousDbFile).exists())
-    {
-        // No file detected, new graph needed at this level
-        qWarning() << m_previousDbFile << "BROKEN DOCUMENTATION - FILE not detected, creating a new graph..";
-
-        // Clear all graph data and free memory
-        GLDiagramWidget->clearGraphData();
-        freeCurrentGraphElements();
-        m_firstTimeGraphInCurrentLevel = true;
-    }
-    else
-    {
-        qWarning() << m_previousDbFile << "previous file DETECTED, loading data..";
-
-        // File detected, load its data and display it
-        GLDiagramWidget->clearGraphData();
-        freeCurrentGraphElements();
-        tryToLoadLevelDb(m_currentActiveLevel, true);
-    }
-
-    // 6) Update navigation buttons and label
-    switch(m_currentActiveLevel)
-    {
-        // Warning: no level three since the "previouslevel" button can only take us to two or one..
-        case LEVEL_TWO:
-        {
-           ui->goToPreviousLevel->setEnabled(true);
-           ui->goToNextLevel->setEnabled(true);
-           ui->currentLevelLabel->setText("Currently in level 2 - A user with some technical skills should be able to understand this");
-
-        }break;
-
-        case LEVEL_ONE:
-        {
-           ui->goToPreviousLevel->setEnabled(false);
-           ui->goToNextLevel->setEnabled(true);
-           ui->currentLevelLabel->setText("Currently in level 1 - Everyone should be able to understand this");
-
-        }break;
-    }
-
-}
-
-
-// This method is called by the openGL widget when it's ready to draw and if there's a scheduled painting pending
-void MainWindowEditMode::deferredPaintNow()
-{
-    // Sets the swapping value to prevent screen flickering (it disables repaint events)
-    bool oldValue = GLDiagramWidget->m_swapInProgress;
-    GLDiagramWidget->m_swapInProgress = true;
-
-    GLDiagramWidget->clearGraphData();
-    updateGLGraph();
-    // Data insertion ended, calculate elements displacement and start drawing data
-    GLDiagramWidget->calculateDisplacement();
-
-    // Restore the swapping value to its previous
-    GLDiagramWidget->m_swapInProgress = oldValue;
-    GLDiagramWidget->changeSelectedElement(m_selectedElement->glPointer);
-
-    // We selected an element for the first time (the graph has been loaded), we need to recharge this item's data
-    // Load the selected element data in the panes
-    loadSelectedElementDataInPanes();
-}
-
-
-void MainWindowEditMode::enterPressedOnLabelEditBox()
-{
-    // Update this node's label and redraw it
-    if(m_selectedElement == NULL || m_currentGraphElements.size() == 0)
-        return;
-
-    m_selectedElement->label = ui->txtLabel->text();
-
-    // Sets the swapping value to prevent screen flickering (it disables repaint events)
-    bool oldValue = GLDiagramWidget->m_swapInProgress;
-    GLDiagramWidget->m_swapInProgress = true;
-
-    GLDiagramWidget->clearGraphData();
-    updateGLGraph();
-    // Data insertion ended, calculate elements displacement and start drawing data
-    GLDiagramWidget->calculateDisplacement();
-
-    // Restore the swapping value to its previous
-    GLDiagramWidget->m_swapInProgress = oldValue;
-    GLDiagramWidget->changeSelectedElement(m_selectedElement->glPointer);
-}
-
-// This happens when the spinbox loses focus or enter is pressed
-void MainWindowEditMode::on_spinBox_editingFinished()
-{
-    // Just update the selected element's data
-    if(m_selectedElement == NULL || m_currentGraphElements.size() == 0 || QString(ui->spinBox->value()) == "")
-        return;
-
-    m_selectedElement->userIndex = ui->spinBox->value();
-}
-
-
-// Update the openGL graph widget (the graph has changed)
-void MainWindowEditMode::updateGLGraph()
-{
-    void *temp;
-    for(int i=0; i<m_currentGraphElements.size(); i++)
-    {
-        if(m_currentGraphElements[i]->father == NULL)
-        {
-            // Root
-            temp = GLDiagramWidget->insertTreeData(m_currentGraphElements[i]->label, NULL);
-            m_currentGraphElements[i]->glPointer = temp;
-        }
-        else
-        {
-            temp = GLDiagramWidget->insertTreeData(m_currentGraphElements[i]->label, m_currentGraphElements[i]->father->glPointer);
-            m_currentGraphElements[i]->glPointer = temp;
-        }
-    }
-}
-
-
-// Delete current selected element and ask for total elimination (all children too) or partial elimination
-void MainWindowEditMode::on_deleteSelectedElementBtn_clicked()
-{
-    // If there are no elements, exit
-    if(m_currentGraphElements.size() == 0)
-        return;
-
-    // Does the user want to delete the root?
-    if(m_selectedElement->father == NULL)
-    {
-        // Damn, he wants to delete the root... we can't allow that without destroying the entire graph
-        QMessageBox::StandardButton reply;
-        reply = QMessageBox::question(this, tr("Deletion confirmation"),
-                                      "Deleting the root element will cause the entire graph to be lost, do you want to continue?",
-                                      QMessageBox::Yes | QMessageBox::No);
-        if (reply == QMessageBox::No)
-            return;
-        qWarning() << "ROOT DESTROYING AND EVERYTHING RELATED";
-        // Destroy EVERYTHING
-        for(int i=0; i<m_currentGraphElements.size(); i++)
-        {
-            delete m_currentGraphElements[i];
-        }
-        m_currentGraphElements.clear();
-
-        m_firstTimeGraphInCurrentLevel = true;
-        m_selectedElement = NULL;
-    }
-    else
-    {
-
-        // Check if the selected element has children
-        if(m_selectedElement->nextItems.size() == 0)
-        {
-            // No children, total elimination
-            qWarning() << "no children, total elimination";
-            QMessageBox::StandardButton reply;
-            reply = QMessageBox::question(this, tr("Deletion confirmation"),
-                                          "Do you really want to delete this element?",
-                                          QMessageBox::Yes | QMessageBox::No);
-            if (reply == QMessageBox::No)
-                return;
-
-            // Save its father (we'll select this after the deletion)
-            dbDataStructure *m_father = m_selectedElement->father;
-            //qWarning() << "father has data: " << QString(m_father->data);
-
-            // Delete the node from the global vector and from the father's children (if not NULL, maybe this selected is the root)
-            int index = -1;
-            for(int i=0; i<m_currentGraphElements.size(); i++)
-            {
-                if(m_currentGraphElements[i] == m_selectedElement)
-                {
-                    index = i;
-                    break;
-                }
-            }
-            m_currentGraphElements.remove(index);
-
-            if(m_father != NULL)
-            {
-                for(int i=0; i<m_father->nextItems.size(); i++)
-                {
-                    if(m_father->nextItems[i] == m_selectedElement)
-                    {
-                        index = i;
-                        break;
-                    }
-                }
-                m_father->nextItems.remove(index);
-            }
-            delete m_selectedElement; // Free memory
-
-            // This prevents messing with the data of the precedent selection
-            m_lastSelectedHasBeenDeleted = true;
-
-            // Select the father
-            m_selectedElement = m_father;
-        }
-        else
-        {
-            // It has children, ask for total or partial elimination
-
-            QMessageBox::StandardButton reply;
-            reply = QMessageBox::question(this, tr("Deletion confirmation"),
-                                          "Do you want to delete this element's children as well?\r\nChoose Cancel to abort the deletion",
-                                          QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
-
-            if (reply == QMessageBox::Cancel)
-                return;
-
-            if (reply == QMessageBox::Yes)
-            {
-                // Total deletion (children included)
-                qWarning() << "Deletion WITH children";
-                // Save its father (we'll select this after the deletion)
-                dbDataStructure *m_father = m_selectedElement->father;
-                //qWarning() << "father has data: " << QString(m_father->data);
-
-                // Delete this child from its father's children
-                int index = -1;
-                for(int i=0; i<m_father->nextItems.size(); i++)
-                {
-                    if(m_father->nextItems[i] == m_selectedElement)
-                    {
-                        index = i;
-                        break;
-                    }
-                }
-                m_father->nextItems.remove(index);
-
-                // Delete the node and all its children
-                recursiveDelete(m_selectedElement);
-
-                // This prevents messing with the data of the precedent selection
-                m_lastSelectedHasBeenDeleted = true;
-
-                // Select the father
-                m_selectedElement = m_father;
-            }
-            else
-            {
-                // Delete the element but preserve the children
-
-                // Save its father (we'll select this after the deletion)
-                dbDataStructure *m_father = m_selectedElement->father;
-                qWarning() << "Deletion WITHOUT children";
-                //qWarning() << "father has data: " << QString(m_father->data);
-                // Delete this child from its father's children
-                int index = -1;
-                for(int i=0; i<m_father->nextItems.size(); i++)
-                {
-                    if(m_father->nextItems[i] == m_selectedElement)
-                    {
-                        index = i;
-                        break;
-                    }
-                }
-                m_father->nextItems.remove(index);
-
-                // Set the new children's father
-                for(int i=0; i<m_selectedElement->nextItems.size(); i++)
-                {
-                    m_selectedElement->nextItems[i]->father = m_father;
-                }
-                // Set the new father's children
-                for(int i=0; i<m_selectedElement->nextItems.size(); i++)
-                {
-                    m_father->nextItems.append(m_selectedElement->nextItems[i]);
-                }
-
-                for(int i=0; i<m_currentGraphElements.size(); i++)
-                {
-                    if(m_currentGraphElements[i] == m_selectedElement)
-                    {
-                        index = i;
-                        break;
-                    }
-                }
-                m_currentGraphElements.remove(index);
-                delete m_selectedElement; // Free memory
-
-                // This prevents messing with the data of the precedent selection
-                m_lastSelectedHasBeenDeleted = true;
-
-                // Select the father
-                m_selectedElement = m_father;
-            }
-
-        }
-    }
-
-
-    // Redraw
-    GLDiagramWidget->clearGraphData();
-    updateGLGraph();
-
-    // Nothing to calculate if there are no elements
-    if(m_currentGraphElements.size() > 0)
-    {
-        // Data insertion ended, calculate elements displacement and start drawing data
-        GLDiagramWidget->calculateDisplacement();
-        // Select our selected element (if not NULL)
-        if(m_selectedElement != NULL)
-        {
-            GLDiagramWidget->changeSelectedElement(m_selectedElement->glPointer);
-
-            // Load its data
-            loadSelectedElementDataInPanes();
-        }
-    }
-}
-void MainWindowEditMode::recursiveDelete(dbDataStructure* element)
-{
-    for(int i=0; i<element->nextItems.size(); i++)
-    {
-        recursiveDelete(element->nextItems[i]);
-    }
-
-    int index = -1;
-    for(int i=0; i<m_currentGraphElements.size(); i++)
-    {
-        if(m_currentGraphElements[i] == element)
-        {
-            index = i;
-            break;
-        }
-    }
-    m_currentGraphElements.remove(index);
-    delete element; // Free memory
-}
-
-void MainWindowEditMode::on_addChildBlockBtn_clicked()
-{
-    // If first time, create the root element and store it into the db
-    if(m_firstTimeGraphInCurrentLevel)
-    {
-        // Create a root for the current graph
-
-        // Level one and no graph, create the root
-        dbDataStructure *rootElement = new dbDataStructure();
-        rootElement->depth = 0;
-        rootElement->userIndex = ui->spinBox->text().toLong();
-
-        if(ui->txtLabel->text().isEmpty())
-        {
-            rootElement->label = "Block";
-            ui->txtLabel->setText("Block");
-        }
-        else
-            rootElement->label = ui->txtLabel->text();
-
-        rootElement->father = NULL; // root has no father
-
-        rootElement->uniqueID = getThisGraphNextFreeID();
-
-        // If there's data on the right pane, store it with us
-        if(!txtEditorWidget->m_textEditorWin->document()->isEmpty())
-        {
-            rootElement->data.clear();
-            rootElement->data.append(txtEditorWidget->m_textEditorWin->toHtml());
-        }
-        // If there's code on the left pane, store it with us
-        if(!codeEditorWidget->document()->isEmpty())
-        {
-            rootElement->fileName.clear();
-            rootElement->fileName.append(ui->fileComboBox->currentText());
-        }
-
-        // -----------------------------------------------------
-
-        // Add it to the element list
-        m_currentGraphElements.append(rootElement);
-
-        // Select this
-        m_selectedElement = rootElement;
-
-        GLDiagramWidget->clearGraphData();
-        updateGLGraph();
-        // Data insertion ended, calculate elements displacement and start drawing data
-        GLDiagramWidget->calculateDisplacement();
-        // Select our selected element
-        GLDiagramWidget->changeSelectedElement(m_selectedElement->glPointer);
-
-        m_firstTimeGraphInCurrentLevel = false; // We added an element
-
-        saveEverythingOnThePanesToMemory(); // This saves the code lines highlighted
-    }
-    else
-    {
-        // Create another element every level
-
-        // Level one, create another element child of the one selected
-        dbDataStructure *newElement = new dbDataStructure();
-        newElement->depth = m_selectedElement->depth + 1;
-        // Increment the spinbox value
-        ui->spinBox->setValue(ui->spinBox->value()+1);
-        newElement->userIndex = ui->spinBox->text().toLong();
-
-        // Set new element's father and add it to the selected element's children
-        newElement->father = m_selectedElement;
-        m_selectedElement->nextItems.append(newElement);
-
-        // Assign a new unique ID for this graph
-        newElement->uniqueID = getThisGraphNextFreeID();
-
-        // Save everything for the old element
-        saveEverythingOnThePanesToMemory();
-
-        // Set the label text to "Block" as default
-        newElement->label = "Block";
-        ui->txtLabel->setText("Block");
-        // And clear the text of the new block
-        newElement->data.clear();
-        txtEditorWidget->m_textEditorWin->clear();
-
-        // And then clear the highlights on the code file (the code file might remain the same, just to speed things up)
-        if(m_currentActiveLevel != LEVEL_ONE)
-        {
-            codeEditorWidget->clearAllCodeHighlights();
-            // Obviously if the code remains the same, we need to set it on our child :)
-            newElement->fileName.clear();
-            newElement->fileName.append(m_selectedElement->fileName);
-        }
-
-
-        // -----------------------------------------------------
-
-        // Add it to the element list
-        m_currentGraphElements.append(newElement);
-
-        // Select this
-        m_selectedElement = newElement;
-
-        GLDiagramWidget->clearGraphData();
-        updateGLGraph();
-        // Data insertion ended, calculate elements displacement and start drawing data
-        GLDiagramWidget->calculateDisplacement();
-        // Select our selected element
-        GLDiagramWidget->changeSelectedElement(m_selectedElement->glPointer);
-    }
-}
-
-// Swap an element with another one, this handles just the button
-void MainWindowEditMode::on_swapBtn_clicked()
-{
-    if(m_selectedElement == NULL)
-    {
-        // Nothing to swap
-        if(ui->swapBtn->isChecked())
-            ui->swapBtn->toggle();
-        return;
-    }
-
-    // Signal that the selected element has been selected for swap
-    m_swapRunning = true;
-}
-
-void MainWindowEditMode::closeEvent(QCloseEvent *)
-{
-    // Save the last selected element's data
-    saveEverythingOnThePanesToMemory();
-    // Finally save to disk
-    saveCurrentLevelDb();
-    exit(1);
-}
-
-void MainWindowEditMode::on_browseCodeFiles_clicked()
-{
-    // Search for a new code file and store just the relative position from this app's directory
-
-    QString fn = QFileDialog::getOpenFileName(this, tr("Open C/C++ code file..."),
-                                              QString(), tr("C/C++ Files (*.cpp *.c *.h)"));
-    if (fn.isEmpty() || !QFile::exists(fn))
-        // Nothing to load
-        return;
-
-    // If there's no element don't allow the file to be loaded
-    if(m_currentGraphElements.count() == 0 || m_selectedElement == NULL)
-    {
-        QMessageBox::warning(this, "Error associating code file", "An element is needed before associating a code file");
-        return;
-    }
-
-    QFile file(fn);
-    if (!file.open(QFile::ReadOnly | QFile::Text))
-        return;
-
-    // 1) Read the entire file and display it into the code window
-    QByteArray data = file.readAll();
-
-    if(m_selectedElement != NULL && m_currentGraphElements.size() > 0)
-    {
-        // First clear all the highlighted data
-        codeEditorWidget->document()->setPlainText("");
-        codeEditorWidget->m_selectedLines.clear();
-
-        // This time we need to clear this element's data too
-        m_selectedElement->linesNumbers.clear();
-        m_selectedElement->firstLineData.clear();
-    }
-
-    codeEditorWidget->setPlainText(QString(data));
-
-    // 2) Add its RELATIVE path to the combo box
-    if(m_recentFilePaths.size() >= 15)
-    {
-        // Remove the less recent one
-        m_recentFilePaths.remove(0);
-    }
-
-    QFileInfo info(file);
-    QString finalRelativePath = convertToRelativePath(info.absoluteFilePath());
-    // Also add the filename to the current element's
-    m_selectedElement->fileName.clear();
-    m_selectedElement->fileName.append(finalRelativePath);
-
-    // and finally add this path to the combobox and the vector (if it's not already there)
-    if(!m_recentFilePaths.contains(finalRelativePath))
-    {
-        m_recentFilePaths.append(finalRelativePath);
-        // Update combobox
-        ui->fileComboBox->clear();
-        for(int i=0;i<m_recentFilePaths.size();i++)
-            ui->fileComboBox->addItem(m_recentFilePaths[i]);
-
-        ui->fileComboBox->setCurrentIndex(ui->fileComboBox->count()-1);
-    }
-    else
-    {
-        int index = m_recentFilePaths.indexOf(finalRelativePath);
-        ui->fileComboBox->setCurrentIndex(index);
-    }
-
-    file.close();
-}
-
-// Combo box was pressed
-void MainWindowEditMode::on_fileComboBox_activated(const QString &arg1)
-{
-    if(m_selectedElement == NULL || m_currentGraphElements.size() == 0)
-        return;
-
-    QString absoluteNewPath = convertToAbsolutePath(arg1);
-    if (!QFile::exists(absoluteNewPath))
-        // Nothing to load
-        return;
-
-    // First clear all the highlighted data if there was an open document on
-    if(!codeEditorWidget->document()->isEmpty())
-    {
-        codeEditorWidget->document()->setPlainText("");
-        codeEditorWidget->m_selectedLines.clear();
-    }
-
-    // This time we need to clear this element's data too
-    m_selectedElement->linesNumbers.clear();
-    m_selectedElement->firstLineData.clear();
-
-    // Load the new code file
-    QFile file(absoluteNewPath);
-
-    if (!file.open(QFile::ReadOnly | QFile::Text))
-        return;
-
-    // Read the entire file and display it into the code window
-    QByteArray data = file.readAll();
-
-    codeEditorWidget->setPlainText(QString(data));
-    m_selectedElement->fileName.clear();
-    m_selectedElement->fileName.append(arg1);
-    qWarning() << "on_fileComboBox_activated() - filename set to: "+arg1;
-
-    file.close();
-
-    // Update the panes data, this will also update the filename of our selectedElement
-    saveEverythingOnThePanesToMemory();
-}
-
-
-// Sometimes we don't want a code file associated, clear the codeview and save to ram
-void MainWindowEditMode::on_clearCodeFileBtn_clicked()
-{
-
-
-    codeEditorWidget->document()->setPlainText("");
-    codeEditorWidget->m_selectedLines.clear();
-
-    m_selectedElement->fileName.clear();
-    m_selectedElement->linesNumbers.clear();
-    m_selectedElement->firstLineData.clear();
-
-
-}
-
-
-
-
-
-
-
-
-
-
-//////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////////////////////
-//                  SYSTEM SERVICE ROUTINES - SAVE/LOAD/GENERIC FUNCTIONS                   //
-//////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////////////////////
-
-
-
-quint64 MainWindowEditMode::getThisGraphNextFreeID()
-{
-    if(m_currentGraphElements.size() == 0) // Root
-        return 0;
-
-    // Get this graph's next free ID by searching for a uniqueID free value
-    QVector<quint32> m_takenIDs;
-    for(int i=0; i<m_currentGraphElements.size(); i++)
-        m_takenIDs.append(m_currentGraphElements[i]->uniqueID);
-
-    // Search for the next available ID
-    quint64 m_newId = 0;
-    for(;;)
-    {
-        if(!m_takenIDs.contains(m_newId))
-        {
-            // Found a new ID!
-            break;
-        }
-        else
-        {
-            m_newId++;
-        }
-    }
-    return m_newId;
-}
-
-QString MainWindowEditMode::convertToRelativePath(QString fileAbsolutePath)
-{
-    // Get current app absolute path
-    QString myAbsolutePath = QApplication::applicationFilePath();
-
-    // Convert into relative file path from this directory
-    QStringList myPaths = myAbsolutePath.split(QRegExp("/"), QString::SkipEmptyParts);
-    QStringList filePaths = fileAbsolutePath.split(QRegExp("/"), QString::SkipEmptyParts);
-
-    // Delete the application name
-    myPaths.removeLast();
-
-    // if the file is on another drive, just take the entire path
-    if(filePaths[0] != myPaths[0])
-    {
-        // Different drive
-        return fileAbsolutePath;
-    }
-    else
-    {
-        // For each common path, delete this item
-        do
-        {
-            if(myPaths.size() < 1 || filePaths.size() < 1)
-                break;
-            if(myPaths[0] == filePaths[0])
-            {
-                myPaths.removeFirst();
-                filePaths.removeFirst();
-            }
-            else
-                break;
-        }while(1);
-        // Substitute every not-common part of myPaths with ..
-        if(myPaths.size() > 0)
-        {
-            for(int i=0; i<myPaths.size(); i++)
-                myPaths.replace(i, "..");
-        }
-        // Add every non-common part of filePaths and we're done
-        for(int i=0; i<filePaths.size(); i++)
-            myPaths.append(filePaths[i]);
-
-        // Restore the "/" separators
-        return myPaths.join("/");
-    }
-}
-
-QString MainWindowEditMode::convertToAbsolutePath(QString relativePath)
-{
-    // Split the file relative path
-    QStringList filePaths = relativePath.split(QRegExp("/"), QString::SkipEmptyParts);
-
-    // Get current app absolute path and split it
-    QString myAbsolutePath = QApplication::applicationFilePath();
-    QStringList myPaths = myAbsolutePath.split(QRegExp("/"), QString::SkipEmptyParts);
-
-    // Delete the application name
-    myPaths.removeLast();
-
-    do
-    {
-        // Sanity check
-        if(myPaths.size() < filePaths.count(".."))
-            return "";
-
-        if(filePaths[0] == "..")
-        {
-            myPaths.removeLast();
-            filePaths.removeFirst();
-        }
-        else
-            break;
-    }while(1);
-
-    // Append the rest and rejoin
-    for(int i=0; i<filePaths.size(); i++)
-        myPaths.append(filePaths[i]);
-
-    // Restore the "/" separators
-    return myPaths.join("/");
-}
-
-
-// Saves all consistent data serializing the tree
-void MainWindowEditMode::saveCurrentLevelDb()
-{
-    qWarning() << "saveCurrentLevelDb -> saving memory to disk";
-
-    // If the graph is new and there's no data, save nothing
-    if(m_firstTimeGraphInCurrentLevel)
-    {
-        // Save "nothing" means that we need to check that a previous file (maybe because the root was deleted)
-        // is no more present
-        QString delFile;
-        switch(m_currentActiveLevel)
-        {
-            case LEVEL_ONE:
-            {
-                // "level1_general.gds" file
-                delFile = QString(GDS_DIR) + "/level1_general.gds";
-            }break;
-            case LEVEL_TWO:
-            {
-                // "level2_X1.gds" file
-                delFile =  QString(GDS_DIR) + "/level2_" + QString("%1").arg(m_currentLevelOneID) + ".gds";
-            }break;
-            case LEVEL_THREE:
-            {
-                // "level3_X1_X2.gds" file
-                delFile =  QString(GDS_DIR) + "/level3_" + QString("%1").arg(m_currentLevelOneID) + "_" +
-                        QString("%1").arg(m_currentLevelTwoID) + ".gds";
-            }break;
-        };
-        if(QFile::exists(delFile))
-        {
-            // Delete it
-            if(!QFile::remove(delFile))
-            {
-                QMessageBox::warning(this, "Error deleting database file", "The file \r\n"+delFile+"\r\n is in use, thus cannot be deleted. Documentation might be corrupted.");
-            }
-        }
-
-
-        return;
-    }
-
-    // This function takes care of converting all memory pointers into
-    // QVector<dbDataStructure*> m_currentGraphElements indices
-    convertDbDataToStorableData(true);
-
-    // Write out the number of elements and all the data structures on the level-specific file
-    switch(m_currentActiveLevel)
-    {
-        case LEVEL_ONE:
-        {
-            // "level1_general.gds" file
-
-            // Serialize our current data
-            QFile file(QString(GDS_DIR) + "/level1_general.gds");
-            file.open(QFile::WriteOnly);
-
-            // Thanks to our << and >> overloads, this will serialize just what we need
-            QDataStream out(&file);
-
-            // Write out the number of elements and all the data structures
-            out << m_currentGraphElements.size();
-            for(int i=0; i<m_currentGraphElements.size(); i++)
-            {
-                out << *(m_currentGraphElements[i]); // Remember that these are pointers, they need to be dereferenced
-            }
-
-            file.close();
-
-        }break;
-
-        case LEVEL_TWO:
-        {
-            // "level2_X1.gds" file
-            QString m_dbFile = QString(GDS_DIR) + "/level2_" + QString("%1").arg(m_currentLevelOneID) + ".gds";
-
-            // Serialize our current data
-            QFile file(m_dbFile);
-            file.open(QFile::WriteOnly);
-
-            // Thanks to our << and >> overloads, this will serialize just what we need
-            QDataStream out(&file);
-
-            // Write out the number of elements and all the data structures
-            out << m_currentGraphElements.size();
-            for(int i=0; i<m_currentGraphElements.size(); i++)
-            {
-                out << *(m_currentGraphElements[i]); // Remember that these are pointers, they need to be dereferenced
-            }
-
-            file.close();
-
-        }break;
-
-        case LEVEL_THREE:
-        {
-            // "level3_X1_X2.gds" file
-            QString m_dbFile = QString(GDS_DIR) + "/level3_" + QString("%1").arg(m_currentLevelOneID) + "_" +
-                    QString("%1").arg(m_currentLevelTwoID) + ".gds";
-
-            // Serialize our current data
-            QFile file(m_dbFile);
-            file.open(QFile::WriteOnly);
-
-            // Thanks to our << and >> overloads, this will serialize just what we need
-            QDataStream out(&file);
-
-            // Write out the number of elements and all the data structures
-            out << m_currentGraphElements.size();
-            for(int i=0; i<m_currentGraphElements.size(); i++)
-            {
-                out << *(m_currentGraphElements[i]); // Remember that these are pointers, they need to be dereferenced
-            }
-
-            file.close();
-        }break;
-    }
-}
-
-// This function takes care of converting and marshalling all memory pointers of
-// QVector<dbDataStructure*> m_currentGraphElements into QVector<quint32> nextItemsIndices indices
-// to store on disk
-void MainWindowEditMode::convertDbDataToStorableData(bool m_towardsDiskFile)
-{
-    if(m_towardsDiskFile)
-    {
-        for(int i=0; i<m_currentGraphElements.size(); i++)
-        {
-            // Convert all children
-            m_currentGraphElements[i]->nextItemsIndices.clear();
-            for(int j=0; j<m_currentGraphElements[i]->nextItems.size(); j++)
-            {
-                m_currentGraphElements[i]->nextItemsIndices.append(
-                            m_currentGraphElements.indexOf(m_currentGraphElements[i]->nextItems[j]) );
-            }
-            // Convert the father
-            if(m_currentGraphElements[i]->father == NULL)
-            {
-                // Set this element as root - no father
-                m_currentGraphElements[i]->fatherIndex = 0; // Just to put a placeholder value
-                m_currentGraphElements[i]->noFatherRoot = true;
-            }
-            else
-            {
-                m_currentGraphElements[i]->noFatherRoot = false;
-                m_currentGraphElements[i]->fatherIndex = m_currentGraphElements.indexOf(m_currentGraphElements[i]->father);
-            }
-        }
-    }
-    else
-    {
-        for(int i=0; i<m_currentGraphElements.size(); i++)
-        {
-            // De-convert all children
-            m_currentGraphElements[i]->nextItems.clear();
-            for(int j=0; j<m_currentGraphElements[i]->nextItemsIndices.size(); j++)
-            {
-                m_currentGraphElements[i]->nextItems.append(
-                            m_currentGraphElements[m_currentGraphElements[i]->nextItemsIndices[j]] );
-            }
-            // Convert the father (root hasn't one)
-            if(m_currentGraphElements[i]->fatherIndex == 0 && m_currentGraphElements[i]->noFatherRoot == true)
-                m_currentGraphElements[i]->father = NULL;
-            else
-                m_currentGraphElements[i]->father = m_currentGraphElements[m_currentGraphElements[i]->fatherIndex];
-        }
-    }
-
-    // Data is ready to be stored (NOT TO BE DRAWN) or drawn
-}
-
-// Restore all panes to their default values
-void MainWindowEditMode::clearAllPanes()
-{
-    codeEditorWidget->setPlainText("");
-    codeEditorWidget->m_selectedLines.clear();
-    txtEditorWidget->m_textEditorWin->clear();
-    ui->spinBox->setValue(0);
-    ui->txtLabel->setText("Block");
-}
-
-// NOTICE: this doesn't store anything on disk, just stores everything on the currently selected element
-void MainWindowEditMode::saveEverythingOnThePanesToMemory()
-{
-    qWarning() << "saveEverythingOnThePanesToMemory <- saving all panes in selected element";
-
-    // We can't save anything if there's no element
-    if(m_currentGraphElements.size() > 0 && m_selectedElement != NULL)
-    {
-        // If there's data on the right pane save it with the current element
-        if(!txtEditorWidget->m_textEditorWin->document()->isEmpty() )
-        {
-            m_selectedElement->data.clear();
-            m_selectedElement->data.append(txtEditorWidget->m_textEditorWin->toHtml());
-        }
-        else
-            m_selectedElement->data.clear();
-
-        // If there's data on the label pane and bla bla.. same as above
-        if(!ui->txtLabel->text().isEmpty())
-        {
-            QString m_data(m_selectedElement->label);
-            if(!(m_data == ui->txtLabel->text()))
-            {
-                // Store it
-                m_selectedElement->label = ui->txtLabel->text();
-                ui->txtLabel->clear();
-                ui->txtLabel->setText(m_data);
-            }
-        }
-
-        // Save left pane lines and filename if we're on level > 1
-        if(m_currentActiveLevel != LEVEL_ONE)
-        {
-            // If nothing is selected, don't save anything
-            if(m_selectedElement->fileName.isEmpty())
-            {
-                qWarning() << "saveEverythingOnThePanesToMemory() - fileName empty - can't save anything";
-                m_selectedElement->firstLineData.clear();
-                m_selectedElement->linesNumbers.clear();
-                return;
-            }
-            qWarning() << "saveEverythingOnThePanesToMemory() - saving lines numbers..";
-            // Get highlighted lines and normalize them
-            if(codeEditorWidget->m_selectedLines.size() > 0)
-            {
-                // Every element next to the first should be an offset from the first
-                m_selectedElement->linesNumbers.clear();
-                qSort(codeEditorWidget->m_selectedLines);
-                m_selectedElement->linesNumbers.append(codeEditorWidget->m_selectedLines[0]);
-                for(int i=1; i<codeEditorWidget->m_selectedLines.size(); i++)
-                {
-                    m_selectedElement->linesNumbers.append(codeEditorWidget->m_selectedLines[i]
-                                                           -codeEditorWidget->m_selectedLines[0]);
-                }
-                qWarning() << endl;
-                qWarning() << " >< THESE LINES ARE STORED";
-                for(int j=0;j<m_selectedElement->linesNumbers.size();j++)
-                    qWarning() << m_selectedElement->linesNumbers[j] << " ";
-                qWarning() << endl;
-                // Finally store the first line text data
-                m_selectedElement->firstLineData.clear();
-                m_selectedElement->firstLineData.append(codeEditorWidget->getLineData(m_selectedElement->linesNumbers[0]));
-            }
-            else
-            {
-                // Hey, also 0 selected lines is a value to be stored!
-                m_selectedElement->linesNumbers.clear();
-                m_selectedElement->firstLineData.clear();
-            }
-        }
-    }
-
-}
-
-// Load everything from the selected element on the panes
-void MainWindowEditMode::loadSelectedElementDataInPanes()
-{
-    qWarning() << "Loading selected element to panes ->";
-
-    //
-    // Load the right pane with the new values for the new selected element
-    //
-    txtEditorWidget->m_textEditorWin->setHtml(QString(m_selectedElement->data));
-    if(m_lastSelectedHasBeenDeleted)
-        m_lastSelectedHasBeenDeleted = false;
-
-    //
-    // Load the label and spin index
-    //
-    ui->spinBox->setValue(m_selectedElement->userIndex);
-    ui->txtLabel->setText(m_selectedElement->label);
-
-    //
-    // Load the code file and add it to the combobox IF WE'RE ON LEVEL 2/3, notice that there might not be a file associated
-    //
-    if(m_currentActiveLevel == LEVEL_ONE || m_selectedElement == NULL)
-        return;
-    // If there's no file, don't load anything
-    if(m_selectedElement->fileName.isEmpty())
-    {
-        codeEditorWidget->document()->setPlainText("");
-        codeEditorWidget->m_selectedLines.clear();
-        return;
-    }
-    QString convertedAbsoluteFileName = convertToAbsolutePath(m_selectedElement->fileName);
-    if(!QFile::exists(convertedAbsoluteFileName)) // This is a relative path, convert to absolute path
-    {
-        QMessageBox::warning(this, "Error loading associated code file", "The code file associated with this element hasn't been found, the documentation might be corrupted");
-        return;
-    }
-    QFile file(convertedAbsoluteFileName);
-    if (!file.open(QFile::ReadOnly | QFile::Text))
-        return;
-    // Read the entire file and display it into the code window
-    QByteArray data = file.readAll();
-    codeEditorWidget->setPlainText(QString(data));
-    file.close();
-    if(m_recentFilePaths.size() >= 15)
-    {
-        // Remove the less recent one
-        m_recentFilePaths.remove(0);
-    }
-
-    // Add this path to the combobox and the vector (if it's not already there)
-    if(!m_recentFilePaths.contains(m_selectedElement->fileName))
-    {
-        m_recentFilePaths.append(m_selectedElement->fileName);
-        // Update combobox
-        ui->fileComboBox->clear();
-        for(int i=0;i<m_recentFilePaths.size();i++)
-            ui->fileComboBox->addItem(m_recentFilePaths[i]);
-
-        ui->fileComboBox->setCurrentIndex(ui->fileComboBox->count()-1);
-    }
-    else
-    {
-        int index = m_recentFilePaths.indexOf(m_selectedElement->fileName);
-        ui->fileComboBox->setCurrentIndex(index);
-    }
-
-    // Highlight the lines in the file we're associated to (if we have any)
-    if(m_selectedElement->linesNumbers.size() == 0)
-        return;
-    // Check for corruption (source file changed)
-    QStringList allLines = QString(data).split(QRegExp("\n"),QString::KeepEmptyParts);
-    if((quint32)allLines.size() < m_selectedElement->linesNumbers[0])
-    {
-        // Corrupted
-        QMessageBox::warning(this, "Error loading associated code file", "The code lines associated with this block have wrong line number values, the documentation might be corrupted");
-        return;
-    }
-    // Find textually the first line
-    if(allLines[m_selectedElement->linesNumbers[0]] != QString(m_selectedElement->firstLineData))
-    {
-        // Search near it for matchings
-        int i_offset = 0;
-        // First forward
-        for(int i=1;((quint32)allLines.size() > m_selectedElement->linesNumbers[0]+i); i++)
-        {
-            if(allLines[m_selectedElement->linesNumbers[0]+i] == QString(m_selectedElement->firstLineData))
-            {
-                // Found, update with +i offset
-                i_offset = i;
-                break;
-            }
-        }
-        // Then backward
-        for(int i=1;(m_selectedElement->linesNumbers[0]-1 >= 0); i++)
-        {
-            if(allLines[m_selectedElement->linesNumbers[0]-i] == QString(m_selectedElement->firstLineData))
-            {
-                // Found, update with -i offset
-                i_offset = -i;
-                break;
-            }
-        }
-        // Update if the offset was found
-        if(i_offset == 0)
-        {
-            // Corrupted
-            QMessageBox::warning(this, "Error loading associated code file", "The code lines associated with this block cannot be found, the documentation might be corrupted");
-            return;
-        }
-        // Next items don't need to be updated, they're relative to the first
-        m_selectedElement->linesNumbers[0] = m_selectedElement->linesNumbers[0] + i_offset;
-    }
-
-    // If we get here, we've found the line OR corrected the vector, draw the lines highlighted now
-    codeEditorWidget->highlightLines(m_selectedElement->linesNumbers);
-}
-
-void MainWindowEditMode::freeCurrentGraphElements()
-{
-    // Free memory and clear elements' buffer
-    for(int i=0; i<m_currentGraphElements.size(); i++)
-    {
-        delete m_currentGraphElements[i];
-    }
-    m_currentGraphElements.clear();
-
-    m_selectedElement = NULL;
-}
-
-// Try to load a level database or set the m_firstTimeGraphInCurrentLevel if there isn't any
-void MainWindowEditMode::tryToLoadLevelDb(level lvl, bool returnToElement)
-{
-    // Check if the db directory exists in the current directory
-    if(!QDir(GDS_DIR).exists())
-    {
-        // There's nothing, not even the directory.. first time for every level
-        QDir().mkdir(GDS_DIR);
-        m_firstTimeGraphInCurrentLevel = true;
-    }
-    else
-    {
-        switch(lvl)
-        {
-            case LEVEL_ONE:
-            {
-                // "level1_general.gds" file
-
-                // If the file doesn't exist, first time mode
-                if(!QFile(QString(GDS_DIR) + "/level1_general.gds").exists())
-                {
-                    m_firstTimeGraphInCurrentLevel = true;
-                    return;
-                }
-
-                freeCurrentGraphElements();
-
-                // De-Serialize our current data
-                QFile file(QString(GDS_DIR) + "/level1_general.gds");
-                file.open(QFile::ReadOnly);
-
-                // Thanks to our << and >> overloads, this will serialize just what we need
-                QDataStream in(&file);
-
-                // Read the number of elements stored
-                int m_numElements;
-                in >> m_numElements;
-
-                dbDataStructure *m_tempPointer;
-                for(int i=0; i<m_numElements; i++)
-                {
-                    // Read one structure and allocate it into memory
-                    m_tempPointer = new dbDataStructure();
-                    in >> *m_tempPointer;
-                    m_currentGraphElements.append(m_tempPointer);
-                }
-
-                file.close();
-
-                // Data is unusable yet, we need to re-convert each index-pointer to a proper memory pointer first
-                convertDbDataToStorableData(false);
-
-                // Draw loaded data and set root element as selected
-                m_selectedElement = m_currentGraphElements[0];
-                m_firstTimeGraphInCurrentLevel = false; // We've found data, so no need to start a new graph
-
-                // We can't draw yet if the shaders haven't been compiled so check for them first and set a callback if they're
-                // not ready
-                if(!GLDiagramWidget->m_readyToDraw)
-                {
-                    // Signal that data is ready to be painted and exit
-                    GLDiagramWidget->m_associatedWindowRepaintScheduled = true;
-                }
-                else
-                {
-                    // Widget is ready to draw, probably we have been taken here by the "previous level" button
-                    deferredPaintNow();
-                    // If zooming back, restore previous element
-                    if(returnToElement)
-                    {
-                        // Retrieve the uniqueID
-                        m_selectedElement = NULL;
-                        for(int i=0; i<m_currentGraphElements.size(); i++)
-                        {
-                            if(m_currentLevelOneID == m_currentGraphElements[i]->uniqueID)
-                            {
-                                m_selectedElement = m_currentGraphElements[i];
-                                break;
-                            }
-                        }
-                        GLDiagramWidget->changeSelectedElement(m_selectedElement->glPointer);
-                        loadSelectedElementDataInPanes();
-                    }
-                }
-            }break;
-
-        case LEVEL_TWO:
-        {
-            // "level2_X1.gds" file
-            QString m_dbFile = QString(GDS_DIR) + "/level2_" + QString("%1").arg(m_currentLevelOneID) + ".gds";
-
-            // If the file doesn't exist or has been deleted, first time mode
-            if(!QFile(m_dbFile).exists())
-            {
-                m_firstTimeGraphInCurrentLevel = true;
-                return;
-            }
-
-            freeCurrentGraphElements();
-
-            // De-Serialize our current data
-            QFile file(m_dbFile);
-            file.open(QFile::ReadOnly);
-
-            // Thanks to our << and >> overloads, this will serialize just what we need
-            QDataStream in(&file);
-
-            // Read the number of elements stored
-            int m_numElements;
-            in >> m_numElements;
-
-            dbDataStructure *m_tempPointer;
-            for(int i=0; i<m_numElements; i++)
-            {
-                // Read one structure and allocate it into memory
-                m_tempPointer = new dbDataStructure();
-                in >> *m_tempPointer;
-                m_currentGraphElements.append(m_tempPointer);
-            }
-
-            file.close();
-
-            // Data is unusable yet, we need to re-convert each index-pointer to a proper memory pointer first
-            convertDbDataToStorableData(false);
-
-            // Draw loaded data and set root selected
-            m_selectedElement = m_currentGraphElements[0];
-            m_firstTimeGraphInCurrentLevel = false; // We've found data, so no need to start a new graph
-
-            // This editor always starts in level one, so openGL widget is already loaded, redraw data!
-            deferredPaintNow();
-            // If zooming back, restore previous element
-            if(returnToElement)
-            {
-                // Retrieve the uniqueID
-                m_selectedElement = NULL;
-                for(int i=0; i<m_currentGraphElements.size(); i++)
-                {
-                    if(m_currentLevelTwoID == m_currentGraphElements[i]->uniqueID)
-                    {
-                        m_selectedElement = m_currentGraphElements[i];
-                        break;
-                    }
-                }
-                GLDiagramWidget->changeSelectedElement(m_selectedElement->glPointer);
-                loadSelectedElementDataInPanes();
-            }
-        }break;
-
-        case LEVEL_THREE:
-        {
-            // "level3_X1_X2.gds" file
-            QString m_dbFile = QString(GDS_DIR) + "/level3_" + QString("%1").arg(m_currentLevelOneID) + "_" +
-                    QString("%1").arg(m_currentLevelTwoID) + ".gds";
-
-            // If the file doesn't exist or has been deleted, first time mode
-            if(!QFile(m_dbFile).exists())
-            {
-                m_firstTimeGraphInCurrentLevel = true;
-                return;
-            }
-
-            freeCurrentGraphElements();
-
-            // De-Serialize our current data
-            QFile file(m_dbFile);
-            file.open(QFile::ReadOnly);
-
-            // Thanks to our << and >> overloads, this will serialize just what we need
-            QDataStream in(&file);
-
-            // Read the number of elements stored
-            int m_numElements;
-            in >> m_numElements;
-
-            dbDataStructure *m_tempPointer;
-            for(int i=0; i<m_numElements; i++)
-            {
-                // Read one structure and allocate it into memory
-                m_tempPointer = new dbDataStructure();
-                in >> *m_tempPointer;
-                m_currentGraphElements.append(m_tempPointer);
-            }
-
-            file.close();
-
-            // Data is unusable yet, we need to re-convert each index-pointer to a proper memory pointer first
-            convertDbDataToStorableData(false);
-
-            // Draw loaded data and set root selected
-            m_selectedElement = m_currentGraphElements[0];
-            m_firstTimeGraphInCurrentLevel = false; // We've found data, so no need to start a new graph
-
-            // This editor always starts in level one, so openGL widget is already loaded, redraw data!
-            deferredPaintNow();
-        }break;
-
-        }
-
-    }
-}
-
+#include "mainwindoweditmode.h"
+#include "ui_mainwindoweditmode.h"
+
+MainWindowEditMode::MainWindowEditMode(QWidget *parent) :
+    QMainWindow(parent),
+    ui(new Ui::MainWindowEditMode)
+{
+    ui->setupUi(this);
+
+    m_swapRunning = false;
+    m_lastSelectedHasBeenDeleted = false;
+    m_currentLevelDirty = false;
+    m_levelLoadFailed = false;
+    m_panesElement = NULL;
+    m_commentPaneDirty = false;
+    m_codePaneDirty = false;
+    m_currentGraphElements.clear();
+    m_selectedElement = NULL;
+    ui->spinBox->setEnabled(true);
+    // Still no element selected, and we're in level one
+    m_currentLevelOneID = -1;
+    m_currentLevelTwoID = -1;
+
+    // Add the textEditor widget to the right part
+    txtEditorWidget = new textEditorWin();
+    ui->rightArea->addWidget(txtEditorWidget);
+
+    // Create the code editor in the left pane and the line counter
+    codeEditorWidget = new CodeEditorWidget(*(ui->lineCounter));
+    // Create the code window on the left pane
+    txtHighlighter = new CppHighlighter(codeEditorWidget->document());
+    codeEditorWidget->setHighlighter(txtHighlighter);
+    // Insert it into the window
+    ui->codeLayout->addWidget(codeEditorWidget);
+    codeEditorWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    codeEditorWidget->setMinimumWidth(200);
+
+    // Set the connection for the label box
+    connect(ui->txtLabel, SIGNAL(returnPressed()), this, SLOT(enterPressedOnLabelEditBox()));
+
+    // Panes modified by the user have to be stored back into their element
+    connect(txtEditorWidget->m_textEditorWin, SIGNAL(textChanged()), this, SLOT(commentPaneChanged()));
+    connect(codeEditorWidget, SIGNAL(selectedLinesChanged()), this, SLOT(codePaneChanged()));
+
+    // Project-wide tools
+    QMenu *toolsMenu = menuBar()->addMenu(tr("&Tools"));
+    toolsMenu->addAction(tr("&Re-anchor all levels"), this, SLOT(reanchorAllLevels()));
+    toolsMenu->addAction(tr("Code file &coverage"), this, SLOT(showCodeFileCoverage()));
+
+    // Search box to find blocks in every level
+    QToolBar *searchToolBar = addToolBar(tr("Search"));
+    m_searchBox = new QLineEdit();
+    m_searchBox->setPlaceholderText(tr("Search the documentation (symbol:name for code symbols)..."));
+    m_searchBox->setMaximumWidth(300);
+    searchToolBar->addWidget(m_searchBox);
+    connect(m_searchBox, SIGNAL(returnPressed()), this, SLOT(searchDocumentation()));
+
+    // Enable multisampling (anti-aliasing) if supported
+    // for the following widgets
+    QGLFormat glf = QGLFormat::defaultFormat();
+    glf.setSampleBuffers(true);
+    glf.setSamples(4);
+    QGLFormat::setDefaultFormat(glf);
+
+    // SET FIRST LEVEL ACTIVE
+    //
+    // Notice: after the constructor, no one else is allowed to change this variable's value,
+    // use the proper method instead (that updates the code window too if needed)
+    m_currentActiveLevel = LEVEL_ONE;
+    m_levelLoaded = false;
+
+    // First time the edit mode is launched, we're in the first level (everyone can understand it), so
+    // we don't need any code file
+    this->ui->containerWidget->hide();
+    this->ui->goToPreviousLevel->setEnabled(false);
+
+    // Create the diagram widget
+    GLDiagramWidget = new QGLDiagramWidget((QMainWindow*)this);
+    GLDiagramWidget->m_gdsEditMode = true; // No animation while selecting
+    this->ui->graphLayout->addWidget(GLDiagramWidget);
+    // Assign the widget to this window
+    GLDiagramWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+    //
+    // DATABASE OPERATIONS ONGOING
+    //
+
+    // Try to load the level-1 documentation if present, otherwise create the db directory
+    // and set the "new graph" variable
+    tryToLoadLevelDb(LEVEL_ONE, false);
+}
+MainWindowEditMode::~MainWindowEditMode()
+{
+    delete ui;
+    delete txtEditorWidget;
+    delete GLDiagramWidget;
+    delete txtHighlighter;
+    delete codeEditorWidget;
+}
+
+// This method is called by the openGL widget every time the selection is changed on the graph
+int MainWindowEditMode::GLWidgetNotifySelectionChanged(int m_newSelection)
+{
+    // First save the right/left pane data for the old selected element
+    if(!m_lastSelectedHasBeenDeleted)
+    {
+        gdsDebug(LOGCAT_SELECTION) << "GLWidgetNotifySelectionChanged.saveEverythingOnThePanesToMemory()";
+        saveEverythingOnThePanesToMemory();
+    }
+
+    if(m_swapRunning)
+    {
+        // There's a swap running, swap the selected element with the new selected element
+        GLDiagramWidget->m_swapInProgress = true;
+
+        dbDataStructure *m_newSelectedElement;
+        // Select our new element
+        long m_newSelectionIndex = -1;
+        long m_selectedElementIndex = -1;
+        int foundBoth = 0;
+        for(int i=0; i<m_currentGraphElements.size(); i++)
+        {
+            if(foundBoth == 2)
+                break;
+
+            if(m_currentGraphElements[i]->nodeID == m_newSelection)
+            {
+                m_newSelectedElement = m_currentGraphElements[i];
+                m_newSelectionIndex = i;
+                foundBoth++;
+            }
+            if(m_currentGraphElements[i]->nodeID == m_selectedElement->nodeID)
+            {
+                m_selectedElementIndex = i;
+                foundBoth++;
+            }
+        }
+
+        // Swap these two structure's data
+        m_currentLevelDirty = true;
+        QByteArray m_temp = m_newSelectedElement->data;
+        m_newSelectedElement->data = m_selectedElement->data;
+        m_selectedElement->data = m_temp;
+
+        QString m_temp2 = m_newSelectedElement->fileName;
+        m_newSelectedElement->fileName = m_selectedElement->fileName;
+        m_selectedElement->fileName = m_temp2;
+
+        m_temp2 = m_newSelectedElement->label;
+        m_newSelectedElement->label = m_selectedElement->label;
+        m_selectedElement->label = m_temp2;
+
+        long m_temp3 = m_newSelectedElement->userIndex;
+        m_newSelectedElement->userIndex = m_selectedElement->userIndex;
+        m_selectedElement->userIndex = m_temp3;
+
+        m_temp = m_newSelectedElement->firstLineData;
+        m_newSelectedElement->firstLineData = m_selectedElement->firstLineData;
+        m_selectedElement->firstLineData = m_temp;
+
+        QVector<quint32> m_temp4 = m_newSelectedElement->linesNumbers;
+        m_newSelectedElement->linesNumbers = m_selectedElement->linesNumbers;
+        m_selectedElement->linesNumbers = m_temp4;
+
+
+        // Avoid a recursive this-method recalling when selected element changes: set swapInProgress and avoid repainting
+
+        GLDiagramWidget->clearGraphData();
+        updateGLGraph();
+        // Data insertion ended, calculate elements displacement and start drawing data
+        GLDiagramWidget->calculateDisplacement();
+
+        GLDiagramWidget->m_swapInProgress = false;
+    }
+    else
+    {
+        // Select our new element
+        for(int i=0; i<m_currentGraphElements.size(); i++)
+        {
+            if(m_currentGraphElements[i]->nodeID == m_newSelection)
+            {
+                m_selectedElement = m_currentGraphElements[i];
+                break;
+            }
+        }
+    }
+
+    gdsDebug(LOGCAT_SELECTION) << "New element selected: " + m_selectedElement->label;
+
+    // Load the selected element data in the panes, but first clear them
+    gdsDebug(LOGCAT_SELECTION) << "GLWidgetNotifySelectionChanged.clearAllPanes() and loadSelectedElementDataInPanes()";
+    clearAllPanes();
+    loadSelectedElementDataInPanes();
+
+    if(m_swapRunning)
+    {
+        m_swapRunning = false;
+        ui->swapBtn->toggle();
+
+        // Return to the painting widget the new element to be selected (data has been modified)
+        return m_selectedElement->nodeID;
+    }
+    else
+        return -1;
+}
+
+
+
+
+void MainWindowEditMode::on_goToNextLevel_clicked()
+{
+    // If there's no root, just deny it
+    if(m_firstTimeGraphInCurrentLevel || m_selectedElement == NULL)
+    {
+        QMessageBox::warning(this, "Zoom Error", "Cannot raise the zoom level if there's no element selected in the current graph");
+        return;
+    }
+
+    // We can't go further if we're on level three
+    if(m_currentActiveLevel == LEVEL_THREE)
+    {
+        QMessageBox::warning(this, "Zoom Error", "The maximum zoom level has already been reached");
+        return;
+    }
+
+    //////////////////////////////////////
+    //  Go to next level
+    //////////////////////////////////////
+
+    // 1) Save all panes and data to disk
+    saveEverythingOnThePanesToMemory();
+    saveCurrentLevelDb();
+
+    // The level we're leaving stays in memory, going back to it won't need to read it again
+    QString m_leftDbFile = LevelStorage::levelFilePath(m_currentActiveLevel, m_currentLevelOneID, m_currentLevelTwoID);
+
+    // 2) Save our current selected element's level and unique index
+    switch(m_currentActiveLevel)
+    {
+        case LEVEL_ONE:
+        {
+            // We just have to save this ID
+            m_currentLevelOneID = m_selectedElement->uniqueID;
+
+        }break;
+        case LEVEL_TWO:
+        {
+            // We already have one ID saved, the m_currentLevelOneID, save the other one
+            m_currentLevelTwoID = m_selectedElement->uniqueID;
+
+        }break;
+    }
+
+    // 3) Either if we were on level 1 or level 2 before, now we have to show the left pane, and clear the right pane too
+    this->ui->containerWidget->show();
+    txtEditorWidget->m_textEditorWin->clear();
+    codeEditorWidget->clearAllCodeHighlights();
+    this->ui->spinBox->setValue(0);
+    this->ui->txtLabel->setText("Block");
+
+    // 4) Check if the new appropriate file exists
+    m_currentActiveLevel = (m_currentActiveLevel == LEVEL_ONE) ? LEVEL_TWO : LEVEL_THREE;
+    QString m_nextDbFile = LevelStorage::levelFilePath(m_currentActiveLevel, m_currentLevelOneID, m_currentLevelTwoID);
+
+    // 5) If the file doesn't exist: new graph, otherwise: load the data
+    if(!QFile(m_nextDbFile).exists())
+    {
+        // No file detected, new graph needed at this level
+        gdsInfo(LOGCAT_STORAGE) << m_nextDbFile << " not detected, creating a new graph..";
+
+        // Clear all graph data and free memory
+        GLDiagramWidget->clearGraphData();
+        freeCurrentGraphElements();
+        // Also de-load the code file we've been using
+        codeEditorWidget->clear();
+        m_firstTimeGraphInCurrentLevel = true;
+    }
+    else
+    {
+        gdsDebug(LOGCAT_STORAGE) << m_nextDbFile << " DETECTED, loading data..";
+
+        // File detected, load its data and display it
+        cacheCurrentLevel(m_leftDbFile);
+        GLDiagramWidget->clearGraphData();
+        freeCurrentGraphElements();
+        tryToLoadLevelDb(m_currentActiveLevel, false);
+    }
+
+    // 6) Update navigation buttons and label
+    switch(m_currentActiveLevel)
+    {
+        // Warning: no level one since the "nextlevel" button can only take us to two or three..
+        case LEVEL_TWO:
+        {
+           ui->goToPreviousLevel->setEnabled(true);
+           ui->goToNextLevel->setEnabled(true);
+           ui->currentLevelLabel->setText("Currently in level 2 - A user with some technical skills should be able to understand this");
+
+        }break;
+
+        case LEVEL_THREE:
+        {
+           ui->goToPreviousLevel->setEnabled(true);
+           ui->goToNextLevel->setEnabled(false);
+           ui->currentLevelLabel->setText("Currently in level 3 - Programmers should be able to understand this");
+
+        }break;
+    }
+}
+void MainWindowEditMode::on_goToPreviousLevel_clicked()
+{
+    // We can't go back if we're on level one
+    if(m_currentActiveLevel == LEVEL_ONE)
+    {
+        QMessageBox::warning(this, "Zoom Error", "The minimum zoom level has already been reached");
+        return;
+    }
+
+    //////////////////////////////////////
+    //  Go to previous level
+    //////////////////////////////////////
+
+    // 1) Save all panes and data to disk if this graph isn't empty
+    saveEverythingOnThePanesToMemory();
+    saveCurrentLevelDb();
+
+    // The level we're leaving stays in memory, going back to it won't need to read it again
+    QString m_leftDbFile = LevelStorage::levelFilePath(m_currentActiveLevel, m_currentLevelOneID, m_currentLevelTwoID);
+
+    // 2) Show the left pane if we have to, and clear the right/left pane too
+    if(m_currentActiveLevel == LEVEL_TWO) // if we're returning to level one hide the left pane
+        this->ui->containerWidget->hide();
+    txtEditorWidget->m_textEditorWin->clear();
+    codeEditorWidget->clearAllCodeHighlights();
+    this->ui->spinBox->setValue(0);
+    this->ui->txtLabel->setText("Block");
+
+    // 3) Check if the new appropriate file exists, otherwise CRITICAL ERROR - BROKEN DOCUMENTATION - try to recreate another one
+    m_currentActiveLevel = (m_currentActiveLevel == LEVEL_THREE) ? LEVEL_TWO : LEVEL_ONE;
+    QString m_previousDbFile = LevelStorage::levelFilePath(m_currentActiveLevel, m_currentLevelOneID, m_currentLevelTwoID);
+
+    // 4) If the file doesn't exist: new graph, otherwise: load the data
+    if(!QFile(m_previousDbFile).exists())
+    {
+        // No file detected, new graph needed at this level
+        gdsWarning(LOGCAT_STORAGE) << m_previousDbFile << "BROKEN DOCUMENTATION - FILE not detected, creating a new graph..";
+
+        // Clear all graph data and free memory
+        GLDiagramWidget->clearGraphData();
+        freeCurrentGraphElements();
+        m_firstTimeGraphInCurrentLevel = true;
+    }
+    else
+    {
+        gdsDebug(LOGCAT_STORAGE) << m_previousDbFile << "previous file DETECTED, loading data..";
+
+        // File detected, load its data and display it
+        cacheCurrentLevel(m_leftDbFile);
+        GLDiagramWidget->clearGraphData();
+        freeCurrentGraphElements();
+        tryToLoadLevelDb(m_currentActiveLevel, true);
+    }
+
+    // 6) Update navigation buttons and label
+    switch(m_currentActiveLevel)
+    {
+        // Warning: no level three since the "previouslevel" button can only take us to two or one..
+        case LEVEL_TWO:
+        {
+           ui->goToPreviousLevel->setEnabled(true);
+           ui->goToNextLevel->setEnabled(true);
+           ui->currentLevelLabel->setText("Currently in level 2 - A user with some technical skills should be able to understand this");
+
+        }break;
+
+        case LEVEL_ONE:
+        {
+           ui->goToPreviousLevel->setEnabled(false);
+           ui->goToNextLevel->setEnabled(true);
+           ui->currentLevelLabel->setText("Currently in level 1 - Everyone should be able to understand this");
+
+        }break;
+    }
+
+}
+
+
+// This method is called by the openGL widget when it's ready to draw and if there's a scheduled painting pending
+void MainWindowEditMode::deferredPaintNow()
+{
+    // Sets the swapping value to prevent screen flickering (it disables repaint events)
+    bool oldValue = GLDiagramWidget->m_swapInProgress;
+    GLDiagramWidget->m_swapInProgress = true;
+
+    GLDiagramWidget->clearGraphData();
+    // A level coming from the cache is drawn with the scene it was left with, its nodes were inserted in the
+    // elements' order so every node ID is the element's index
+    if(m_cachedRenderData.m_scene.size() == m_currentGraphElements.size()
+            && GLDiagramWidget->restoreRenderData(m_cachedRenderData))
+    {
+        for(int i=0; i<m_currentGraphElements.size(); i++)
+            m_currentGraphElements[i]->nodeID = i;
+    }
+    else
+    {
+        updateGLGraph();
+        // Data insertion ended, calculate elements displacement and start drawing data
+        GLDiagramWidget->calculateDisplacement();
+    }
+    m_cachedRenderData = diagramRenderData();
+
+    // Restore the swapping value to its previous
+    GLDiagramWidget->m_swapInProgress = oldValue;
+    GLDiagramWidget->changeSelectedElement(m_selectedElement->nodeID);
+
+    // We selected an element for the first time (the graph has been loaded), we need to recharge this item's data
+    // Load the selected element data in the panes
+    loadSelectedElementDataInPanes();
+}
+
+
+void MainWindowEditMode::enterPressedOnLabelEditBox()
+{
+    // Update this node's label and redraw it
+    if(m_selectedElement == NULL || m_currentGraphElements.size() == 0)
+        return;
+
+    m_selectedElement->label = ui->txtLabel->text();
+    m_currentLevelDirty = true;
+
+    // Sets the swapping value to prevent screen flickering (it disables repaint events)
+    bool oldValue = GLDiagramWidget->m_swapInProgress;
+    GLDiagramWidget->m_swapInProgress = true;
+
+    GLDiagramWidget->clearGraphData();
+    updateGLGraph();
+    // Data insertion ended, calculate elements displacement and start drawing data
+    GLDiagramWidget->calculateDisplacement();
+
+    // Restore the swapping value to its previous
+    GLDiagramWidget->m_swapInProgress = oldValue;
+    GLDiagramWidget->changeSelectedElement(m_selectedElement->nodeID);
+}
+
+// This happens when the spinbox loses focus or enter is pressed
+void MainWindowEditMode::on_spinBox_editingFinished()
+{
+    // Just update the selected element's data
+    if(m_selectedElement == NULL || m_currentGraphElements.size() == 0 || QString(ui->spinBox->value()) == "")
+        return;
+
+    if(m_selectedElement->userIndex != (quint32)ui->spinBox->value())
+        m_currentLevelDirty = true;
+    m_selectedElement->userIndex = ui->spinBox->value();
+}
+
+
+// Update the openGL graph widget (the graph has changed)
+void MainWindowEditMode::updateGLGraph()
+{
+    int temp;
+    for(int i=0; i<m_currentGraphElements.size(); i++)
+    {
+        if(m_currentGraphElements[i]->father == NULL)
+        {
+            // Root
+            temp = GLDiagramWidget->insertTreeData(m_currentGraphElements[i]->label, -1);
+            m_currentGraphElements[i]->nodeID = temp;
+        }
+        else
+        {
+            temp = GLDiagramWidget->insertTreeData(m_currentGraphElements[i]->label, m_currentGraphElements[i]->father->nodeID);
+            m_currentGraphElements[i]->nodeID = temp;
+        }
+    }
+}
+
+
+// Delete current selected element and ask for total elimination (all children too) or partial elimination
+void MainWindowEditMode::on_deleteSelectedElementBtn_clicked()
+{
+    // If there are no elements, exit
+    if(m_currentGraphElements.size() == 0)
+        return;
+
+    // Does the user want to delete the root?
+    if(m_selectedElement->father == NULL)
+    {
+        // Damn, he wants to delete the root... we can't allow that without destroying the entire graph
+        QMessageBox::StandardButton reply;
+        reply = QMessageBox::question(this, tr("Deletion confirmation"),
+                                      "Deleting the root element will cause the entire graph to be lost, do you want to continue?",
+                                      QMessageBox::Yes | QMessageBox::No);
+        if (reply == QMessageBox::No)
+            return;
+        gdsDebug(LOGCAT_EDITOR) << "ROOT DESTROYING AND EVERYTHING RELATED";
+        // Destroy EVERYTHING
+        LevelStorage::freeElements(m_currentGraphElements);
+
+        m_firstTimeGraphInCurrentLevel = true;
+        m_selectedElement = NULL;
+    }
+    else
+    {
+
+        // Check if the selected element has children
+        if(m_selectedElement->nextItems.size() == 0)
+        {
+            // No children, total elimination
+            gdsDebug(LOGCAT_EDITOR) << "no children, total elimination";
+            QMessageBox::StandardButton reply;
+            reply = QMessageBox::question(this, tr("Deletion confirmation"),
+                                          "Do you really want to delete this element?",
+                                          QMessageBox::Yes | QMessageBox::No);
+            if (reply == QMessageBox::No)
+                return;
+
+            // Save its father (we'll select this after the deletion)
+            dbDataStructure *m_father = m_selectedElement->father;
+            //qWarning() << "father has data: " << QString(m_father->data);
+
+            // Delete the node from the global vector and from the father's children (if not NULL, maybe this selected is the root)
+            int index = -1;
+            for(int i=0; i<m_currentGraphElements.size(); i++)
+            {
+                if(m_currentGraphElements[i] == m_selectedElement)
+                {
+                    index = i;
+                    break;
+                }
+            }
+            m_currentGraphElements.remove(index);
+
+            if(m_father != NULL)
+            {
+                for(int i=0; i<m_father->nextItems.size(); i++)
+                {
+                    if(m_father->nextItems[i] == m_selectedElement)
+                    {
+                        index = i;
+                        break;
+                    }
+                }
+                m_father->nextItems.remove(index);
+            }
+            LevelStorage::freeElement(m_selectedElement); // Free memory
+
+            // This prevents messing with the data of the precedent selection
+            m_lastSelectedHasBeenDeleted = true;
+
+            // Select the father
+            m_selectedElement = m_father;
+        }
+        else
+        {
+            // It has children, ask for total or partial elimination
+
+            QMessageBox::StandardButton reply;
+            reply = QMessageBox::question(this, tr("Deletion confirmation"),
+                                          "Do you want to delete this element's children as well?\r\nChoose Cancel to abort the deletion",
+                                          QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+
+            if (reply == QMessageBox::Cancel)
+                return;
+
+            if (reply == QMessageBox::Yes)
+            {
+                // Total deletion (children included)
+                gdsDebug(LOGCAT_EDITOR) << "Deletion WITH children";
+                // Save its father (we'll select this after the deletion)
+                dbDataStructure *m_father = m_selectedElement->father;
+                //qWarning() << "father has data: " << QString(m_father->data);
+
+                // Delete this child from its father's children
+                int index = -1;
+                for(int i=0; i<m_father->nextItems.size(); i++)
+                {
+                    if(m_father->nextItems[i] == m_selectedElement)
+                    {
+                        index = i;
+                        break;
+                    }
+                }
+                m_father->nextItems.remove(index);
+
+                // Delete the node and all its children
+                recursiveDelete(m_selectedElement);
+
+                // This prevents messing with the data of the precedent selection
+                m_lastSelectedHasBeenDeleted = true;
+
+                // Select the father
+                m_selectedElement = m_father;
+            }
+            else
+            {
+                // Delete the element but preserve the children
+
+                // Save its father (we'll select this after the deletion)
+                dbDataStructure *m_father = m_selectedElement->father;
+                gdsDebug(LOGCAT_EDITOR) << "Deletion WITHOUT children";
+                //qWarning() << "father has data: " << QString(m_father->data);
+                // Delete this child from its father's children
+                int index = -1;
+                for(int i=0; i<m_father->nextItems.size(); i++)
+                {
+                    if(m_father->nextItems[i] == m_selectedElement)
+                    {
+                        index = i;
+                        break;
+                    }
+                }
+                m_father->nextItems.remove(index);
+
+                // Set the new children's father
+                for(int i=0; i<m_selectedElement->nextItems.size(); i++)
+                {
+                    m_selectedElement->nextItems[i]->father = m_father;
+                }
+                // Set the new father's children
+                for(int i=0; i<m_selectedElement->nextItems.size(); i++)
+                {
+                    m_father->nextItems.append(m_selectedElement->nextItems[i]);
+                }
+
+                for(int i=0; i<m_currentGraphElements.size(); i++)
+                {
+                    if(m_currentGraphElements[i] == m_selectedElement)
+                    {
+                        index = i;
+                        break;
+                    }
+                }
+                m_currentGraphElements.remove(index);
+                LevelStorage::freeElement(m_selectedElement); // Free memory
+
+                // This prevents messing with the data of the precedent selection
+                m_lastSelectedHasBeenDeleted = true;
+
+                // Select the father
+                m_selectedElement = m_father;
+            }
+
+        }
+    }
+
+    // The panes might show a deleted element
+    m_panesElement = NULL;
+    m_currentLevelDirty = true;
+
+    // Redraw
+    GLDiagramWidget->clearGraphData();
+    updateGLGraph();
+
+    // Nothing to calculate if there are no elements
+    if(m_currentGraphElements.size() > 0)
+    {
+        // Data insertion ended, calculate elements displacement and start drawing data
+        GLDiagramWidget->calculateDisplacement();
+        // Select our selected element (if not NULL)
+        if(m_selectedElement != NULL)
+        {
+            GLDiagramWidget->changeSelectedElement(m_selectedElement->nodeID);
+
+            // Load its data
+            loadSelectedElementDataInPanes();
+        }
+    }
+}
+void MainWindowEditMode::recursiveDelete(dbDataStructure* element)
+{
+    for(int i=0; i<element->nextItems.size(); i++)
+    {
+        recursiveDelete(element->nextItems[i]);
+    }
+
+    int index = -1;
+    for(int i=0; i<m_currentGraphElements.size(); i++)
+    {
+        if(m_currentGraphElements[i] == element)
+        {
+            index = i;
+            break;
+        }
+    }
+    m_currentGraphElements.remove(index);
+    LevelStorage::freeElement(element); // Free memory
+}
+
+void MainWindowEditMode::on_addChildBlockBtn_clicked()
+{
+    // A level that couldn't be loaded cannot get new blocks, it would be saved over the unreadable file
+    if(m_levelLoadFailed)
+    {
+        QMessageBox::warning(this, "Editing disabled", "The current level documentation file cannot be loaded, it cannot be edited");
+        return;
+    }
+
+    // If first time, create the root element and store it into the db
+    if(m_firstTimeGraphInCurrentLevel)
+    {
+        // Create a root for the current graph
+
+        // Level one and no graph, create the root
+        dbDataStructure *rootElement = new dbDataStructure();
+        rootElement->depth = 0;
+        rootElement->userIndex = ui->spinBox->text().toLong();
+
+        if(ui->txtLabel->text().isEmpty())
+        {
+            rootElement->label = "Block";
+            ui->txtLabel->setText("Block");
+        }
+        else
+            rootElement->label = ui->txtLabel->text();
+
+        rootElement->father = NULL; // root has no father
+
+        rootElement->uniqueID = getThisGraphNextFreeID();
+
+        // If there's data on the right pane, store it with us
+        if(!txtEditorWidget->m_textEditorWin->document()->isEmpty())
+        {
+            rootElement->data = RichTextCodec::store(*txtEditorWidget->m_textEditorWin->document());
+        }
+        // If there's code on the left pane, store it with us
+        if(!codeEditorWidget->document()->isEmpty())
+        {
+            rootElement->fileName.clear();
+            rootElement->fileName.append(ui->fileComboBox->currentText());
+        }
+
+        // -----------------------------------------------------
+
+        // Add it to the element list
+        m_currentLevelDirty = true;
+        m_currentGraphElements.append(rootElement);
+
+        // Select this
+        m_selectedElement = rootElement;
+
+        GLDiagramWidget->clearGraphData();
+        updateGLGraph();
+        // Data insertion ended, calculate elements displacement and start drawing data
+        GLDiagramWidget->calculateDisplacement();
+        // Select our selected element
+        GLDiagramWidget->changeSelectedElement(m_selectedElement->nodeID);
+
+        m_firstTimeGraphInCurrentLevel = false; // We added an element
+
+        saveEverythingOnThePanesToMemory(); // This saves the code lines highlighted
+    }
+    else
+    {
+        // Create another element every level
+
+        // Level one, create another element child of the one selected
+        dbDataStructure *newElement = new dbDataStructure();
+        newElement->depth = m_selectedElement->depth + 1;
+        // Increment the spinbox value
+        ui->spinBox->setValue(ui->spinBox->value()+1);
+        newElement->userIndex = ui->spinBox->text().toLong();
+
+        // Set new element's father and add it to the selected element's children
+        newElement->father = m_selectedElement;
+        m_selectedElement->nextItems.append(newElement);
+
+        // Assign a new unique ID for this graph
+        newElement->uniqueID = getThisGraphNextFreeID();
+
+        // Save everything for the old element
+        saveEverythingOnThePanesToMemory();
+
+        // Set the label text to "Block" as default
+        newElement->label = "Block";
+        ui->txtLabel->setText("Block");
+        // And clear the text of the new block
+        newElement->data.clear();
+        txtEditorWidget->m_textEditorWin->clear();
+
+        // And then clear the highlights on the code file (the code file might remain the same, just to speed things up)
+        if(m_currentActiveLevel != LEVEL_ONE)
+        {
+            codeEditorWidget->clearAllCodeHighlights();
+            // Obviously if the code remains the same, we need to set it on our child :)
+            newElement->fileName.clear();
+            newElement->fileName.append(m_selectedElement->fileName);
+        }
+
+
+        // -----------------------------------------------------
+
+        // Add it to the element list
+        m_currentLevelDirty = true;
+        m_currentGraphElements.append(newElement);
+
+        // Select this
+        m_selectedElement = newElement;
+
+        GLDiagramWidget->clearGraphData();
+        updateGLGraph();
+        // Data insertion ended, calculate elements displacement and start drawing data
+        GLDiagramWidget->calculateDisplacement();
+        // Select our selected element
+        GLDiagramWidget->changeSelectedElement(m_selectedElement->nodeID);
+    }
+}
+
+// Swap an element with another one, this handles just the button
+void MainWindowEditMode::on_swapBtn_clicked()
+{
+    if(m_selectedElement == NULL)
+    {
+        // Nothing to swap
+        if(ui->swapBtn->isChecked())
+            ui->swapBtn->toggle();
+        return;
+    }
+
+    // Signal that the selected element has been selected for swap
+    m_swapRunning = true;
+}
+
+void MainWindowEditMode::closeEvent(QCloseEvent *)
+{
+    // Save the last selected element's data
+    saveEverythingOnThePanesToMemory();
+    // Finally save to disk
+    saveCurrentLevelDb();
+    exit(1);
+}
+
+void MainWindowEditMode::on_browseCodeFiles_clicked()
+{
+    // Search for a new code file and store just the relative position from this app's directory
+
+    QString fn = QFileDialog::getOpenFileName(this, tr("Open C/C++ code file..."),
+                                              QString(), tr("C/C++ Files (*.cpp *.c *.h)"));
+    if (fn.isEmpty() || !QFile::exists(fn))
+        // Nothing to load
+        return;
+
+    // If there's no element don't allow the file to be loaded
+    if(m_currentGraphElements.count() == 0 || m_selectedElement == NULL)
+    {
+        QMessageBox::warning(this, "Error associating code file", "An element is needed before associating a code file");
+        return;
+    }
+
+    QFile file(fn);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return;
+
+    // 1) Read the entire file and display it into the code window
+    QByteArray data = file.readAll();
+
+    if(m_selectedElement != NULL && m_currentGraphElements.size() > 0)
+    {
+        // First clear all the highlighted data
+        codeEditorWidget->document()->setPlainText("");
+        codeEditorWidget->m_selectedLines.clear();
+
+        // This time we need to clear this element's data too
+        m_selectedElement->linesNumbers.clear();
+        m_selectedElement->firstLineData.clear();
+    }
+
+    codeEditorWidget->loadCode(data);
+
+    // 2) Add its RELATIVE path to the combo box
+    if(m_recentFilePaths.size() >= 15)
+    {
+        // Remove the less recent one
+        m_recentFilePaths.remove(0);
+    }
+
+    QFileInfo info(file);
+    QString finalRelativePath = convertToRelativePath(info.absoluteFilePath());
+    // Also add the filename to the current element's
+    m_currentLevelDirty = true;
+    m_codePaneDirty = true;
+    m_selectedElement->fileName.clear();
+    m_selectedElement->fileName.append(finalRelativePath);
+
+    // and finally add this path to the combobox and the vector (if it's not already there)
+    if(!m_recentFilePaths.contains(finalRelativePath))
+    {
+        m_recentFilePaths.append(finalRelativePath);
+        // Update combobox
+        ui->fileComboBox->clear();
+        for(int i=0;i<m_recentFilePaths.size();i++)
+            ui->fileComboBox->addItem(m_recentFilePaths[i]);
+
+        ui->fileComboBox->setCurrentIndex(ui->fileComboBox->count()-1);
+    }
+    else
+    {
+        int index = m_recentFilePaths.indexOf(finalRelativePath);
+        ui->fileComboBox->setCurrentIndex(index);
+    }
+
+    file.close();
+}
+
+// Combo box was pressed
+void MainWindowEditMode::on_fileComboBox_activated(const QString &arg1)
+{
+    if(m_selectedElement == NULL || m_currentGraphElements.size() == 0)
+        return;
+
+    QString absoluteNewPath = convertToAbsolutePath(arg1);
+    if (!QFile::exists(absoluteNewPath))
+        // Nothing to load
+        return;
+
+    // First clear all the highlighted data if there was an open document on
+    if(!codeEditorWidget->document()->isEmpty())
+    {
+        codeEditorWidget->document()->setPlainText("");
+        codeEditorWidget->m_selectedLines.clear();
+    }
+
+    // This time we need to clear this element's data too
+    m_selectedElement->linesNumbers.clear();
+    m_selectedElement->firstLineData.clear();
+
+    // Load the new code file
+    QFile file(absoluteNewPath);
+
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return;
+
+    // Read the entire file and display it into the code window
+    QByteArray data = file.readAll();
+
+    codeEditorWidget->loadCode(data);
+    m_currentLevelDirty = true;
+    m_codePaneDirty = true;
+    m_selectedElement->fileName.clear();
+    m_selectedElement->fileName.append(arg1);
+    gdsDebug(LOGCAT_EDITOR) << "on_fileComboBox_activated() - filename set to: "+arg1;
+
+    file.close();
+
+    // Update the panes data, this will also update the filename of our selectedElement
+    saveEverythingOnThePanesToMemory();
+}
+
+
+// Sometimes we don't want a code file associated, clear the codeview and save to ram
+void MainWindowEditMode::on_clearCodeFileBtn_clicked()
+{
+    if(m_selectedElement == NULL)
+        return;
+
+    codeEditorWidget->document()->setPlainText("");
+    codeEditorWidget->m_selectedLines.clear();
+
+    m_selectedElement->fileName.clear();
+    m_selectedElement->linesNumbers.clear();
+    m_selectedElement->firstLineData.clear();
+    m_currentLevelDirty = true;
+    m_codePaneDirty = true;
+
+
+}
+
+// Re-anchor every block of every level against its code file and report moved/broken anchors
+void MainWindowEditMode::reanchorAllLevels()
+{
+    // The job works on the files, so everything we have in memory has to be on disk first
+    saveEverythingOnThePanesToMemory();
+    saveCurrentLevelDb();
+
+    BatchReanchorJob job(true);
+    if(!job.run())
+    {
+        QMessageBox::warning(this, "Re-anchoring", "No documentation level has been found");
+        return;
+    }
+
+    // Files have been rewritten, cached levels are stale
+    m_levelCache.clear();
+
+    QString reportFile = QString(GDS_DIR) + "/reanchor_report.txt";
+    job.writeReport(reportFile);
+
+    // Moved anchors have been written to disk, reload the current graph to get them
+    if(job.movedCount() > 0 && m_currentActiveLevel != LEVEL_ONE && !m_firstTimeGraphInCurrentLevel)
+    {
+        GLDiagramWidget->clearGraphData();
+        freeCurrentGraphElements();
+        clearAllPanes();
+        tryToLoadLevelDb(m_currentActiveLevel, false);
+    }
+
+    QMessageBox::information(this, "Re-anchoring", job.summary() + "\r\nThe complete report has been written to " + reportFile);
+}
+
+
+
+
+
+
+
+
+
+
+// Return was pressed in the search box, show the hits and jump to the chosen one
+void MainWindowEditMode::searchDocumentation()
+{
+    // The index is built the first time it's needed (from what's on disk, so save first), then it's
+    // updated every time a level is saved
+    saveEverythingOnThePanesToMemory();
+    saveCurrentLevelDb();
+    QString query = m_searchBox->text().trimmed();
+    QVector<searchHit> hits;
+    if(query.startsWith("symbol:"))
+    {
+        // Blocks documenting the lines where a code symbol appears
+        if(!m_symbolIndex.isBuilt())
+        {
+            QApplication::setOverrideCursor(Qt::WaitCursor);
+            m_symbolIndex.build();
+            QApplication::restoreOverrideCursor();
+        }
+        hits = m_symbolIndex.findSymbol(query.mid(7).trimmed());
+    }
+    else
+    {
+        if(!m_searchIndex.isBuilt())
+        {
+            QApplication::setOverrideCursor(Qt::WaitCursor);
+            m_searchIndex.build();
+            QApplication::restoreOverrideCursor();
+        }
+        hits = m_searchIndex.search(query);
+    }
+    if(hits.isEmpty())
+    {
+        QMessageBox::information(this, "Search", "No block matches \"" + query + "\"");
+        return;
+    }
+
+    // A single hit doesn't need to be chosen
+    if(hits.size() == 1)
+    {
+        jumpToNode(hits[0]);
+        return;
+    }
+
+    QMenu hitsMenu(this);
+    for(int i=0; i<hits.size(); i++)
+    {
+        QAction *action = hitsMenu.addAction(QString("[%1] ").arg((int)hits[i].lvl + 1) + hits[i].breadcrumb);
+        action->setData(i);
+    }
+    QAction *chosen = hitsMenu.exec(m_searchBox->mapToGlobal(QPoint(0, m_searchBox->height())));
+    if(chosen != NULL)
+        jumpToNode(hits[chosen->data().toInt()]);
+}
+
+// Shows how much of the selected block's code file is documented
+void MainWindowEditMode::showCodeFileCoverage()
+{
+    if(m_selectedElement == NULL || m_selectedElement->fileName.isEmpty())
+    {
+        QMessageBox::warning(this, "Code file coverage", "The selected block has no associated code file");
+        return;
+    }
+
+    saveEverythingOnThePanesToMemory();
+    saveCurrentLevelDb();
+    if(!m_symbolIndex.isBuilt())
+    {
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        m_symbolIndex.build();
+        QApplication::restoreOverrideCursor();
+    }
+
+    int totalLines, documentedLines, documentingBlocks;
+    if(!m_symbolIndex.fileCoverage(m_selectedElement->fileName, &totalLines, &documentedLines, &documentingBlocks))
+    {
+        QMessageBox::warning(this, "Code file coverage", "The code file cannot be read");
+        return;
+    }
+    double percentage = (totalLines > 0) ? (100.0 * documentedLines / totalLines) : 0.0;
+    QMessageBox::information(this, "Code file coverage", QString("%1\r\n%2 of %3 lines documented (%4%) by %5 blocks")
+                             .arg(m_selectedElement->fileName).arg(documentedLines).arg(totalLines)
+                             .arg(percentage, 0, 'f', 1).arg(documentingBlocks));
+}
+
+// Loads the hit's level (if it isn't the current one) and selects the hit's node
+void MainWindowEditMode::jumpToNode(const searchHit &hit)
+{
+    // Data is saved to disk before leaving the current element
+    saveEverythingOnThePanesToMemory();
+    saveCurrentLevelDb();
+
+    // The level we're leaving stays in memory, going back to it won't need to read it again
+    QString m_leftDbFile = LevelStorage::levelFilePath(m_currentActiveLevel, m_currentLevelOneID, m_currentLevelTwoID);
+
+    bool sameLevel = (hit.lvl == m_currentActiveLevel)
+            && (hit.lvl == LEVEL_ONE || hit.levelOneID == m_currentLevelOneID)
+            && (hit.lvl != LEVEL_THREE || hit.levelTwoID == m_currentLevelTwoID);
+    if(!sameLevel)
+    {
+        // Go straight to the hit's level, the ancestors' IDs are needed to go back from there
+        m_currentActiveLevel = hit.lvl;
+        if(hit.lvl != LEVEL_ONE)
+            m_currentLevelOneID = hit.levelOneID;
+        if(hit.lvl == LEVEL_THREE)
+            m_currentLevelTwoID = hit.levelTwoID;
+
+        if(m_currentActiveLevel == LEVEL_ONE)
+            this->ui->containerWidget->hide();
+        else
+            this->ui->containerWidget->show();
+        txtEditorWidget->m_textEditorWin->clear();
+        codeEditorWidget->clearAllCodeHighlights();
+
+        cacheCurrentLevel(m_leftDbFile);
+        GLDiagramWidget->clearGraphData();
+        freeCurrentGraphElements();
+        bool loaded = tryToLoadLevelDb(m_currentActiveLevel, false);
+        updateLevelControls();
+        // uniqueIDs are unique just within a level, don't look for the block in another one
+        if(!loaded)
+        {
+            QMessageBox::warning(this, "Block not available", "The block's level cannot be loaded, the block cannot be shown");
+            return;
+        }
+    }
+
+    // Select the node and load its data
+    for(int i=0; i<m_currentGraphElements.size(); i++)
+    {
+        if(m_currentGraphElements[i]->uniqueID == hit.uniqueID)
+        {
+            m_selectedElement = m_currentGraphElements[i];
+            GLDiagramWidget->changeSelectedElement(m_selectedElement->nodeID);
+            clearAllPanes();
+            loadSelectedElementDataInPanes();
+            return;
+        }
+    }
+    QMessageBox::warning(this, "Block not available", "The block cannot be found in its level, the documentation might have changed");
+}
+
+// Update navigation buttons and label for the current level
+void MainWindowEditMode::updateLevelControls()
+{
+    switch(m_currentActiveLevel)
+    {
+        case LEVEL_ONE:
+        {
+           ui->goToPreviousLevel->setEnabled(false);
+           ui->goToNextLevel->setEnabled(true);
+           ui->currentLevelLabel->setText("Currently in level 1 - Everyone should be able to understand this");
+        }break;
+
+        case LEVEL_TWO:
+        {
+           ui->goToPreviousLevel->setEnabled(true);
+           ui->goToNextLevel->setEnabled(true);
+           ui->currentLevelLabel->setText("Currently in level 2 - A user with some technical skills should be able to understand this");
+        }break;
+
+        case LEVEL_THREE:
+        {
+           ui->goToPreviousLevel->setEnabled(true);
+           ui->goToNextLevel->setEnabled(false);
+           ui->currentLevelLabel->setText("Currently in level 3 - Programmers should be able to understand this");
+        }break;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+//                  SYSTEM SERVICE ROUTINES - SAVE/LOAD/GENERIC FUNCTIONS                   //
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+quint64 MainWindowEditMode::getThisGraphNextFreeID()
+{
+    if(m_currentGraphElements.size() == 0) // Root
+        return 0;
+
+    // Get this graph's next free ID by searching for a uniqueID free value
+    QVector<quint32> m_takenIDs;
+    for(int i=0; i<m_currentGraphElements.size(); i++)
+        m_takenIDs.append(m_currentGraphElements[i]->uniqueID);
+
+    // Search for the next available ID
+    quint64 m_newId = 0;
+    for(;;)
+    {
+        if(!m_takenIDs.contains(m_newId))
+        {
+            // Found a new ID!
+            break;
+        }
+        else
+        {
+            m_newId++;
+        }
+    }
+    return m_newId;
+}
+
+QString MainWindowEditMode::convertToRelativePath(QString fileAbsolutePath)
+{
+    return LevelStorage::convertToRelativePath(fileAbsolutePath);
+}
+
+QString MainWindowEditMode::convertToAbsolutePath(QString relativePath)
+{
+    return LevelStorage::convertToAbsolutePath(relativePath);
+}
+
+
+// Saves all consistent data serializing the tree
+void MainWindowEditMode::saveCurrentLevelDb()
+{
+    PROFILE_SCOPE("saveCurrentLevelDb");
+    gdsDebug(LOGCAT_STORAGE) << "saveCurrentLevelDb -> saving memory to disk";
+
+    // The level couldn't be loaded, its file is left as it is
+    if(m_levelLoadFailed)
+    {
+        gdsWarning(LOGCAT_STORAGE) << "saveCurrentLevelDb -> the level couldn't be loaded, nothing written";
+        return;
+    }
+
+    QString levelFile = LevelStorage::levelFilePath(m_currentActiveLevel, m_currentLevelOneID, m_currentLevelTwoID);
+
+    // If the graph is new and there's no data, save nothing
+    if(m_firstTimeGraphInCurrentLevel)
+    {
+        // Save "nothing" means that we need to check that a previous file (maybe because the root was deleted)
+        // is no more present
+        if(QFile::exists(levelFile))
+        {
+            // Delete it
+            if(!QFile::remove(levelFile))
+            {
+                QMessageBox::warning(this, "Error deleting database file", "The file \r\n"+levelFile+"\r\n is in use, thus cannot be deleted. Documentation might be corrupted.");
+            }
+        }
+        m_levelCache.invalidate(levelFile);
+        if(m_searchIndex.isBuilt())
+            m_searchIndex.removeLevel(levelFile);
+        if(m_symbolIndex.isBuilt())
+            m_symbolIndex.removeLevel(levelFile);
+
+
+        return;
+    }
+
+    // Nothing changed since the level has been read or written
+    if(!m_currentLevelDirty)
+    {
+        gdsDebug(LOGCAT_STORAGE) << "saveCurrentLevelDb -> no changes, nothing to write";
+        return;
+    }
+
+    // Memory pointers are converted into indices and every element is written on the level-specific file, the
+    // same way every other tool writes levels
+    if(!LevelStorage::writeLevelFile(levelFile, m_currentGraphElements))
+    {
+        gdsError(LOGCAT_STORAGE) << levelFile << "cannot be written";
+        QMessageBox::warning(this, "Error saving documentation", "The file \r\n"+levelFile+"\r\n cannot be written, the changes to this level haven't been saved.");
+        return;
+    }
+
+    // Just this level has changed, keep the search indices updated
+    if(m_searchIndex.isBuilt())
+        m_searchIndex.updateLevel(levelFile, m_currentGraphElements);
+    if(m_symbolIndex.isBuilt())
+        m_symbolIndex.updateLevel(levelFile, m_currentGraphElements);
+
+    m_currentLevelDirty = false;
+}
+
+// Restore all panes to their default values
+void MainWindowEditMode::clearAllPanes()
+{
+    codeEditorWidget->setPlainText("");
+    codeEditorWidget->m_selectedLines.clear();
+    txtEditorWidget->m_textEditorWin->clear();
+    ui->spinBox->setValue(0);
+    ui->txtLabel->setText("Block");
+    m_panesElement = NULL;
+}
+
+// NOTICE: this doesn't store anything on disk, just stores everything on the currently selected element
+void MainWindowEditMode::saveEverythingOnThePanesToMemory()
+{
+    if(m_currentGraphElements.size() == 0 || m_selectedElement == NULL)
+        return;
+
+    // The panes are stored every time the selection changes, the level becomes dirty only if something differs
+    dbDataStructure *element = m_selectedElement;
+    QByteArray oldData = element->data;
+    QString oldLabel = element->label;
+    QString oldFileName = element->fileName;
+    QByteArray oldFirstLineData = element->firstLineData;
+    QVector<quint32> oldLinesNumbers = element->linesNumbers;
+
+    storePanesInSelectedElement();
+
+    if(element->data != oldData || element->label != oldLabel || element->fileName != oldFileName ||
+       element->firstLineData != oldFirstLineData || element->linesNumbers != oldLinesNumbers)
+        m_currentLevelDirty = true;
+}
+
+void MainWindowEditMode::storePanesInSelectedElement()
+{
+    gdsDebug(LOGCAT_SELECTION) << "saveEverythingOnThePanesToMemory <- saving all panes in selected element";
+
+    // We can't save anything if there's no element
+    if(m_currentGraphElements.size() > 0 && m_selectedElement != NULL)
+    {
+        // Panes loaded from this element and never touched since already match it: encoding the comment and
+        // reading the highlighted lines back is what makes selection changes slow on big comments
+        bool panesFromOtherElement = (m_panesElement != m_selectedElement);
+
+        // If there's data on the right pane save it with the current element
+        if(!panesFromOtherElement && !m_commentPaneDirty)
+            gdsDebug(LOGCAT_SELECTION) << "saveEverythingOnThePanesToMemory() - comment unchanged";
+        else if(!txtEditorWidget->m_textEditorWin->document()->isEmpty() )
+        {
+            m_selectedElement->data = RichTextCodec::store(*txtEditorWidget->m_textEditorWin->document());
+        }
+        else
+            m_selectedElement->data.clear();
+
+        // If there's data on the label pane and bla bla.. same as above
+        if(!ui->txtLabel->text().isEmpty())
+        {
+            QString m_data(m_selectedElement->label);
+            if(!(m_data == ui->txtLabel->text()))
+            {
+                // Store it
+                m_selectedElement->label = ui->txtLabel->text();
+                ui->txtLabel->clear();
+                ui->txtLabel->setText(m_data);
+            }
+        }
+
+        // Save left pane lines and filename if we're on level > 1
+        if(m_currentActiveLevel != LEVEL_ONE)
+        {
+            // If nothing is selected, don't save anything
+            if(m_selectedElement->fileName.isEmpty())
+            {
+                gdsDebug(LOGCAT_SELECTION) << "saveEverythingOnThePanesToMemory() - fileName empty - can't save anything";
+                m_selectedElement->firstLineData.clear();
+                m_selectedElement->linesNumbers.clear();
+            }
+            else if(!panesFromOtherElement && !m_codePaneDirty)
+                gdsDebug(LOGCAT_SELECTION) << "saveEverythingOnThePanesToMemory() - highlighted lines unchanged";
+            // Get highlighted lines and normalize them
+            else if(codeEditorWidget->m_selectedLines.size() > 0)
+            {
+                gdsDebug(LOGCAT_SELECTION) << "saveEverythingOnThePanesToMemory() - saving lines numbers..";
+                // Every element next to the first should be an offset from the first
+                m_selectedElement->linesNumbers.clear();
+                qSort(codeEditorWidget->m_selectedLines);
+                m_selectedElement->linesNumbers.append(codeEditorWidget->m_selectedLines[0]);
+                for(int i=1; i<codeEditorWidget->m_selectedLines.size(); i++)
+                {
+                    m_selectedElement->linesNumbers.append(codeEditorWidget->m_selectedLines[i]
+                                                           -codeEditorWidget->m_selectedLines[0]);
+                }
+                gdsDebug(LOGCAT_SELECTION) << "Stored lines" << m_selectedElement->linesNumbers;
+                // Finally store the first line text data
+                m_selectedElement->firstLineData.clear();
+                m_selectedElement->firstLineData.append(codeEditorWidget->getLineData(m_selectedElement->linesNumbers[0]));
+            }
+            else
+            {
+                // Hey, also 0 selected lines is a value to be stored!
+                m_selectedElement->linesNumbers.clear();
+                m_selectedElement->firstLineData.clear();
+            }
+        }
+
+        // The panes match the element now
+        m_panesElement = m_selectedElement;
+        m_commentPaneDirty = false;
+        m_codePaneDirty = false;
+    }
+}
+
+void MainWindowEditMode::commentPaneChanged()
+{
+    m_commentPaneDirty = true;
+}
+
+void MainWindowEditMode::codePaneChanged()
+{
+    m_codePaneDirty = true;
+}
+
+// Moves the current level into the cache with its render data, the graph widget must still be showing it
+void MainWindowEditMode::cacheCurrentLevel(const QString &levelFile)
+{
+    diagramRenderData renderData;
+    GLDiagramWidget->saveRenderData(renderData);
+    // A label saved from the panes isn't drawn until the next redraw, the cached scene gets what has been saved
+    SceneModel &scene = renderData.m_scene;
+    for(int i=0; i<m_currentGraphElements.size(); i++)
+    {
+        int node = m_currentGraphElements[i]->nodeID;
+        if(node >= 0 && node < scene.size() && scene.m_labels[node] != m_currentGraphElements[i]->label)
+            scene.m_labels[node] = m_currentGraphElements[i]->label;
+    }
+    m_levelCache.storeLevel(levelFile, m_currentGraphElements, renderData);
+}
+
+// Prefetches the selected block's child level and keeps the parent chain resident, zooming in or out
+// won't need to read anything from disk
+void MainWindowEditMode::prefetchAdjacentLevels()
+{
+    if(m_selectedElement == NULL)
+        return;
+
+    switch(m_currentActiveLevel)
+    {
+        case LEVEL_ONE:
+        {
+            m_levelCache.prefetch(LevelStorage::levelFilePath(LEVEL_TWO, m_selectedElement->uniqueID, 0));
+        }break;
+        case LEVEL_TWO:
+        {
+            m_levelCache.prefetch(LevelStorage::levelFilePath(LEVEL_THREE, m_currentLevelOneID, m_selectedElement->uniqueID));
+            m_levelCache.prefetch(LevelStorage::levelFilePath(LEVEL_ONE, 0, 0));
+        }break;
+        case LEVEL_THREE:
+        {
+            m_levelCache.prefetch(LevelStorage::levelFilePath(LEVEL_TWO, m_currentLevelOneID, 0));
+            m_levelCache.prefetch(LevelStorage::levelFilePath(LEVEL_ONE, 0, 0));
+        }break;
+    }
+}
+
+// Load everything from the selected element on the panes
+void MainWindowEditMode::loadSelectedElementDataInPanes()
+{
+    PROFILE_SCOPE("loadSelectedElementDataInPanes");
+    gdsDebug(LOGCAT_SELECTION) << "Loading selected element to panes ->";
+
+    // Start loading the levels the user might zoom to while the panes are being filled
+    prefetchAdjacentLevels();
+
+    //
+    // Load the right pane with the new values for the new selected element
+    //
+    {
+        PROFILE_SCOPE("loadComment");
+        RichTextCodec::load(m_selectedElement->data, *txtEditorWidget->m_textEditorWin->document());
+    }
+    // Loading isn't a modification (the highlighted lines are set without notifications)
+    m_panesElement = m_selectedElement;
+    m_commentPaneDirty = false;
+    m_codePaneDirty = false;
+    if(m_lastSelectedHasBeenDeleted)
+        m_lastSelectedHasBeenDeleted = false;
+
+    //
+    // Load the label and spin index
+    //
+    ui->spinBox->setValue(m_selectedElement->userIndex);
+    ui->txtLabel->setText(m_selectedElement->label);
+
+    //
+    // Load the code file and add it to the combobox IF WE'RE ON LEVEL 2/3, notice that there might not be a file associated
+    //
+    if(m_currentActiveLevel == LEVEL_ONE || m_selectedElement == NULL)
+        return;
+    // If there's no file, don't load anything
+    if(m_selectedElement->fileName.isEmpty())
+    {
+        codeEditorWidget->document()->setPlainText("");
+        codeEditorWidget->m_selectedLines.clear();
+        return;
+    }
+    QString convertedAbsoluteFileName = convertToAbsolutePath(m_selectedElement->fileName);
+    if(!QFile::exists(convertedAbsoluteFileName)) // This is a relative path, convert to absolute path
+    {
+        QMessageBox::warning(this, "Error loading associated code file", "The code file associated with this element hasn't been found, the documentation might be corrupted");
+        return;
+    }
+    QFile file(convertedAbsoluteFileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return;
+    // Read the entire file and display it into the code window
+    QByteArray data = file.readAll();
+    codeEditorWidget->loadCode(data);
+    file.close();
+    if(m_recentFilePaths.size() >= 15)
+    {
+        // Remove the less recent one
+        m_recentFilePaths.remove(0);
+    }
+
+    // Add this path to the combobox and the vector (if it's not already there)
+    if(!m_recentFilePaths.contains(m_selectedElement->fileName))
+    {
+        m_recentFilePaths.append(m_selectedElement->fileName);
+        // Update combobox
+        ui->fileComboBox->clear();
+        for(int i=0;i<m_recentFilePaths.size();i++)
+            ui->fileComboBox->addItem(m_recentFilePaths[i]);
+
+        ui->fileComboBox->setCurrentIndex(ui->fileComboBox->count()-1);
+    }
+    else
+    {
+        int index = m_recentFilePaths.indexOf(m_selectedElement->fileName);
+        ui->fileComboBox->setCurrentIndex(index);
+    }
+
+    // Highlight the lines in the file we're associated to (if we have any)
+    if(m_selectedElement->linesNumbers.size() == 0)
+        return;
+    // Check for corruption (source file changed) and re-anchor the block if its first line moved
+    QStringList allLines = Reanchorer::splitSourceLines(data);
+    anchorStatus status = Reanchorer::reanchorLines(allLines, m_selectedElement->linesNumbers,
+                                                    m_selectedElement->firstLineData);
+    if(status == ANCHOR_MOVED)
+        m_currentLevelDirty = true; // The corrected lines have to be written
+    if(status == ANCHOR_BROKEN)
+    {
+        // Corrupted
+        QMessageBox::warning(this, "Error loading associated code file", "The code lines associated with this block cannot be found, the documentation might be corrupted");
+        return;
+    }
+
+    // If we get here, we've found the line OR corrected the vector, draw the lines highlighted now
+    codeEditorWidget->highlightLines(m_selectedElement->linesNumbers);
+}
+
+void MainWindowEditMode::freeCurrentGraphElements()
+{
+    // Free memory and clear elements' buffer
+    LevelStorage::freeElements(m_currentGraphElements);
+
+    m_selectedElement = NULL;
+    m_panesElement = NULL;
+}
+
+// Try to load a level database or set the m_firstTimeGraphInCurrentLevel if there isn't any. Returns false if
+// the level file cannot be decoded (the window might have gone back to the previous level)
+bool MainWindowEditMode::tryToLoadLevelDb(level lvl, bool returnToElement)
+{
+    PROFILE_SCOPE("tryToLoadLevelDb");
+    bool loadFailed = false;
+    // Whatever is loaded (or created) here has no unsaved changes yet
+    m_currentLevelDirty = false;
+    m_levelLoadFailed = false;
+    ui->addChildBlockBtn->setEnabled(true);
+    ui->deleteSelectedElementBtn->setEnabled(true);
+
+    // Check if the db directory exists in the current directory
+    if(!QDir(GDS_DIR).exists())
+    {
+        // There's nothing, not even the directory.. first time for every level
+        QDir().mkdir(GDS_DIR);
+        m_firstTimeGraphInCurrentLevel = true;
+    }
+    else
+    {
+        QString m_dbFile = LevelStorage::levelFilePath(lvl, m_currentLevelOneID, m_currentLevelTwoID);
+
+        // If the file doesn't exist or has been deleted, first time mode
+        if(!QFile(m_dbFile).exists())
+        {
+            m_firstTimeGraphInCurrentLevel = true;
+        }
+        else
+        {
+            freeCurrentGraphElements();
+
+            // De-Serialize our current data, a prefetched or recently left level is already in memory
+            if(!m_levelCache.takeLevel(m_dbFile, m_currentGraphElements, &m_cachedRenderData) || m_currentGraphElements.isEmpty())
+            {
+                gdsError(LOGCAT_STORAGE) << m_dbFile << "cannot be loaded";
+                QMessageBox::warning(this, "Error loading documentation", "The documentation file \r\n"+m_dbFile+"\r\n cannot be loaded, it might be corrupted.");
+                loadFailed = true;
+            }
+            else
+            {
+                // Draw loaded data and set root element as selected
+                m_selectedElement = m_currentGraphElements[0];
+                m_firstTimeGraphInCurrentLevel = false; // We've found data, so no need to start a new graph
+
+                // We can't draw yet if the shaders haven't been compiled (this editor always starts in level one, deeper
+                // levels find them ready) so check for them first and set a callback if they're not ready
+                if(!GLDiagramWidget->m_readyToDraw)
+                {
+                    // Signal that data is ready to be painted and exit
+                    GLDiagramWidget->m_associatedWindowRepaintScheduled = true;
+                }
+                else
+                {
+                    // Widget is ready to draw, redraw data!
+                    deferredPaintNow();
+                    // If zooming back, restore the element we zoomed into (there's nothing below level three)
+                    if(returnToElement && lvl != LEVEL_THREE)
+                    {
+                        // Retrieve the uniqueID
+                        quint64 m_zoomedID = (lvl == LEVEL_ONE) ? m_currentLevelOneID : m_currentLevelTwoID;
+                        for(int i=0; i<m_currentGraphElements.size(); i++)
+                        {
+                            if(m_zoomedID == m_currentGraphElements[i]->uniqueID)
+                            {
+                                m_selectedElement = m_currentGraphElements[i];
+                                break;
+                            }
+                        }
+                        GLDiagramWidget->changeSelectedElement(m_selectedElement->nodeID);
+                        loadSelectedElementDataInPanes();
+                    }
+                }
+            }
+        }
+    }
+
+    // The caller has already left the previous level, go back there. If there's none this level stays empty and
+    // read-only: it's not a new graph, saving it would delete the file that couldn't be read
+    if(loadFailed)
+    {
+        if(!returnToLoadedLevel())
+        {
+            m_firstTimeGraphInCurrentLevel = false;
+            m_levelLoadFailed = true;
+            ui->addChildBlockBtn->setEnabled(false);
+            ui->deleteSelectedElementBtn->setEnabled(false);
+        }
+        return false;
+    }
+    m_levelLoaded = true;
+    m_loadedLevel = lvl;
+    m_loadedLevelOneID = m_currentLevelOneID;
+    m_loadedLevelTwoID = m_currentLevelTwoID;
+    return true;
+}
+
+// The level requested cannot be loaded: go back to the last level loaded, callers have already moved the level
+// variables to the new one. Returns false if there's no level to go back to
+bool MainWindowEditMode::returnToLoadedLevel()
+{
+    freeCurrentGraphElements();
+    if(!m_levelLoaded || LevelStorage::levelFilePath(m_loadedLevel, m_loadedLevelOneID, m_loadedLevelTwoID) ==
+            LevelStorage::levelFilePath(m_currentActiveLevel, m_currentLevelOneID, m_currentLevelTwoID))
+        return false;
+
+    // If that one cannot be loaded either we stop there
+    m_levelLoaded = false;
+    m_currentActiveLevel = m_loadedLevel;
+    m_currentLevelOneID = m_loadedLevelOneID;
+    m_currentLevelTwoID = m_loadedLevelTwoID;
+    if(m_currentActiveLevel == LEVEL_ONE)
+        this->ui->containerWidget->hide();
+    else
+        this->ui->containerWidget->show();
+    GLDiagramWidget->clearGraphData();
+    tryToLoadLevelDb(m_currentActiveLevel, false);
+    updateLevelControls();
+    return true;
+}
+
@@ -1,76 +1,129 @@
-#ifndef MAINWINDOWVIEWMODE_H
-#define MAINWINDOWVIEWMODE_H
-
-#include <QMainWindow>
-#include <QMessageBox>
-#include "diagramwidget/qgldiagramwidget.h"
-#include "texteditorwin.h"
-#include "gdsdbreader.h"
-#include "cpphighlighter.h"
-#include "codeeditorwid.h"
-
-namespace Ui
-{
-    class MainWindowViewMode;
-}
-
-class MainWindowViewMode : public QMainWindow
-{
-    Q_OBJECT
-
-public:
-    explicit MainWindowViewMode(QWidget *parent = 0);
-    ~MainWindowViewMode();
-
-    friend class QGLDiagramWidget;
-
-private slots:
-    void on_goToNextLevel_clicked();
-    void on_goToPreviousLevel_clicked();
-    void on_nextStepBtn_clicked();
-
-protected:
-    void closeEvent(QCloseEvent *);
-
-private:
-    // Window components
-    Ui::MainWindowViewMode *ui;
-    QGLDiagramWidget *GLDiagramWidget;
-    QTextEdit *txtEditorWidget;
-    CppHighlighter *txtHighlighter;
-    CodeEditorWidget *codeEditorWidget;
-
-    // Generic functions and variables
-
-    bool m_graphWasClicked;
-    bool m_animationOnGoing;
-    QVector<quint32> m_currentGraphElementsAlreadyVisited;
-    void tryToLoadLevelDb(level lvl, bool returnToElement);
-    void freeCurrentGraphElements();
-    void convertDbDataToStorableData(bool m_towardsDiskFile);
-    void deferredPaintNow();
-    void updateGLGraph();
-    void loadSelectedElementDataInPanes();
-    QString convertToRelativePath(QString fileAbsolutePath);
-    QString convertToAbsolutePath(QString relativePath);
-    void clearAllPanes();
-    void GLWidgetNotifySelectionChanged(void *m_newSelection);
-    void changeSelectedElement(quint32 newSelectedElementIndex);
-
-    // -- System structures
-
-    // The current active level, this is a fundamental variable
-    level m_currentActiveLevel;
-
-    // All elements for the current active graph (and relative GL pointers)
-    QVector<dbDataStructure*> m_currentGraphElements;
-    // The selected element index for the current active graph (this is updated by the openGL widget through a function)
-    dbDataStructure* m_selectedElement;
-    // These pointers help in finding/creating the next database file while browsing zoom levels
-    quint64 m_currentLevelOneID;
-    quint64 m_currentLevelTwoID;
-    // This function gets the next free unique ID based on the elements on the graph
-    quint64 getThisGraphNextFreeID();
-};
-
-#endif // MAINWINDOWVIEWMODE_H
+#ifndef MAINWINDOWVIEWMODE_H
+#define MAINWINDOWVIEWMODE_H
+
+#include <QMainWindow>
+#include <QMessageBox>
+#include <QToolBar>
+#include <QLineEdit>
+#include <QMenu>
+#include <QTimer>
+#include <QTextDocument>
+#include "diagramwidget/qgldiagramwidget.h"
+#include "texteditorwin.h"
+#include "gdsdbreader.h"
+#include "cpphighlighter.h"
+#include "codeeditorwid.h"
+#include "levelstorage.h"
+#include "reanchorer.h"
+#include "searchindex.h"
+#include "symbolindex.h"
+#include "levelcache.h"
+#include "tourengine.h"
+#include "commentcache.h"
+#include "collapsestate.h"
+#include "profiler.h"
+#include "logger.h"
+
+namespace Ui
+{
+    class MainWindowViewMode;
+}
+
+class MainWindowViewMode : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    explicit MainWindowViewMode(QWidget *parent = 0);
+    ~MainWindowViewMode();
+
+    friend class QGLDiagramWidget;
+
+private slots:
+    void on_goToNextLevel_clicked();
+    void on_goToPreviousLevel_clicked();
+    void on_nextStepBtn_clicked();
+    void on_previousStepBtn_clicked();
+    void tourStepEdited();
+    void searchDocumentation();
+    void preloadNextComment();
+    void diagramNodeCollapseChanged(int node, bool collapsed);
+
+protected:
+    void closeEvent(QCloseEvent *);
+
+private:
+    // Window components
+    Ui::MainWindowViewMode *ui;
+    QGLDiagramWidget *GLDiagramWidget;
+    QTextEdit *txtEditorWidget;
+    CppHighlighter *txtHighlighter;
+    CodeEditorWidget *codeEditorWidget;
+
+    // Generic functions and variables
+
+    bool m_graphWasClicked;
+    bool m_animationOnGoing;
+    bool tryToLoadLevelDb(level lvl, bool returnToElement);
+    bool returnToLoadedLevel();
+    void freeCurrentGraphElements();
+    void deferredPaintNow();
+    void updateGLGraph();
+    void loadSelectedElementDataInPanes();
+    QString convertToRelativePath(QString fileAbsolutePath);
+    QString convertToAbsolutePath(QString relativePath);
+    void clearAllPanes();
+    void GLWidgetNotifySelectionChanged(int m_newSelection);
+    void changeSelectedElement(quint32 newSelectedElementIndex);
+
+    // Guided tour across levels (and the steps visited so far), its next steps are preloaded
+    TourEngine m_tourEngine;
+    bool ensureTourBuilt();
+    int currentTourStep() const;
+    void goToTourStep(int step);
+    void updateTourControls();
+
+    // Search box and the index of the entire documentation
+    QLineEdit *m_searchBox;
+    SearchIndex m_searchIndex;
+    SymbolIndex m_symbolIndex; // Used by the symbol: queries
+    void jumpToNode(const searchHit &hit);
+    void showBlock(level lvl, quint64 levelOneID, quint64 levelTwoID, quint64 uniqueID, int element, bool keepHistory);
+    void updateLevelControls();
+
+    // Parsed comments of the recently shown blocks and of the ones around the selected one
+    CommentDocumentCache m_commentDocuments;
+    QTextDocument *m_blankCommentDocument;
+    QList<QByteArray> m_commentPreloadQueue;
+    QTimer *m_commentPreloadTimer;
+    void clearCommentsPane();
+    void scheduleCommentPreloading();
+
+    // Decoded levels kept in memory and prefetched ones
+    LevelCache m_levelCache;
+    diagramRenderData m_cachedRenderData; // Render data of the level just taken from the cache (if any)
+    void cacheCurrentLevel(const QString &levelFile);
+    void prefetchAdjacentLevels();
+
+    // -- System structures
+
+    // The current active level, this is a fundamental variable
+    level m_currentActiveLevel;
+
+    // All elements for the current active graph (and relative GL pointers)
+    QVector<dbDataStructure*> m_currentGraphElements;
+    // The selected element index for the current active graph (this is updated by the openGL widget through a function)
+    dbDataStructure* m_selectedElement;
+    // These pointers help in finding/creating the next database file while browsing zoom levels
+    quint64 m_currentLevelOneID;
+    quint64 m_currentLevelTwoID;
+    // The last level loaded successfully, a level file that cannot be decoded takes us back there
+    bool m_levelLoaded;
+    level m_loadedLevel;
+    quint64 m_loadedLevelOneID;
+    quint64 m_loadedLevelTwoID;
+    // This function gets the next free unique ID based on the elements on the graph
+    quint64 getThisGraphNextFreeID();
+};
+
+#endif // MAINWINDOWVIEWMODE_H
@@ -0,0 +1,127 @@
+#ifndef NODEARENA_H
+#define NODEARENA_H
+
+// A pool allocator for the nodes of one graph. Nodes are carved out of big chunks so that a graph lies in a few
+// contiguous memory blocks instead of thousands of scattered heap allocations, and the whole graph is destroyed
+// with a single sweep over the chunks. Single nodes can still be destroyed (their slots go on a free list and are
+// reused by the next node created). The arena isn't thread-safe: every graph owns its own arena, which is only
+// touched by the thread holding the graph
+
+#include <QVector>
+#include <QSet>
+#include <new>
+
+template <class T>
+class NodeArena
+{
+public:
+    // chunkNodes is the number of nodes of every chunk, a graph whose size is known in advance fits in one chunk
+    explicit NodeArena(int chunkNodes = 1024)
+    {
+        m_chunkNodes = (chunkNodes > 0) ? chunkNodes : 1;
+        m_freeList = NULL;
+        m_usedInChunk = m_chunkNodes;
+        m_liveNodes = 0;
+    }
+
+    // Destroys every node still alive and frees the chunks
+    ~NodeArena()
+    {
+        clear();
+    }
+
+    // Allocates and default-constructs a node
+    T *create()
+    {
+        return new (allocate()) T();
+    }
+
+    // Destroys a single node created with create()
+    void destroy(T *node)
+    {
+        if(node == NULL)
+            return;
+        node->~T();
+        freeSlot *slot = reinterpret_cast<freeSlot*>(node);
+        slot->m_next = m_freeList;
+        m_freeList = slot;
+        m_liveNodes--;
+    }
+
+    // True when every node created has been destroyed
+    bool isEmpty() const
+    {
+        return m_liveNodes == 0;
+    }
+
+    // Destroys every node in a single sequential sweep and frees the chunks, the arena can be used again
+    void clear()
+    {
+        if(m_liveNodes > 0)
+        {
+            // Destroyed nodes are on the free list, skip them (there's usually none)
+            QSet<void*> freeSlots;
+            for(freeSlot *slot = m_freeList; slot != NULL; slot = slot->m_next)
+                freeSlots.insert(slot);
+
+            for(int chunk=0; chunk<m_chunks.size(); chunk++)
+            {
+                int used = (chunk == m_chunks.size() - 1) ? m_usedInChunk : m_chunkNodes;
+                for(int i=0; i<used; i++)
+                {
+                    char *p = m_chunks[chunk] + i * SLOT_SIZE;
+                    if(freeSlots.isEmpty() || !freeSlots.contains(p))
+                        reinterpret_cast<T*>(p)->~T();
+                }
+            }
+        }
+
+        for(int i=0; i<m_chunks.size(); i++)
+            ::operator delete(m_chunks[i]);
+        m_chunks.clear();
+        m_freeList = NULL;
+        m_usedInChunk = m_chunkNodes;
+        m_liveNodes = 0;
+    }
+
+private:
+    struct freeSlot
+    {
+        freeSlot *m_next;
+    };
+    // A slot must hold a node or a free list link, sizeof(T) is a multiple of T's alignment so nodes stay aligned
+    enum { SLOT_SIZE = (sizeof(T) > sizeof(freeSlot)) ? sizeof(T) : sizeof(freeSlot) };
+
+    QVector<char*> m_chunks;
+    int m_chunkNodes;
+    freeSlot *m_freeList;
+    int m_usedInChunk; // Slots handed out from the last chunk
+    int m_liveNodes;
+
+    // Raw storage for one node, a destroyed node's slot first
+    void *allocate()
+    {
+        m_liveNodes++;
+
+        if(m_freeList != NULL)
+        {
+            freeSlot *slot = m_freeList;
+            m_freeList = slot->m_next;
+            return slot;
+        }
+
+        if(m_usedInChunk == m_chunkNodes)
+        {
+            m_chunks.append(static_cast<char*>(::operator new(SLOT_SIZE * m_chunkNodes)));
+            m_usedInChunk = 0;
+        }
+
+        return m_chunks.last() + (m_usedInChunk++) * SLOT_SIZE;
+    }
+
+    // Not copyable
+    NodeArena(const NodeArena&);
+    NodeArena& operator=(const NodeArena&);
+};
+
+#endif // NODEARENA_H
@@ -0,0 +1,171 @@
+#include "profiler.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
+
+// Events recorded with this thread ID come from GPU timer queries
+#define PROFILER_GPU_THREAD 0
+
+struct profileEvent
+{
+    const char *name;
+    qint64 start;
+    qint64 duration;
+    quintptr thread;
+};
+
+// Shown by the overlay
+struct operationStats
+{
+    qint64 last;
+    double average; // Moving average, recent events weigh more
+    int count;
+};
+
+volatile bool Profiler::m_enabled = false;
+
+static QMutex profilerMutex;
+static QElapsedTimer profilerClock;
+static QVector<profileEvent> profilerEvents; // Ring buffer, allocated the first time the profiler is enabled
+static int profilerNextEvent = 0;
+static bool profilerWrapped = false;
+static QHash<const char*, operationStats> profilerStats;
+
+void Profiler::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&profilerMutex);
+    if(enabled && profilerEvents.isEmpty())
+    {
+        profilerEvents.resize(MAX_EVENTS);
+        profilerClock.start();
+    }
+    m_enabled = enabled;
+}
+
+qint64 Profiler::now()
+{
+    return profilerClock.nsecsElapsed();
+}
+
+// Adds an event to the ring buffer and updates its operation's stats
+static void addEvent(const char *name, qint64 start, qint64 duration, quintptr thread)
+{
+    QMutexLocker locker(&profilerMutex);
+    if(profilerEvents.isEmpty())
+        return;
+
+    profileEvent &event = profilerEvents[profilerNextEvent];
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.thread = thread;
+    profilerNextEvent++;
+    if(profilerNextEvent == profilerEvents.size())
+    {
+        profilerNextEvent = 0;
+        profilerWrapped = true;
+    }
+
+    operationStats &stats = profilerStats[name];
+    if(stats.count == 0)
+        stats.average = duration;
+    else
+        stats.average = stats.average * 0.9 + duration * 0.1;
+    stats.last = duration;
+    stats.count++;
+}
+
+void Profiler::record(const char *name, qint64 start, qint64 duration)
+{
+    addEvent(name, start, duration, (quintptr)QThread::currentThreadId());
+}
+
+void Profiler::recordGpu(const char *name, qint64 duration)
+{
+    addEvent(name, now() - duration, duration, PROFILER_GPU_THREAD);
+}
+
+QStringList Profiler::overlayLines()
+{
+    QMutexLocker locker(&profilerMutex);
+
+    // Names recorded from different files might be different pointers to the same text, merge them
+    QMap<QString, operationStats> merged;
+    QHash<const char*, operationStats>::const_iterator itr = profilerStats.constBegin();
+    while(itr != profilerStats.constEnd())
+    {
+        operationStats &stats = merged[QString(itr.key())];
+        int count = stats.count + itr.value().count;
+        if(itr.value().count > stats.count)
+            stats = itr.value();
+        stats.count = count;
+        itr++;
+    }
+
+    // Slowest first
+    QMap<double, QString> byAverage;
+    QMap<QString, operationStats>::const_iterator op = merged.constBegin();
+    while(op != merged.constEnd())
+    {
+        byAverage.insertMulti(-op.value().average, QString("%1  last %2 ms  avg %3 ms  (%4)").arg(op.key())
+                              .arg(op.value().last / 1000000.0, 0, 'f', 2).arg(op.value().average / 1000000.0, 0, 'f', 2)
+                              .arg(op.value().count));
+        op++;
+    }
+    return byAverage.values();
+}
+
+bool Profiler::writeChromeTrace(const QString &path)
+{
+    QFile file(path);
+    if(!file.open(QFile::WriteOnly | QFile::Text))
+        return false;
+
+    QMutexLocker locker(&profilerMutex);
+
+    // Oldest event first, threads get small IDs in order of appearance (0 is the GPU). Traces are written by
+    // the main thread
+    int count = profilerWrapped ? profilerEvents.size() : profilerNextEvent;
+    int first = profilerWrapped ? profilerNextEvent : 0;
+    QHash<quintptr, int> threadIDs;
+    threadIDs.insert(PROFILER_GPU_THREAD, 0);
+    quintptr mainThread = (quintptr)QThread::currentThreadId();
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << endl;
+    out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"GPU\"}}";
+    for(int i=0; i<count; i++)
+    {
+        const profileEvent &event = profilerEvents[(first + i) % profilerEvents.size()];
+        if(!threadIDs.contains(event.thread))
+        {
+            int tid = threadIDs.size();
+            threadIDs.insert(event.thread, tid);
+            out << "," << endl << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tid
+                << ", \"args\": {\"name\": \"" << (event.thread == mainThread ? QString("main") : QString("thread %1").arg(tid))
+                << "\"}}";
+        }
+        // Timestamps are in microseconds
+        out << "," << endl << "{\"name\": \"" << event.name << "\", \"cat\": \"gds\", \"ph\": \"X\", \"pid\": 1, "
+            << "\"tid\": " << threadIDs.value(event.thread) << ", \"ts\": " << QString::number(event.start / 1000.0, 'f', 3)
+            << ", \"dur\": " << QString::number(event.duration / 1000.0, 'f', 3) << "}";
+    }
+    out << endl << "]}" << endl;
+
+    file.close();
+    return true;
+}
+
+void Profiler::clear()
+{
+    QMutexLocker locker(&profilerMutex);
+    profilerNextEvent = 0;
+    profilerWrapped = false;
+    profilerStats.clear();
+}
@@ -0,0 +1,63 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Instrumentation of the operations navigation is made of (reading/saving levels, layout, painting, filling the
+// panes, highlighting). Scoped timers record events into a ring buffer, their recent durations are shown by the
+// diagram widget's overlay (F12) and the whole buffer can be written as a Chrome trace (chrome://tracing).
+// Recording is off unless the overlay is shown or gds is started with --profile/--trace, a disabled timer
+// costs a single check
+
+#include <QString>
+#include <QStringList>
+
+class Profiler
+{
+public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return m_enabled; }
+    // Nanoseconds since the profiler has been enabled the first time
+    static qint64 now();
+
+    // Thread-safe, names must be string literals (they're stored as pointers)
+    static void record(const char *name, qint64 start, qint64 duration);
+    // GPU durations are known some frames later, they're placed right before the moment they're recorded
+    static void recordGpu(const char *name, qint64 duration);
+
+    // One line per operation with its last and average duration, slowest first
+    static QStringList overlayLines();
+    // Writes every event still in the ring buffer as Chrome's trace event format (JSON)
+    static bool writeChromeTrace(const QString &path);
+    static void clear();
+
+    // Events kept, the oldest ones are overwritten
+    static const int MAX_EVENTS = 64 * 1024;
+
+private:
+    static volatile bool m_enabled;
+};
+
+// Records the time spent in the enclosing scope
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char *name)
+    {
+        m_name = name;
+        m_start = Profiler::isEnabled() ? Profiler::now() : -1;
+    }
+    ~ProfileScope()
+    {
+        if(m_start >= 0)
+            Profiler::record(m_name, m_start, Profiler::now() - m_start);
+    }
+
+private:
+    const char *m_name;
+    qint64 m_start;
+};
+
+#define PROFILE_SCOPE_CONCAT2(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_SCOPE_CONCAT(profileScope, __LINE__)(name)
+
+#endif // PROFILER_H
@@ -0,0 +1,162 @@
+#include "projectreader.h"
+#include "levelstorage.h"
+#include "logger.h"
+#include <QRunnable>
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+
+// How many levels can be decoded ahead of the consumer for each decoding thread
+#define PROJECTREADER_LEVELS_AHEAD 2
+
+void ProjectLevelConsumer::levelFailed(int index, const QString &levelFile)
+{
+    Q_UNUSED(index);
+    gdsWarning(LOGCAT_STORAGE) << "ProjectReader - cannot read " << levelFile;
+}
+
+// Shared between the reading thread and the decoding tasks
+struct projectReadState
+{
+    QMutex mutex;
+    QWaitCondition levelDone;
+    QVector< QVector<dbDataStructure*> > graphs;
+    QVector<bool> done;
+    QVector<bool> failed;
+};
+
+// One of these tasks is created for each level file
+class levelDecodeTask : public QRunnable
+{
+public:
+    projectReadState *m_state;
+    int m_index;
+    QString m_levelFile;
+
+    void run()
+    {
+        QVector<dbDataStructure*> elements;
+        bool ok = LevelStorage::readLevelFile(m_levelFile, elements);
+
+        QMutexLocker locker(&m_state->mutex);
+        m_state->graphs[m_index] = elements;
+        m_state->failed[m_index] = !ok;
+        m_state->done[m_index] = true;
+        m_state->levelDone.wakeAll();
+    }
+};
+
+// Used by readAll(), just keeps everything
+class graphsCollector : public ProjectLevelConsumer
+{
+public:
+    QVector< QVector<dbDataStructure*> > *m_graphs;
+
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(levelFile);
+        (*m_graphs)[index] = elements;
+        return true;
+    }
+};
+
+ProjectReader::ProjectReader()
+{
+    m_maxThreadCount = 0;
+    m_levelsCount = 0;
+    m_failedCount = 0;
+    m_blocksCount = 0;
+    m_elapsedMs = 0;
+}
+
+void ProjectReader::setMaxThreadCount(int count)
+{
+    m_maxThreadCount = count;
+}
+
+int ProjectReader::read(const QStringList &levelFiles, ProjectLevelConsumer *consumer)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_levelsCount = 0;
+    m_failedCount = 0;
+    m_blocksCount = 0;
+
+    projectReadState state;
+    state.graphs.resize(levelFiles.size());
+    state.done.fill(false, levelFiles.size());
+    state.failed.fill(false, levelFiles.size());
+
+    QThreadPool pool;
+    if(m_maxThreadCount > 0)
+        pool.setMaxThreadCount(m_maxThreadCount);
+    int levelsAhead = pool.maxThreadCount() * PROJECTREADER_LEVELS_AHEAD;
+
+    int started = 0;
+    for(int next=0; next<levelFiles.size(); next++)
+    {
+        // Keep the pool busy but don't decode too far ahead of the consumer
+        while(started < levelFiles.size() && started - next < levelsAhead)
+        {
+            levelDecodeTask *task = new levelDecodeTask();
+            task->m_state = &state;
+            task->m_index = started;
+            task->m_levelFile = levelFiles[started];
+            pool.start(task);
+            started++;
+        }
+
+        // Levels are delivered in order, wait for the next one if it's still being decoded
+        QVector<dbDataStructure*> elements;
+        bool failed;
+        state.mutex.lock();
+        while(!state.done[next])
+            state.levelDone.wait(&state.mutex);
+        elements = state.graphs[next];
+        state.graphs[next].clear();
+        failed = state.failed[next];
+        state.mutex.unlock();
+
+        if(failed)
+        {
+            m_failedCount++;
+            consumer->levelFailed(next, levelFiles[next]);
+            continue;
+        }
+
+        m_levelsCount++;
+        m_blocksCount += elements.size();
+        if(!consumer->levelDecoded(next, levelFiles[next], elements))
+            LevelStorage::freeElements(elements);
+    }
+    pool.waitForDone();
+
+    m_elapsedMs = timer.elapsed();
+    return m_levelsCount;
+}
+
+int ProjectReader::readAll(const QStringList &levelFiles, QVector< QVector<dbDataStructure*> > &graphs)
+{
+    graphs.clear();
+    graphs.resize(levelFiles.size());
+
+    graphsCollector collector;
+    collector.m_graphs = &graphs;
+    return read(levelFiles, &collector);
+}
+
+double ProjectReader::levelsPerSecond() const
+{
+    if(m_elapsedMs <= 0)
+        return 0.0;
+    return m_levelsCount * 1000.0 / m_elapsedMs;
+}
+
+QString ProjectReader::summary() const
+{
+    return QString("%1 levels (%2 blocks) decoded in %3 ms, %4 levels/s%5").arg(m_levelsCount).arg(m_blocksCount)
+            .arg(m_elapsedMs).arg(levelsPerSecond(), 0, 'f', 1)
+            .arg(m_failedCount > 0 ? QString(", %1 unreadable").arg(m_failedCount) : QString());
+}
@@ -0,0 +1,58 @@
+#ifndef PROJECTREADER_H
+#define PROJECTREADER_H
+
+// Project-wide reading of level files with no window involved: files are opened and decoded (decompression is
+// the expensive part) by a pool of worker threads while the already decoded levels are handed to a consumer.
+// Used by everything that needs the whole documentation (indices building, batch jobs, exporting)
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "gdsdbreader.h"
+
+// Receives the decoded levels. Calls are made in the same order as the level files list and on the thread
+// that called ProjectReader::read(), so consumers don't need to be thread-safe
+class ProjectLevelConsumer
+{
+public:
+    virtual ~ProjectLevelConsumer() {}
+
+    // A level has been decoded (father/children pointers are already restored). Returning true means the consumer
+    // keeps the elements and will free them, otherwise they're freed as soon as this returns
+    virtual bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements) = 0;
+    // A level file couldn't be read
+    virtual void levelFailed(int index, const QString &levelFile);
+};
+
+class ProjectReader
+{
+public:
+    ProjectReader();
+
+    // Number of decoding threads, 0 (the default) uses one thread per core
+    void setMaxThreadCount(int count);
+
+    // Decodes every level file and streams them to the consumer, returns the number of levels decoded.
+    // Only a few levels at a time are decoded ahead of the consumer, memory doesn't grow with the project size
+    int read(const QStringList &levelFiles, ProjectLevelConsumer *consumer);
+    // Decodes every level file into graphs (indexed as levelFiles, unreadable levels are left empty).
+    // Elements are owned by the caller
+    int readAll(const QStringList &levelFiles, QVector< QVector<dbDataStructure*> > &graphs);
+
+    // Statistics of the last read
+    int levelsCount() const { return m_levelsCount; }
+    int failedCount() const { return m_failedCount; }
+    int blocksCount() const { return m_blocksCount; }
+    qint64 elapsedMs() const { return m_elapsedMs; }
+    double levelsPerSecond() const;
+    QString summary() const;
+
+private:
+    int m_maxThreadCount;
+    int m_levelsCount;
+    int m_failedCount;
+    int m_blocksCount;
+    qint64 m_elapsedMs;
+};
+
+#endif // PROJECTREADER_H
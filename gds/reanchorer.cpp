@@ -0,0 +1,266 @@
+#include "reanchorer.h"
+#include "levelstorage.h"
+#include "projectreader.h"
+#include "logger.h"
+#include <QFile>
+#include <QMap>
+#include <QSet>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <stdio.h>
+
+QStringList Reanchorer::splitSourceLines(const QByteArray &data)
+{
+    QStringList lines = QString(data).split('\n', QString::KeepEmptyParts);
+    // Files might have been read without text-mode translation, drop the carriage returns
+    for(int i=0; i<lines.size(); i++)
+    {
+        if(lines[i].endsWith('\r'))
+            lines[i].chop(1);
+    }
+    return lines;
+}
+
+bool Reanchorer::readSourceLines(const QString &fileName, QStringList &lines)
+{
+    QFile file(LevelStorage::convertToAbsolutePath(fileName));
+    if(!file.open(QFile::ReadOnly | QFile::Text))
+        return false;
+    lines = splitSourceLines(file.readAll());
+    file.close();
+    return true;
+}
+
+anchorStatus Reanchorer::reanchorLines(const QStringList &sourceLines, QVector<quint32> &linesNumbers,
+                                       const QByteArray &firstLineData)
+{
+    if(linesNumbers.size() == 0)
+        return ANCHOR_UNCHANGED; // Nothing to anchor
+
+    QString anchorText(firstLineData);
+    qint64 firstLine = linesNumbers[0];
+    qint64 numLines = sourceLines.size();
+
+    // Find textually the first line
+    if(firstLine < numLines && sourceLines[(int)firstLine] == anchorText)
+        return ANCHOR_UNCHANGED;
+
+    // Search near it for matchings, the nearest one wins (forward first if at the same distance)
+    qint64 maxDistance = qMax(firstLine, numLines - firstLine);
+    for(qint64 i=1; i<=maxDistance; i++)
+    {
+        if(firstLine+i < numLines && sourceLines[(int)(firstLine+i)] == anchorText)
+        {
+            // Found, update with +i offset
+            linesNumbers[0] = firstLine+i;
+            return ANCHOR_MOVED;
+        }
+        if(firstLine-i >= 0 && firstLine-i < numLines && sourceLines[(int)(firstLine-i)] == anchorText)
+        {
+            // Found, update with -i offset
+            linesNumbers[0] = firstLine-i;
+            return ANCHOR_MOVED;
+        }
+    }
+
+    // Corrupted
+    return ANCHOR_BROKEN;
+}
+
+
+
+// One of these tasks is created for each code file, it owns all the blocks referencing that file
+// so no synchronization is needed between tasks
+class sourceFileReanchorTask : public QRunnable
+{
+public:
+    QString m_fileName;
+    QVector<dbDataStructure*> m_blocks;
+    QVector<QString> m_blocksLevelFiles;
+    QVector<reanchorEntry> m_results;
+
+    void run()
+    {
+        QStringList sourceLines;
+        bool fileFound = Reanchorer::readSourceLines(m_fileName, sourceLines);
+
+        for(int i=0; i<m_blocks.size(); i++)
+        {
+            dbDataStructure *block = m_blocks[i];
+
+            reanchorEntry entry;
+            entry.levelFile = m_blocksLevelFiles[i];
+            entry.uniqueID = block->uniqueID;
+            entry.label = block->label;
+            entry.fileName = m_fileName;
+            entry.oldLine = block->linesNumbers[0];
+            entry.status = fileFound ? Reanchorer::reanchorLines(sourceLines, block->linesNumbers, block->firstLineData)
+                                     : ANCHOR_MISSING_FILE;
+            entry.newLine = block->linesNumbers[0];
+
+            // Only store what has to be reported
+            if(entry.status != ANCHOR_UNCHANGED)
+                m_results.append(entry);
+        }
+    }
+};
+
+BatchReanchorJob::BatchReanchorJob(bool writeBack)
+{
+    m_writeBack = writeBack;
+    m_levelsCount = 0;
+    m_blocksCount = 0;
+    m_sourceFilesCount = 0;
+    m_elapsedMs = 0;
+}
+
+BatchReanchorJob::~BatchReanchorJob()
+{
+}
+
+bool BatchReanchorJob::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_entries.clear();
+
+    // 1) Load every level file of the project
+    QStringList levelFiles = LevelStorage::allLevelFiles();
+    if(levelFiles.isEmpty())
+        return false;
+
+    // Levels are decoded in parallel, unreadable ones are left empty
+    QVector< QVector<dbDataStructure*> > graphs;
+    ProjectReader reader;
+    reader.readAll(levelFiles, graphs);
+    m_levelsCount = levelFiles.size();
+
+    // 2) Group the anchored blocks by code file, each file will be loaded just once
+    QMap<QString, sourceFileReanchorTask*> tasks;
+    m_blocksCount = 0;
+    for(int i=0; i<graphs.size(); i++)
+    {
+        for(int j=0; j<graphs[i].size(); j++)
+        {
+            dbDataStructure *block = graphs[i][j];
+            if(block->fileName.isEmpty() || block->linesNumbers.size() == 0)
+                continue;
+
+            sourceFileReanchorTask *task = tasks.value(block->fileName, NULL);
+            if(task == NULL)
+            {
+                task = new sourceFileReanchorTask();
+                task->setAutoDelete(false);
+                task->m_fileName = block->fileName;
+                tasks.insert(block->fileName, task);
+            }
+            task->m_blocks.append(block);
+            task->m_blocksLevelFiles.append(levelFiles[i]);
+            m_blocksCount++;
+        }
+    }
+    m_sourceFilesCount = tasks.size();
+
+    // 3) Re-anchor every code file's blocks in parallel
+    QThreadPool pool;
+    QMap<QString, sourceFileReanchorTask*>::iterator itr = tasks.begin();
+    while(itr != tasks.end())
+    {
+        pool.start(itr.value());
+        itr++;
+    }
+    pool.waitForDone();
+
+    // 4) Collect the results (ordered by code file since the map is sorted) and find out which levels changed
+    QSet<QString> changedLevelFiles;
+    itr = tasks.begin();
+    while(itr != tasks.end())
+    {
+        const QVector<reanchorEntry> &results = itr.value()->m_results;
+        for(int i=0; i<results.size(); i++)
+        {
+            m_entries.append(results[i]);
+            if(results[i].status == ANCHOR_MOVED)
+                changedLevelFiles.insert(results[i].levelFile);
+        }
+        delete itr.value();
+        itr++;
+    }
+
+    // 5) Store the moved anchors and free everything
+    for(int i=0; i<graphs.size(); i++)
+    {
+        if(m_writeBack && changedLevelFiles.contains(levelFiles[i]))
+        {
+            if(!LevelStorage::writeLevelFile(levelFiles[i], graphs[i]))
+                gdsError(LOGCAT_STORAGE) << "BatchReanchorJob - cannot write " << levelFiles[i];
+        }
+        LevelStorage::freeElements(graphs[i]);
+    }
+
+    m_elapsedMs = timer.elapsed();
+    return true;
+}
+
+int BatchReanchorJob::movedCount() const
+{
+    int count = 0;
+    for(int i=0; i<m_entries.size(); i++)
+    {
+        if(m_entries[i].status == ANCHOR_MOVED)
+            count++;
+    }
+    return count;
+}
+
+int BatchReanchorJob::brokenCount() const
+{
+    return m_entries.size() - movedCount();
+}
+
+QString BatchReanchorJob::summary() const
+{
+    return QString("levels: %1, anchored blocks: %2, code files: %3, moved: %4, broken: %5, elapsed: %6 ms")
+            .arg(m_levelsCount).arg(m_blocksCount).arg(m_sourceFilesCount)
+            .arg(movedCount()).arg(brokenCount()).arg(m_elapsedMs);
+}
+
+bool BatchReanchorJob::writeReport(const QString &reportPath) const
+{
+    QFile file;
+    if(reportPath.isEmpty())
+    {
+        if(!file.open(stdout, QFile::WriteOnly | QFile::Text))
+            return false;
+    }
+    else
+    {
+        file.setFileName(reportPath);
+        if(!file.open(QFile::WriteOnly | QFile::Text))
+            return false;
+    }
+
+    // One line per reported block: status, level file, uniqueID, code file, old -> new line, label
+    QTextStream out(&file);
+    out << "# gds re-anchoring report" << endl;
+    out << "# " << summary() << endl;
+    for(int i=0; i<m_entries.size(); i++)
+    {
+        const reanchorEntry &entry = m_entries[i];
+        switch(entry.status)
+        {
+            case ANCHOR_MOVED: out << "MOVED"; break;
+            case ANCHOR_BROKEN: out << "BROKEN"; break;
+            case ANCHOR_MISSING_FILE: out << "MISSING"; break;
+            default: out << "UNCHANGED"; break;
+        }
+        out << "\t" << entry.levelFile << "\t" << entry.uniqueID << "\t" << entry.fileName
+            << "\t" << entry.oldLine << "\t" << entry.newLine << "\t" << entry.label << endl;
+    }
+
+    file.close();
+    return true;
+}
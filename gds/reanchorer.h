@@ -0,0 +1,74 @@
+#ifndef REANCHORER_H
+#define REANCHORER_H
+
+// Level 2/3 blocks are anchored to their code file by the first highlighted line number and its text
+// (firstLineData). When the code file changes, the anchor has to be searched again near its old position
+// (re-anchoring). This is done lazily when a block is selected and in batch for the entire project
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QByteArray>
+#include "gdsdbreader.h"
+
+enum anchorStatus {ANCHOR_UNCHANGED, ANCHOR_MOVED, ANCHOR_BROKEN, ANCHOR_MISSING_FILE};
+
+class Reanchorer
+{
+public:
+    // Splits a code file's content into lines the same way the code editor numbers them
+    static QStringList splitSourceLines(const QByteArray &data);
+    // Reads and splits a code file (relative paths are resolved), returns false if it cannot be read
+    static bool readSourceLines(const QString &fileName, QStringList &lines);
+
+    // Re-anchors the first line of a block against its code file lines: if the first line text isn't
+    // where it was, the nearest line with the same text is searched (both forward and backward) and
+    // linesNumbers[0] is updated. Next lines don't need to be updated since they're relative to the first
+    static anchorStatus reanchorLines(const QStringList &sourceLines, QVector<quint32> &linesNumbers,
+                                      const QByteArray &firstLineData);
+};
+
+// A single re-anchored block, as reported by the batch job
+struct reanchorEntry
+{
+    QString levelFile;
+    quint64 uniqueID;
+    QString label;
+    QString fileName;
+    quint32 oldLine;
+    quint32 newLine;
+    anchorStatus status;
+};
+
+// Project-wide re-anchoring: every level file is loaded, blocks are grouped by code file and each code
+// file is read once and used to re-anchor all of its blocks. Code files are processed in parallel
+class BatchReanchorJob
+{
+public:
+    explicit BatchReanchorJob(bool writeBack);
+    ~BatchReanchorJob();
+
+    // Runs the job on the GDS_DIR directory, returns false if the documentation cannot be read
+    bool run();
+    // Writes a textual report with every moved/broken anchor, an empty path writes it on stdout
+    bool writeReport(const QString &reportPath) const;
+    QString summary() const;
+
+    int levelsCount() const { return m_levelsCount; }
+    int blocksCount() const { return m_blocksCount; }
+    int sourceFilesCount() const { return m_sourceFilesCount; }
+    int movedCount() const;
+    int brokenCount() const;
+
+    // Every block that has been moved or that couldn't be re-anchored
+    QVector<reanchorEntry> m_entries;
+
+private:
+    bool m_writeBack; // If set, level files with moved anchors are saved
+    int m_levelsCount;
+    int m_blocksCount;
+    int m_sourceFilesCount;
+    qint64 m_elapsedMs;
+};
+
+#endif // REANCHORER_H
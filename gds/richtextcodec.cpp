@@ -0,0 +1,243 @@
+#include "richtextcodec.h"
+#include "richtextformat.h"
+#include <QTextDocument>
+#include <QTextCursor>
+#include <QTextBlock>
+#include <QTextFrame>
+#include <QTextList>
+#include <QDataStream>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+
+// Index of a format into the styles table, formats used more than once are stored once. Comments use a handful
+// of formats, a linear search is cheaper than hashing their properties
+static qint32 styleIndex(QVector<QTextFormat> &styles, const QTextFormat &format)
+{
+    for(int i=0; i<styles.size(); i++)
+    {
+        if(styles[i] == format)
+            return i;
+    }
+    styles.append(format);
+    return styles.size() - 1;
+}
+
+static QTextFormat style(const QVector<QTextFormat> &styles, qint32 index)
+{
+    if(index < 0 || index >= styles.size())
+        return QTextFormat();
+    return styles[index];
+}
+
+// Embedded images are data urls ("data:image//png;base64,..."), their bytes are stored decoded. An url that
+// wouldn't be written back the same (e.g. an external image) is kept whole as the header
+static void splitImageUrl(const QString &url, QByteArray &header, QByteArray &bytes)
+{
+    int base64 = url.indexOf(";base64,");
+    if(url.startsWith("data:") && base64 != -1)
+    {
+        QByteArray encoded = url.mid(base64 + 8).toLatin1();
+        bytes = QByteArray::fromBase64(encoded);
+        if(bytes.toBase64() == encoded)
+        {
+            header = url.left(base64 + 8).toUtf8();
+            return;
+        }
+    }
+    header = url.toUtf8();
+    bytes.clear();
+}
+
+QByteArray RichTextCodec::encode(const QTextDocument &document)
+{
+    if(!document.rootFrame()->childFrames().isEmpty())
+        return QByteArray();
+
+    QVector<QTextFormat> styles;
+    QVector<qint32> lists;                  // Style of every list
+    QHash<QTextList*, int> listIndices;
+    QVector< QPair<QByteArray, QByteArray> > images;
+    QHash<QString, int> imageIndices;       // Keyed by url, an image used twice is stored once
+
+    QByteArray blocksData;
+    QDataStream blocksOut(&blocksData, QIODevice::WriteOnly);
+    blocksOut << (qint32)document.blockCount();
+    for(QTextBlock block = document.begin(); block.isValid(); block = block.next())
+    {
+        qint32 list = -1;
+        QTextList *textList = block.textList();
+        if(textList != NULL)
+        {
+            if(!listIndices.contains(textList))
+            {
+                listIndices.insert(textList, lists.size());
+                lists.append(styleIndex(styles, textList->format()));
+            }
+            list = listIndices.value(textList);
+        }
+
+        QVector< QPair<QByteArray, qint32> > runs;
+        for(QTextBlock::iterator itr = block.begin(); !itr.atEnd(); ++itr)
+        {
+            QTextFragment fragment = itr.fragment();
+            if(!fragment.isValid())
+                continue;
+
+            QTextCharFormat format = fragment.charFormat();
+            if(format.isImageFormat())
+            {
+                QTextImageFormat image = format.toImageFormat();
+                int index = imageIndices.value(image.name(), -1);
+                if(index == -1)
+                {
+                    QPair<QByteArray, QByteArray> entry;
+                    splitImageUrl(image.name(), entry.first, entry.second);
+                    index = images.size();
+                    images.append(entry);
+                    imageIndices.insert(image.name(), index);
+                }
+                image.setName(RichTextFormat::imageReference(index));
+                format = image;
+            }
+            runs.append(qMakePair(fragment.text().toUtf8(), styleIndex(styles, format)));
+        }
+
+        // List membership is the list's object index, lists are stored apart and rebuilt when decoding
+        QTextBlockFormat blockFormat = block.blockFormat();
+        blockFormat.clearProperty(QTextFormat::ObjectIndex);
+        blocksOut << styleIndex(styles, blockFormat) << styleIndex(styles, block.charFormat()) << list
+                  << (qint32)runs.size();
+        for(int i=0; i<runs.size(); i++)
+            blocksOut << runs[i].first << runs[i].second;
+    }
+
+    QByteArray stylesData;
+    QDataStream stylesOut(&stylesData, QIODevice::WriteOnly);
+    stylesOut << styles << lists;
+
+    QByteArray imagesData;
+    QDataStream imagesOut(&imagesData, QIODevice::WriteOnly);
+    imagesOut << (qint32)images.size();
+    for(int i=0; i<images.size(); i++)
+        imagesOut << images[i].first << images[i].second;
+
+    QByteArray data;
+    data.reserve(16 + stylesData.size() + imagesData.size() + blocksData.size());
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << RichTextFormat::MAGIC << RichTextFormat::VERSION << stylesData << imagesData;
+    out.writeRawData(blocksData.constData(), blocksData.size());
+    return data;
+}
+
+bool RichTextCodec::decode(const QByteArray &data, QTextDocument &document)
+{
+    // Loading isn't something to undo
+    bool undoRedo = document.isUndoRedoEnabled();
+    document.setUndoRedoEnabled(false);
+    document.clear();
+
+    bool decoded = false;
+    if(RichTextFormat::isCompact(data))
+    {
+        QDataStream in(data);
+        quint32 magic, version;
+        QByteArray stylesData, imagesData;
+        in >> magic >> version >> stylesData >> imagesData;
+
+        QVector<QTextFormat> styles;
+        QVector<qint32> lists;
+        QDataStream stylesIn(stylesData);
+        stylesIn >> styles >> lists;
+
+        QVector<QString> imageUrls;
+        QDataStream imagesIn(imagesData);
+        qint32 imagesCount;
+        imagesIn >> imagesCount;
+        for(int i=0; i<imagesCount && imagesIn.status() == QDataStream::Ok; i++)
+        {
+            QByteArray header, bytes;
+            imagesIn >> header >> bytes;
+            imageUrls.append(QString::fromUtf8(header) + QString::fromLatin1(bytes.toBase64()));
+        }
+
+        qint32 blocksCount;
+        in >> blocksCount;
+        decoded = (version <= RichTextFormat::VERSION && in.status() == QDataStream::Ok &&
+                   stylesIn.status() == QDataStream::Ok && imagesIn.status() == QDataStream::Ok);
+
+        QTextCursor cursor(&document);
+        cursor.beginEditBlock();
+        QVector<QTextList*> textLists(lists.size(), NULL);
+        for(int i=0; i<blocksCount && decoded; i++)
+        {
+            qint32 blockFormat, charFormat, list, runsCount;
+            in >> blockFormat >> charFormat >> list >> runsCount;
+            if(i == 0)
+            {
+                cursor.setBlockFormat(style(styles, blockFormat).toBlockFormat());
+                cursor.setBlockCharFormat(style(styles, charFormat).toCharFormat());
+            }
+            else
+                cursor.insertBlock(style(styles, blockFormat).toBlockFormat(), style(styles, charFormat).toCharFormat());
+
+            if(list >= 0 && list < lists.size())
+            {
+                if(textLists[list] == NULL)
+                    textLists[list] = cursor.createList(style(styles, lists[list]).toListFormat());
+                else
+                    textLists[list]->add(cursor.block());
+            }
+
+            for(int j=0; j<runsCount && in.status() == QDataStream::Ok; j++)
+            {
+                QByteArray text;
+                qint32 format;
+                in >> text >> format;
+                QTextCharFormat runFormat = style(styles, format).toCharFormat();
+                if(runFormat.isImageFormat())
+                {
+                    // A run of images is the same image more times in a row, one replacement character each
+                    QTextImageFormat image = runFormat.toImageFormat();
+                    int index = RichTextFormat::imageFromReference(image.name());
+                    if(index >= 0 && index < imageUrls.size())
+                        image.setName(imageUrls[index]);
+                    int count = QString::fromUtf8(text.constData(), text.size()).length();
+                    for(int k=0; k<count; k++)
+                        cursor.insertImage(image);
+                }
+                else
+                    cursor.insertText(QString::fromUtf8(text.constData(), text.size()), runFormat);
+            }
+            decoded = (in.status() == QDataStream::Ok);
+        }
+        cursor.endEditBlock();
+
+        if(!decoded)
+            document.clear();
+    }
+
+    document.setUndoRedoEnabled(undoRedo);
+    return decoded;
+}
+
+QByteArray RichTextCodec::store(const QTextDocument &document)
+{
+    QByteArray data = encode(document);
+    if(data.isEmpty())
+        data.append(document.toHtml());
+    return data;
+}
+
+void RichTextCodec::load(const QByteArray &comment, QTextDocument &document)
+{
+    if(RichTextFormat::isCompact(comment))
+        decode(comment, document);
+    else
+    {
+        bool undoRedo = document.isUndoRedoEnabled();
+        document.setUndoRedoEnabled(false);
+        document.setHtml(QString(comment));
+        document.setUndoRedoEnabled(undoRedo);
+    }
+}
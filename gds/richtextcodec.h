@@ -0,0 +1,26 @@
+#ifndef RICHTEXTCODEC_H
+#define RICHTEXTCODEC_H
+
+// Conversion between documents and the compact rich text comments are stored in (see RichTextFormat). Decoding
+// inserts the blocks and runs with their formats straight into the document, nothing is parsed
+
+#include <QByteArray>
+
+class QTextDocument;
+
+class RichTextCodec
+{
+public:
+    // The compact form of a document, empty if the document has something the format can't represent (tables
+    // and other frames)
+    static QByteArray encode(const QTextDocument &document);
+    // Replaces the content of the document, returns false (and leaves it empty) if data can't be decoded
+    static bool decode(const QByteArray &data, QTextDocument &document);
+
+    // What a comment is stored as: the compact form, html if the document can't be encoded
+    static QByteArray store(const QTextDocument &document);
+    // Loads a stored comment, compact or html
+    static void load(const QByteArray &comment, QTextDocument &document);
+};
+
+#endif // RICHTEXTCODEC_H
@@ -0,0 +1,77 @@
+#include "richtextformat.h"
+#include <QDataStream>
+
+#define IMAGE_REFERENCE_PREFIX "gdsimage:"
+
+bool RichTextFormat::isCompact(const QByteArray &comment)
+{
+    if(comment.size() < 8)
+        return false;
+    const uchar *data = reinterpret_cast<const uchar*>(comment.constData());
+    quint32 magic = (quint32(data[0]) << 24) | (quint32(data[1]) << 16) | (quint32(data[2]) << 8) | quint32(data[3]);
+    return magic == MAGIC;
+}
+
+QString RichTextFormat::plainText(const QByteArray &comment)
+{
+    if(!isCompact(comment))
+        return QString();
+
+    QDataStream in(comment);
+    quint32 magic, version;
+    in >> magic >> version;
+    if(version > VERSION)
+        return QString();
+
+    // Styles mean nothing without the GUI and images aren't text
+    for(int i=0; i<2; i++)
+    {
+        quint32 blobSize;
+        in >> blobSize;
+        if(blobSize != 0xFFFFFFFF && in.skipRawData(blobSize) != (int)blobSize)
+            return QString();
+    }
+
+    qint32 blocksCount;
+    in >> blocksCount;
+    if(in.status() != QDataStream::Ok || blocksCount < 0 || blocksCount > comment.size())
+        return QString();
+
+    QString text;
+    for(int i=0; i<blocksCount && in.status() == QDataStream::Ok; i++)
+    {
+        qint32 blockFormat, charFormat, list, runsCount;
+        in >> blockFormat >> charFormat >> list >> runsCount;
+        if(runsCount < 0 || runsCount > comment.size())
+            return QString();
+        if(i > 0)
+            text.append(QLatin1Char('\n'));
+        for(int j=0; j<runsCount && in.status() == QDataStream::Ok; j++)
+        {
+            QByteArray run;
+            qint32 format;
+            in >> run >> format;
+            text.append(QString::fromUtf8(run.constData(), run.size()));
+        }
+    }
+    if(in.status() != QDataStream::Ok)
+        return QString();
+
+    // Images are in the text as object replacement characters
+    text.replace(QChar(QChar::ObjectReplacementCharacter), QLatin1Char(' '));
+    return text;
+}
+
+QString RichTextFormat::imageReference(int image)
+{
+    return QString(IMAGE_REFERENCE_PREFIX) + QString::number(image);
+}
+
+int RichTextFormat::imageFromReference(const QString &name)
+{
+    if(!name.startsWith(IMAGE_REFERENCE_PREFIX))
+        return -1;
+    bool ok;
+    int image = name.mid(sizeof(IMAGE_REFERENCE_PREFIX) - 1).toInt(&ok);
+    return ok ? image : -1;
+}
@@ -0,0 +1,35 @@
+#ifndef RICHTEXTFORMAT_H
+#define RICHTEXTFORMAT_H
+
+// Compact rich text, the format comments are stored in. Qt's html (what toHtml() writes) is mostly inline CSS
+// repeated on every paragraph and span, and parsing it back is most of the time spent showing a comment. A
+// compact comment is instead:
+//   magic, version
+//   styles: the text formats used by the comment (block, char and list formats, each one stored once), as a
+//           length-prefixed blob only the GUI reads (see RichTextCodec)
+//   images: header ("data:image//png;base64,") and raw bytes of every embedded image, a length-prefixed blob
+//           as well. Image formats refer to them by index
+//   blocks: every paragraph with its block format, char format and list (indices into the styles, -1 for no
+//           list) and its runs: UTF-8 text and the index of its char format
+// Text can be read without the GUI modules (search index, gds-cli). Comments written before this format are
+// html and stay readable, isCompact() tells them apart
+
+#include <QByteArray>
+#include <QString>
+
+class RichTextFormat
+{
+public:
+    static const quint32 MAGIC = 0x47445254; // "GDRT"
+    static const quint32 VERSION = 1;
+
+    static bool isCompact(const QByteArray &comment);
+    // The text of a compact comment, a line per paragraph (images are a space). Empty if it can't be read
+    static QString plainText(const QByteArray &comment);
+
+    // Image format names refer to the images table with this prefix and the image index
+    static QString imageReference(int image);
+    static int imageFromReference(const QString &name);
+};
+
+#endif // RICHTEXTFORMAT_H
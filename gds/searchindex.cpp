@@ -0,0 +1,416 @@
+#include "searchindex.h"
+#include "levelstorage.h"
+#include "reanchorer.h"
+#include "projectreader.h"
+#include "logger.h"
+#include "richtextformat.h"
+#include <QElapsedTimer>
+#include <QtAlgorithms>
+
+// Words shorter than this aren't indexed
+#define SEARCH_MIN_WORD_LENGTH 2
+
+// Indexes every level decoded by the project reader
+class searchIndexBuilder : public ProjectLevelConsumer
+{
+public:
+    SearchIndex *m_index;
+    QHash<QString, QStringList> *m_sourceFilesCache;
+
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(index);
+        m_index->indexElements(levelFile, elements, *m_sourceFilesCache);
+        return false;
+    }
+};
+
+SearchIndex::SearchIndex()
+{
+    m_built = false;
+    m_nodesCount = 0;
+}
+
+void SearchIndex::build()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_nodes.clear();
+    m_terms.clear();
+    m_nodeByKey.clear();
+    m_nodesByLevelFile.clear();
+    m_nodesCount = 0;
+
+    // Code files referenced by many blocks are read just once
+    QHash<QString, QStringList> sourceFilesCache;
+
+    // Levels are decoded in parallel and indexed as they come
+    searchIndexBuilder builder;
+    builder.m_index = this;
+    builder.m_sourceFilesCache = &sourceFilesCache;
+    ProjectReader reader;
+    reader.read(LevelStorage::allLevelFiles(), &builder);
+    gdsInfo(LOGCAT_INDEX) << "SearchIndex - " << reader.summary();
+
+    m_built = true;
+    gdsInfo(LOGCAT_INDEX) << "SearchIndex - indexed " << m_nodesCount << " blocks, " << m_terms.size() << " terms in "
+               << timer.elapsed() << " ms";
+}
+
+void SearchIndex::updateLevel(const QString &levelFile, const QVector<dbDataStructure*> &elements)
+{
+    removeLevel(levelFile);
+    QHash<QString, QStringList> sourceFilesCache;
+    indexElements(levelFile, elements, sourceFilesCache);
+}
+
+void SearchIndex::removeLevel(const QString &levelFile)
+{
+    QVector<int> nodes = m_nodesByLevelFile.take(levelFile);
+    for(int i=0; i<nodes.size(); i++)
+    {
+        indexedNode &node = m_nodes[nodes[i]];
+
+        // Remove every posting of this node
+        for(int j=0; j<node.terms.size(); j++)
+        {
+            QMap<QString, QVector<posting> >::iterator itr = m_terms.find(node.terms[j]);
+            if(itr == m_terms.end())
+                continue;
+            QVector<posting> &postings = itr.value();
+            for(int k=postings.size()-1; k>=0; k--)
+            {
+                if(postings[k].node == nodes[i])
+                    postings.remove(k);
+            }
+            if(postings.isEmpty())
+                m_terms.erase(itr);
+        }
+
+        m_nodeByKey.remove(nodeKey(node.levelFile, node.uniqueID));
+        node.terms.clear();
+        node.removed = true;
+        m_nodesCount--;
+    }
+}
+
+QString SearchIndex::nodeKey(const QString &levelFile, quint64 uniqueID)
+{
+    return levelFile + "#" + QString::number(uniqueID);
+}
+
+void SearchIndex::indexElements(const QString &levelFile, const QVector<dbDataStructure*> &elements,
+                                QHash<QString, QStringList> &sourceFilesCache)
+{
+    level lvl;
+    quint64 levelOneID, levelTwoID;
+    if(!LevelStorage::parseLevelFileName(levelFile, &lvl, &levelOneID, &levelTwoID))
+        return;
+
+    QVector<int> &levelNodes = m_nodesByLevelFile[levelFile];
+    for(int i=0; i<elements.size(); i++)
+    {
+        const dbDataStructure *element = elements[i];
+
+        // Collect every term of this node with its maximum weight
+        QHash<QString, int> nodeTerms;
+        addText(nodeTerms, element->label, WEIGHT_LABEL);
+        if(!element->data.isEmpty())
+            addText(nodeTerms, commentToPlainText(element->data), WEIGHT_COMMENT);
+
+        // The documented code lines (the first one is absolute, the next ones are relative to the first)
+        if(!element->fileName.isEmpty() && element->linesNumbers.size() > 0)
+        {
+            if(!sourceFilesCache.contains(element->fileName))
+            {
+                QStringList lines;
+                Reanchorer::readSourceLines(element->fileName, lines);
+                sourceFilesCache.insert(element->fileName, lines);
+            }
+            const QStringList &lines = sourceFilesCache[element->fileName];
+            quint32 firstLine = element->linesNumbers[0];
+            for(int j=0; j<element->linesNumbers.size(); j++)
+            {
+                quint32 line = (j == 0) ? firstLine : firstLine + element->linesNumbers[j];
+                if(line < (quint32)lines.size())
+                    addText(nodeTerms, lines[line], WEIGHT_CODE);
+            }
+        }
+
+        indexedNode node;
+        node.levelFile = levelFile;
+        node.lvl = lvl;
+        node.levelOneID = levelOneID;
+        node.levelTwoID = levelTwoID;
+        node.uniqueID = element->uniqueID;
+        node.label = element->label;
+        node.removed = false;
+
+        int nodeIndex = m_nodes.size();
+        QHash<QString, int>::const_iterator itr = nodeTerms.constBegin();
+        while(itr != nodeTerms.constEnd())
+        {
+            posting p;
+            p.node = nodeIndex;
+            p.weight = itr.value();
+            m_terms[itr.key()].append(p);
+            node.terms.append(itr.key());
+            itr++;
+        }
+
+        m_nodes.append(node);
+        m_nodeByKey.insert(nodeKey(levelFile, node.uniqueID), nodeIndex);
+        levelNodes.append(nodeIndex);
+        m_nodesCount++;
+    }
+}
+
+void SearchIndex::addText(QHash<QString, int> &nodeTerms, const QString &text, int weight)
+{
+    QStringList words;
+    tokenize(text, words);
+    for(int i=0; i<words.size(); i++)
+    {
+        if(nodeTerms.value(words[i], 0) < weight)
+            nodeTerms.insert(words[i], weight);
+    }
+}
+
+void SearchIndex::tokenize(const QString &text, QStringList &words, bool identifierParts)
+{
+    const QChar *data = text.constData();
+    int length = text.length();
+    int i = 0;
+    while(i < length)
+    {
+        // Skip everything that isn't part of a word
+        if(!(data[i].isLetterOrNumber() || data[i] == QLatin1Char('_')))
+        {
+            i++;
+            continue;
+        }
+
+        int start = i;
+        QVector<int> partsStart; // Where camelCase/underscore parts start
+        partsStart.append(start);
+        while(i < length && (data[i].isLetterOrNumber() || data[i] == QLatin1Char('_')))
+        {
+            if(i > start)
+            {
+                if(data[i-1] == QLatin1Char('_') && data[i] != QLatin1Char('_'))
+                    partsStart.append(i);
+                else if(data[i].isUpper() && data[i-1].isLower())
+                    partsStart.append(i);
+            }
+            i++;
+        }
+
+        QString word = text.mid(start, i-start).toLower();
+        if(word.length() >= SEARCH_MIN_WORD_LENGTH)
+            words.append(word);
+
+        // Identifiers like loadSelectedElement or m_currentLevel can be found by their parts too
+        if(identifierParts && partsStart.size() > 1)
+        {
+            partsStart.append(i);
+            for(int j=0; j<partsStart.size()-1; j++)
+            {
+                QString part = text.mid(partsStart[j], partsStart[j+1]-partsStart[j]).toLower();
+                while(part.endsWith(QLatin1Char('_')))
+                    part.chop(1);
+                if(part.length() >= SEARCH_MIN_WORD_LENGTH)
+                    words.append(part);
+            }
+        }
+    }
+}
+
+QString SearchIndex::commentToPlainText(const QByteArray &comment)
+{
+    if(RichTextFormat::isCompact(comment))
+        return RichTextFormat::plainText(comment);
+    return htmlToPlainText(QString(comment));
+}
+
+QString SearchIndex::htmlToPlainText(const QString &html)
+{
+    QString text;
+    text.reserve(html.length());
+
+    int i = 0;
+    int length = html.length();
+    while(i < length)
+    {
+        QChar c = html[i];
+        if(c == QLatin1Char('<'))
+        {
+            int end = html.indexOf(QLatin1Char('>'), i);
+            if(end == -1)
+                break;
+
+            // Styles and scripts aren't text
+            QString tag = html.mid(i+1, 6).toLower();
+            if(tag.startsWith("style") || tag.startsWith("script"))
+            {
+                QString closingTag = tag.startsWith("style") ? "</style" : "</script";
+                int close = html.indexOf(closingTag, end, Qt::CaseInsensitive);
+                end = (close == -1) ? -1 : html.indexOf(QLatin1Char('>'), close);
+                if(end == -1)
+                    break;
+            }
+
+            // Every tag (images included) separates words
+            text.append(QLatin1Char(' '));
+            i = end+1;
+            continue;
+        }
+        if(c == QLatin1Char('&'))
+        {
+            int semicolon = html.indexOf(QLatin1Char(';'), i);
+            if(semicolon != -1 && semicolon-i <= 8)
+            {
+                QString entity = html.mid(i+1, semicolon-i-1);
+                QChar decoded;
+                if(entity == "amp") decoded = QLatin1Char('&');
+                else if(entity == "lt") decoded = QLatin1Char('<');
+                else if(entity == "gt") decoded = QLatin1Char('>');
+                else if(entity == "quot") decoded = QLatin1Char('"');
+                else if(entity == "apos") decoded = QLatin1Char('\'');
+                else if(entity == "nbsp") decoded = QLatin1Char(' ');
+                else if(entity.startsWith('#'))
+                {
+                    bool ok;
+                    uint code = (entity.startsWith("#x") || entity.startsWith("#X")) ? entity.mid(2).toUInt(&ok, 16)
+                                                                                     : entity.mid(1).toUInt(&ok, 10);
+                    if(ok && code < 0x10000)
+                        decoded = QChar((ushort)code);
+                }
+                if(!decoded.isNull())
+                {
+                    text.append(decoded);
+                    i = semicolon+1;
+                    continue;
+                }
+            }
+        }
+        text.append(c);
+        i++;
+    }
+    return text;
+}
+
+const SearchIndex::indexedNode *SearchIndex::findNode(level lvl, quint64 levelOneID, quint64 levelTwoID, quint64 uniqueID) const
+{
+    int index = m_nodeByKey.value(nodeKey(LevelStorage::levelFilePath(lvl, levelOneID, levelTwoID), uniqueID), -1);
+    if(index == -1)
+        return NULL;
+    return &m_nodes[index];
+}
+
+// Ordering of the search hits, best ones first and upper levels first at the same score
+static bool searchHitLessThan(const searchHit &h1, const searchHit &h2)
+{
+    if(h1.score != h2.score)
+        return h1.score > h2.score;
+    if(h1.lvl != h2.lvl)
+        return h1.lvl < h2.lvl;
+    return h1.label < h2.label;
+}
+
+QVector<searchHit> SearchIndex::search(const QString &query, int maxHits) const
+{
+    QVector<searchHit> hits;
+
+    QStringList queryWords;
+    tokenize(query, queryWords, false);
+    if(queryWords.isEmpty())
+        return hits;
+
+    // Score every node for each word, only the nodes containing all the words survive
+    QHash<int, int> scores;
+    for(int w=0; w<queryWords.size(); w++)
+    {
+        const QString &word = queryWords[w];
+        QHash<int, int> wordScores;
+
+        // Exact matches count double than prefix matches
+        QMap<QString, QVector<posting> >::const_iterator itr = m_terms.lowerBound(word);
+        while(itr != m_terms.constEnd() && itr.key().startsWith(word))
+        {
+            int multiplier = (itr.key().length() == word.length()) ? 2 : 1;
+            const QVector<posting> &postings = itr.value();
+            for(int i=0; i<postings.size(); i++)
+            {
+                int score = postings[i].weight * multiplier;
+                if(wordScores.value(postings[i].node, 0) < score)
+                    wordScores.insert(postings[i].node, score);
+            }
+            itr++;
+        }
+
+        if(w == 0)
+            scores = wordScores;
+        else
+        {
+            QHash<int, int>::iterator s = scores.begin();
+            while(s != scores.end())
+            {
+                if(!wordScores.contains(s.key()))
+                    s = scores.erase(s);
+                else
+                {
+                    s.value() += wordScores.value(s.key());
+                    s++;
+                }
+            }
+        }
+        if(scores.isEmpty())
+            return hits;
+    }
+
+    QHash<int, int>::const_iterator s = scores.constBegin();
+    while(s != scores.constEnd())
+    {
+        const indexedNode &node = m_nodes[s.key()];
+        int score = s.value();
+        s++;
+        if(node.removed)
+            continue;
+
+        searchHit hit;
+        hit.lvl = node.lvl;
+        hit.levelOneID = node.levelOneID;
+        hit.levelTwoID = node.levelTwoID;
+        hit.uniqueID = node.uniqueID;
+        hit.label = node.label;
+        hit.score = score;
+
+        // Resolve the ancestors in the upper levels, levels whose ancestor has been deleted can't be reached
+        if(node.lvl != LEVEL_ONE)
+        {
+            const indexedNode *levelOneNode = findNode(LEVEL_ONE, 0, 0, node.levelOneID);
+            if(levelOneNode == NULL)
+                continue;
+            hit.path.append(node.levelOneID);
+            hit.breadcrumb = levelOneNode->label + " > ";
+        }
+        if(node.lvl == LEVEL_THREE)
+        {
+            const indexedNode *levelTwoNode = findNode(LEVEL_TWO, node.levelOneID, 0, node.levelTwoID);
+            if(levelTwoNode == NULL)
+                continue;
+            hit.path.append(node.levelTwoID);
+            hit.breadcrumb += levelTwoNode->label + " > ";
+        }
+        hit.path.append(node.uniqueID);
+        hit.breadcrumb += node.label;
+
+        hits.append(hit);
+    }
+
+    qSort(hits.begin(), hits.end(), searchHitLessThan);
+    if(hits.size() > maxHits)
+        hits.resize(maxHits);
+    return hits;
+}
@@ -0,0 +1,90 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+// Full-text search over the entire documentation: an inverted index of the words found in every block's
+// label, in its comments (the plain text of the stored comment) and in the code lines it documents. The
+// index spans all level files and is updated one level file at a time when a level is saved
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include <QHash>
+#include "gdsdbreader.h"
+
+// A search result, everything needed to reach the node through the zoom levels
+struct searchHit
+{
+    level lvl;
+    quint64 levelOneID;     // Level one ancestor (levels 2 and 3 only)
+    quint64 levelTwoID;     // Level two ancestor (level 3 only)
+    quint64 uniqueID;
+    QVector<quint64> path;  // uniqueIDs from the level one ancestor down to the node
+    QString label;
+    QString breadcrumb;     // Labels from the level one ancestor down to the node
+    int score;
+};
+
+class SearchIndex
+{
+public:
+    SearchIndex();
+
+    // The index is built lazily the first time it's needed
+    bool isBuilt() const { return m_built; }
+    // Indexes every level file of the project
+    void build();
+    // Re-indexes a level file with its elements (e.g. right after it has been saved)
+    void updateLevel(const QString &levelFile, const QVector<dbDataStructure*> &elements);
+    void removeLevel(const QString &levelFile);
+
+    // Every space-separated query word has to be found (as a word or as a word prefix), best hits first
+    QVector<searchHit> search(const QString &query, int maxHits = 50) const;
+
+    // The plain text of a stored comment, compact rich text or html
+    static QString commentToPlainText(const QByteArray &comment);
+    // Strips tags, styles and entities from the comments' html
+    static QString htmlToPlainText(const QString &html);
+    // Splits a text into lowercase words, identifiers are also split into their camelCase/underscore parts
+    static void tokenize(const QString &text, QStringList &words, bool identifierParts = true);
+
+    int nodesCount() const { return m_nodesCount; }
+    int termsCount() const { return m_terms.size(); }
+
+private:
+    friend class searchIndexBuilder;
+
+    // Each term appears in a node with a weight depending on where it was found
+    enum termWeight {WEIGHT_CODE = 1, WEIGHT_COMMENT = 3, WEIGHT_LABEL = 8};
+    struct posting
+    {
+        int node;
+        int weight;
+    };
+    struct indexedNode
+    {
+        QString levelFile;
+        level lvl;
+        quint64 levelOneID;
+        quint64 levelTwoID;
+        quint64 uniqueID;
+        QString label;
+        QStringList terms; // Used to remove the node's postings when its level is indexed again
+        bool removed;
+    };
+
+    void indexElements(const QString &levelFile, const QVector<dbDataStructure*> &elements,
+                       QHash<QString, QStringList> &sourceFilesCache);
+    void addText(QHash<QString, int> &nodeTerms, const QString &text, int weight);
+    static QString nodeKey(const QString &levelFile, quint64 uniqueID);
+    const indexedNode *findNode(level lvl, quint64 levelOneID, quint64 levelTwoID, quint64 uniqueID) const;
+
+    bool m_built;
+    int m_nodesCount;
+    QVector<indexedNode> m_nodes;           // Removed nodes are just marked, their slots aren't reused
+    QMap<QString, QVector<posting> > m_terms; // Sorted, so that prefixes can be searched
+    QHash<QString, int> m_nodeByKey;        // Level file and uniqueID -> node
+    QHash<QString, QVector<int> > m_nodesByLevelFile;
+};
+
+#endif // SEARCHINDEX_H
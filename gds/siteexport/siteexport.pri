@@ -0,0 +1,21 @@
+# Static site export (see siteexporter.h), used by gds-cli. Needs QtGui for the comment documents, not a
+# display. The including project has to include storage.pri as well
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += $$PWD/siteexporter.cpp \
+    $$PWD/../richtextcodec.cpp \
+    $$PWD/../cpplexer.cpp \
+    $$PWD/../highlightcache.cpp \
+    $$PWD/../diagramwidget/scenemodel.cpp \
+    $$PWD/../diagramwidget/diagramrenderer.cpp
+
+HEADERS += $$PWD/siteexporter.h \
+    $$PWD/../richtextcodec.h \
+    $$PWD/../cpplexer.h \
+    $$PWD/../highlightcache.h \
+    $$PWD/../diagramwidget/scenemodel.h \
+    $$PWD/../diagramwidget/diagramrenderer.h
+
+RESOURCES += $$PWD/siteexport.qrc
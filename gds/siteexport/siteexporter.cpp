@@ -0,0 +1,421 @@
+#include "siteexporter.h"
+#include "levelstorage.h"
+#include "projectreader.h"
+#include "reanchorer.h"
+#include "richtextcodec.h"
+#include "logger.h"
+#include "diagramwidget/scenemodel.h"
+#include "diagramwidget/diagramrenderer.h"
+#include <QTextDocument>
+#include <QTextStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QMutexLocker>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QThread>
+
+// Classes of the token types in the viewer's style sheet (indexed by cppTokenType)
+static const char *tokenClasses[TOKEN_TYPES_COUNT] = {"kw", "qt", "cm", "st", "ch", "pp", "nu", "fn", "id"};
+
+static QString jsonString(const QString &text)
+{
+    QString escaped;
+    escaped.reserve(text.length() + 2);
+    escaped.append(QLatin1Char('"'));
+    for(int i=0; i<text.length(); i++)
+    {
+        QChar c = text[i];
+        switch(c.unicode())
+        {
+            case '"': escaped.append("\\\""); break;
+            case '\\': escaped.append("\\\\"); break;
+            case '\n': escaped.append("\\n"); break;
+            case '\r': escaped.append("\\r"); break;
+            case '\t': escaped.append("\\t"); break;
+            // Graphs are scripts, a "</script>" in a comment mustn't close anything
+            case '/': escaped.append((i > 0 && text[i-1] == QLatin1Char('<')) ? "\\/" : "/"); break;
+            default:
+                if(c.unicode() < 0x20 || c.unicode() == 0x2028 || c.unicode() == 0x2029)
+                    escaped.append(QString("\\u%1").arg(c.unicode(), 4, 16, QLatin1Char('0')));
+                else
+                    escaped.append(c);
+        }
+    }
+    escaped.append(QLatin1Char('"'));
+    return escaped;
+}
+
+// Exports a decoded level on a worker thread and frees it
+class siteExportTask : public QRunnable
+{
+public:
+    SiteExporter *m_exporter;
+    QSemaphore *m_pending;
+    QString m_levelFile;
+    QVector<dbDataStructure*> m_elements;
+
+    void run()
+    {
+        m_exporter->exportLevel(m_levelFile, m_elements);
+        LevelStorage::freeElements(m_elements);
+        m_pending->release();
+    }
+};
+
+// Hands every decoded level to the export pool
+class siteLevelConsumer : public ProjectLevelConsumer
+{
+public:
+    SiteExporter *m_exporter;
+    QThreadPool m_pool;
+    QSemaphore m_pending;
+
+    siteLevelConsumer(SiteExporter *exporter, int threads) : m_pending(threads * 2)
+    {
+        m_exporter = exporter;
+        m_pool.setMaxThreadCount(threads);
+    }
+
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(index);
+        // Levels waiting for a worker are bounded, memory doesn't grow with the project size
+        m_pending.acquire();
+        siteExportTask *task = new siteExportTask();
+        task->m_exporter = m_exporter;
+        task->m_pending = &m_pending;
+        task->m_levelFile = levelFile;
+        task->m_elements = elements;
+        m_pool.start(task);
+        return true;
+    }
+    void levelFailed(int index, const QString &levelFile)
+    {
+        ProjectLevelConsumer::levelFailed(index, levelFile);
+        m_exporter->levelFailed(levelFile);
+    }
+};
+
+SiteExporter::SiteExporter()
+{
+    m_maxThreadCount = 0;
+    m_levelsCount = 0;
+    m_blocksCount = 0;
+    m_failedCount = 0;
+    m_elapsedMs = 0;
+}
+
+void SiteExporter::setMaxThreadCount(int count)
+{
+    m_maxThreadCount = count;
+}
+
+QString SiteExporter::graphName(const QString &levelFile)
+{
+    return QFileInfo(levelFile).completeBaseName();
+}
+
+bool SiteExporter::exportSite(const QString &outputDir)
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_levelsCount = 0;
+    m_blocksCount = 0;
+    m_failedCount = 0;
+    m_images.clear();
+
+    QStringList levelFiles = LevelStorage::allLevelFiles();
+    if(levelFiles.isEmpty())
+    {
+        gdsError(LOGCAT_STORAGE) << "SiteExporter - no documentation level found in" << GDS_DIR;
+        return false;
+    }
+    m_levelFiles.clear();
+    for(int i=0; i<levelFiles.size(); i++)
+        m_levelFiles.insert(graphName(levelFiles[i]));
+
+    m_outputDir = QDir(outputDir);
+    if(!QDir().mkpath(outputDir) || !m_outputDir.mkpath("graphs") || !m_outputDir.mkpath("assets") ||
+       !m_outputDir.mkpath("thumbnails") ||
+       !copyViewerFile("index.html") || !copyViewerFile("viewer.js") || !copyViewerFile("viewer.css"))
+    {
+        gdsError(LOGCAT_STORAGE) << "SiteExporter - cannot write into" << outputDir;
+        return false;
+    }
+
+    int threads = (m_maxThreadCount > 0) ? m_maxThreadCount : QThread::idealThreadCount();
+    siteLevelConsumer consumer(this, qMax(1, threads));
+    ProjectReader reader;
+    reader.setMaxThreadCount(m_maxThreadCount);
+    reader.read(levelFiles, &consumer);
+    consumer.m_pool.waitForDone();
+
+    m_elapsedMs = timer.elapsed();
+    gdsInfo(LOGCAT_STORAGE) << "SiteExporter -" << summary();
+    return true;
+}
+
+QString SiteExporter::summary() const
+{
+    return QString("%1 levels (%2 blocks, %3 images) exported in %4 ms, %5 failed").arg(m_levelsCount)
+            .arg(m_blocksCount).arg(m_images.size()).arg(m_elapsedMs).arg(m_failedCount);
+}
+
+bool SiteExporter::copyViewerFile(const QString &name)
+{
+    QFile source(":/siteexport/viewer/" + name);
+    QFile destination(m_outputDir.filePath(name));
+    if(!source.open(QFile::ReadOnly) || !destination.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+    bool written = (destination.write(source.readAll()) == source.size());
+    destination.close();
+    source.close();
+    return written;
+}
+
+void SiteExporter::levelFailed(const QString &levelFile)
+{
+    Q_UNUSED(levelFile);
+    QMutexLocker locker(&m_mutex);
+    m_failedCount++;
+}
+
+void SiteExporter::exportLevel(const QString &levelFile, const QVector<dbDataStructure*> &elements)
+{
+    level lvl;
+    quint64 levelOneID, levelTwoID;
+    if(!LevelStorage::parseLevelFileName(levelFile, &lvl, &levelOneID, &levelTwoID))
+    {
+        levelFailed(levelFile);
+        return;
+    }
+
+    // Inserted and laid out as the windows do it, the viewer draws what the application draws
+    SceneModel scene;
+    QHash<const dbDataStructure*, int> nodes;
+    for(int i=0; i<elements.size(); i++)
+    {
+        int father = elements[i]->father ? nodes.value(elements[i]->father, -1) : -1;
+        nodes.insert(elements[i], scene.addNode(elements[i]->label, father));
+    }
+    scene.layout();
+
+    QString json;
+    QTextStream out(&json);
+    out << "{\"name\":" << jsonString(graphName(levelFile)) << ",\"level\":" << ((int)lvl + 1);
+    if(lvl == LEVEL_TWO)
+        out << ",\"parent\":" << jsonString(graphName(LevelStorage::levelFilePath(LEVEL_ONE, 0, 0)))
+            << ",\"parentBlock\":" << levelOneID;
+    else if(lvl == LEVEL_THREE)
+        out << ",\"parent\":" << jsonString(graphName(LevelStorage::levelFilePath(LEVEL_TWO, levelOneID, 0)))
+            << ",\"parentBlock\":" << levelTwoID;
+    out << ",\"nodes\":[";
+
+    QHash<QString, codeFile> codeFiles;
+    bool firstNode = true;
+    for(int i=0; i<elements.size(); i++)
+    {
+        const dbDataStructure *element = elements[i];
+        int id = nodes.value(element, -1);
+        if(id == -1)
+            continue;
+
+        out << (firstNode ? "{" : ",{") << "\"id\":" << id << ",\"uid\":" << element->uniqueID
+            << ",\"label\":" << jsonString(element->label) << ",\"x\":" << (qint64)scene.m_x[id]
+            << ",\"y\":" << (qint64)(-scene.m_y[id]) << ",\"parent\":" << scene.m_parent[id];
+
+        QString child;
+        if(lvl == LEVEL_ONE)
+            child = graphName(LevelStorage::levelFilePath(LEVEL_TWO, element->uniqueID, 0));
+        else if(lvl == LEVEL_TWO)
+            child = graphName(LevelStorage::levelFilePath(LEVEL_THREE, levelOneID, element->uniqueID));
+        if(!child.isEmpty() && m_levelFiles.contains(child))
+            out << ",\"child\":" << jsonString(child);
+
+        if(!element->data.isEmpty())
+            out << ",\"comment\":" << jsonString(commentHtml(element->data));
+
+        if(!element->fileName.isEmpty() && element->linesNumbers.size() > 0)
+        {
+            if(!codeFiles.contains(element->fileName))
+                readCodeFile(element->fileName, codeFiles[element->fileName]);
+            const codeFile &file = codeFiles[element->fileName];
+            if(file.found)
+                out << ",\"code\":{\"file\":" << jsonString(element->fileName) << ",\"html\":"
+                    << jsonString(codeSnippet(file, element->linesNumbers)) << "}";
+        }
+        out << "}";
+        firstNode = false;
+    }
+    out << "]}";
+    out.flush();
+
+    QFile file(m_outputDir.filePath("graphs/" + graphName(levelFile) + ".js"));
+    if(!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        gdsError(LOGCAT_STORAGE) << "SiteExporter - cannot write" << file.fileName();
+        levelFailed(levelFile);
+        return;
+    }
+    file.write("gdsSite.graphLoaded(");
+    file.write(json.toUtf8());
+    file.write(");\n");
+    file.close();
+
+    // The viewer previews a deeper level with its thumbnail. Rendered without labels: text in worker threads
+    // needs fonts, and at this size labels can't be read anyway
+    DiagramRenderer renderer;
+    renderer.setLabelsVisible(false);
+    QImage thumbnail = renderer.render(scene, QSize(THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT));
+    if(!thumbnail.save(m_outputDir.filePath("thumbnails/" + graphName(levelFile) + ".png"), "PNG"))
+        gdsWarning(LOGCAT_STORAGE) << "SiteExporter - cannot write the thumbnail of" << levelFile;
+
+    QMutexLocker locker(&m_mutex);
+    m_levelsCount++;
+    m_blocksCount += elements.size();
+}
+
+QString SiteExporter::commentHtml(const QByteArray &comment)
+{
+    // Compact and html comments both go through a document, the site gets the same html for both
+    QTextDocument document;
+    document.setUndoRedoEnabled(false);
+    RichTextCodec::load(comment, document);
+    QString html = document.toHtml("utf-8");
+
+    int body = html.indexOf("<body");
+    int bodyEnd = html.lastIndexOf("</body>");
+    if(body != -1 && bodyEnd != -1)
+    {
+        int start = html.indexOf(QLatin1Char('>'), body) + 1;
+        html = html.mid(start, bodyEnd - start);
+    }
+
+    // Embedded images become assets, an image used by many blocks is written once
+    int position = 0;
+    while((position = html.indexOf("src=\"data:", position)) != -1)
+    {
+        int start = position + 5;
+        int end = html.indexOf(QLatin1Char('"'), start);
+        if(end == -1)
+            break;
+        QString asset = writeImage(html.mid(start, end - start));
+        if(asset.isEmpty())
+        {
+            position = end;
+            continue;
+        }
+        html.replace(start, end - start, asset);
+        position = start + asset.length();
+    }
+    return html;
+}
+
+QString SiteExporter::writeImage(const QString &dataUrl)
+{
+    int base64 = dataUrl.indexOf(";base64,");
+    if(base64 == -1)
+        return QString();
+    QByteArray bytes = QByteArray::fromBase64(dataUrl.mid(base64 + 8).toLatin1());
+    if(bytes.isEmpty())
+        return QString();
+
+    // "data:image//png", the editor writes the image format after the last slash
+    QString extension = dataUrl.left(base64).section('/', -1).toLower();
+    for(int i=0; i<extension.length(); i++)
+    {
+        if(!extension[i].isLetterOrNumber())
+        {
+            extension.clear();
+            break;
+        }
+    }
+    if(extension.isEmpty())
+        extension = "img";
+    QString name = "assets/" + QString(QCryptographicHash::hash(bytes, QCryptographicHash::Md5).toHex()) + "." +
+                   extension;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if(m_images.contains(name))
+            return name;
+        m_images.insert(name);
+    }
+    QFile file(m_outputDir.filePath(name));
+    if(!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        gdsError(LOGCAT_STORAGE) << "SiteExporter - cannot write" << file.fileName();
+        return QString();
+    }
+    file.write(bytes);
+    file.close();
+    return name;
+}
+
+void SiteExporter::readCodeFile(const QString &fileName, codeFile &file)
+{
+    QFile source(LevelStorage::convertToAbsolutePath(fileName));
+    file.found = source.open(QFile::ReadOnly);
+    if(!file.found)
+    {
+        gdsWarning(LOGCAT_STORAGE) << "SiteExporter - code file not found" << fileName;
+        return;
+    }
+    QByteArray content = source.readAll();
+    source.close();
+    file.lines = Reanchorer::splitSourceLines(content);
+
+    // The same tokens the code pane highlights, shared with it through the highlight cache
+    QByteArray hash = HighlightCache::contentHash(content);
+    if(!HighlightCache::find(hash, file.highlight))
+    {
+        HighlightCache::lexContent(content, file.highlight);
+        HighlightCache::insert(hash, file.highlight);
+    }
+}
+
+QString SiteExporter::codeSnippet(const codeFile &file, const QVector<quint32> &linesNumbers)
+{
+    // The first line is absolute, the next ones are relative to the first
+    QSet<int> documented;
+    int first = linesNumbers[0], last = first;
+    for(int i=0; i<linesNumbers.size(); i++)
+    {
+        int line = (i == 0) ? first : first + (int)linesNumbers[i];
+        documented.insert(line);
+        last = qMax(last, line);
+    }
+    int from = qMax(0, first - SNIPPET_CONTEXT_LINES);
+    int to = qMin(file.lines.size() - 1, last + SNIPPET_CONTEXT_LINES);
+
+    const highlightData &highlight = file.highlight;
+    QString html;
+    for(int line=from; line<=to; line++)
+    {
+        const QString &text = file.lines[line];
+        html += documented.contains(line) ? "<div class=\"line doc\">" : "<div class=\"line\">";
+        html += "<span class=\"ln\">" + QString::number(line + 1) + "</span>";
+
+        int position = 0;
+        if(line < highlight.lineCount() && highlight.lineLengths[line] == text.length())
+        {
+            for(int i=highlight.firstToken[line]; i<highlight.firstToken[line+1]; i++)
+            {
+                const cppToken &token = highlight.tokens[i];
+                if(token.start < position || token.start + token.length > text.length() || token.type < 0 ||
+                   token.type >= TOKEN_TYPES_COUNT)
+                    continue;
+                html += Qt::escape(text.mid(position, token.start - position));
+                html += QString("<span class=\"") + tokenClasses[token.type] + "\">" +
+                        Qt::escape(text.mid(token.start, token.length)) + "</span>";
+                position = token.start + token.length;
+            }
+        }
+        html += Qt::escape(text.mid(position)) + "</div>";
+    }
+    return html;
+}
@@ -0,0 +1,78 @@
+#ifndef SITEEXPORTER_H
+#define SITEEXPORTER_H
+
+// Static site export: the whole documentation as pages anyone can read with a browser, no OpenGL needed. Every
+// level is laid out as the diagram widget lays it out (SceneModel) and written as a graph file with the comments
+// of its blocks (html, embedded images are written once into assets/) and their highlighted code snippets, plus
+// a thumbnail of the level (thumbnails/, see DiagramRenderer). A small canvas viewer (siteexport/viewer) draws
+// the graphs and zooms through the levels.
+// Graph files are JSON wrapped into a script call (graphs/<level file name>.js): browsers load them from disk
+// without a web server. Levels are decoded by the project reader and exported by a pool of worker threads
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QHash>
+#include <QDir>
+#include <QMutex>
+#include "gdsdbreader.h"
+#include "highlightcache.h"
+
+class SiteExporter
+{
+public:
+    SiteExporter();
+
+    // Decoding and exporting threads, 0 uses one per core
+    void setMaxThreadCount(int count);
+
+    // Exports every level of the project into outputDir (created if needed). Returns false if there's nothing
+    // to export or the directory can't be written, levels that can't be exported are counted as failed
+    bool exportSite(const QString &outputDir);
+
+    int levelsCount() const { return m_levelsCount; }
+    int blocksCount() const { return m_blocksCount; }
+    int imagesCount() const { return m_images.size(); }
+    int failedCount() const { return m_failedCount; }
+    QString summary() const;
+
+    // Called by the export tasks, elements are freed by the caller
+    void exportLevel(const QString &levelFile, const QVector<dbDataStructure*> &elements);
+    void levelFailed(const QString &levelFile);
+
+    // Code lines shown before and after the documented ones
+    static const int SNIPPET_CONTEXT_LINES = 2;
+    // Size of the level thumbnails (thumbnails/<graph name>.png)
+    static const int THUMBNAIL_WIDTH = 240;
+    static const int THUMBNAIL_HEIGHT = 150;
+    // Name of the graph file of a level (its file name without extension)
+    static QString graphName(const QString &levelFile);
+
+private:
+    // A code file read and highlighted once for all the blocks of a level documenting it
+    struct codeFile
+    {
+        bool found;
+        QStringList lines;
+        highlightData highlight;
+    };
+
+    QString commentHtml(const QByteArray &comment);
+    QString writeImage(const QString &dataUrl);
+    QString codeSnippet(const codeFile &file, const QVector<quint32> &linesNumbers);
+    void readCodeFile(const QString &fileName, codeFile &file);
+    bool copyViewerFile(const QString &name);
+
+    int m_maxThreadCount;
+    QDir m_outputDir;
+    QSet<QString> m_levelFiles;     // A block links its deeper level only if it exists
+
+    QMutex m_mutex;                 // Everything below is shared by the export tasks
+    QSet<QString> m_images;         // Assets written so far
+    int m_levelsCount;
+    int m_blocksCount;
+    int m_failedCount;
+    qint64 m_elapsedMs;
+};
+
+#endif // SITEEXPORTER_H
@@ -0,0 +1,279 @@
+// gds static site viewer: draws the graphs written by "gds-cli export-site" on a canvas. Every graph comes with
+// its layout already calculated, the viewer just scales it. Graph files are scripts calling
+// gdsSite.graphLoaded(), they're loaded on demand when a level is opened. The location hash keeps the graph
+// and the selected block (#level2_5/17) so that blocks can be linked
+
+var gdsSite = (function()
+{
+    // Blocks are drawn in layout units, the layout keeps them 10 apart horizontally and 5 vertically
+    var BLOCK_WIDTH = 8, BLOCK_HEIGHT = 3;
+    var ROOT_GRAPH = "level1_general";
+
+    var canvas = document.getElementById("graph");
+    var context = canvas.getContext("2d");
+    var graphs = {};            // Loaded graphs by name
+    var waiting = null;         // Graph being loaded (and the block to select in it)
+    var graph = null;           // Shown graph
+    var selected = -1;
+    var view = {x: 0, y: 0, scale: 20};
+    var drag = null;
+
+    function loadGraph(name, uid)
+    {
+        if(graphs[name])
+        {
+            showGraph(graphs[name], uid);
+            return;
+        }
+        waiting = {name: name, uid: uid};
+        var script = document.createElement("script");
+        script.src = "graphs/" + name + ".js";
+        script.onerror = function() { document.getElementById("comment").textContent = "Cannot load " + name; };
+        document.head.appendChild(script);
+    }
+
+    function graphLoaded(loaded)
+    {
+        graphs[loaded.name] = loaded;
+        if(waiting && waiting.name === loaded.name)
+        {
+            showGraph(loaded, waiting.uid);
+            waiting = null;
+        }
+    }
+
+    function nodeByUid(target, uid)
+    {
+        for(var i=0; i<target.nodes.length; i++)
+        {
+            if(target.nodes[i].uid === uid)
+                return i;
+        }
+        return -1;
+    }
+
+    function showGraph(shown, uid)
+    {
+        graph = shown;
+        selected = -1;
+        updateBreadcrumb();
+        document.getElementById("upButton").disabled = !graph.parent;
+        fitView();
+        var node = (uid !== undefined) ? nodeByUid(graph, uid) : -1;
+        select(node !== -1 ? node : (graph.nodes.length > 0 ? 0 : -1));
+    }
+
+    function updateBreadcrumb()
+    {
+        var labels = ["Level " + graph.level];
+        var parent = graph.parent ? graphs[graph.parent] : null;
+        if(parent)
+        {
+            var block = nodeByUid(parent, graph.parentBlock);
+            if(block !== -1)
+                labels.push(parent.nodes[block].label);
+        }
+        document.getElementById("breadcrumb").textContent = labels.join(" \u203a ");
+    }
+
+    // The whole graph on screen
+    function fitView()
+    {
+        resize();
+        if(graph.nodes.length === 0)
+            return;
+        var minX = Infinity, maxX = -Infinity, minY = Infinity, maxY = -Infinity;
+        for(var i=0; i<graph.nodes.length; i++)
+        {
+            var node = graph.nodes[i];
+            minX = Math.min(minX, node.x);
+            maxX = Math.max(maxX, node.x);
+            minY = Math.min(minY, node.y);
+            maxY = Math.max(maxY, node.y);
+        }
+        var width = maxX - minX + BLOCK_WIDTH * 2, height = maxY - minY + BLOCK_HEIGHT * 2;
+        view.scale = Math.min(40, Math.min(canvas.width / width, canvas.height / height));
+        view.x = (minX + maxX) / 2;
+        view.y = (minY + maxY) / 2;
+    }
+
+    function toScreen(x, y)
+    {
+        return {x: (x - view.x) * view.scale + canvas.width / 2, y: (y - view.y) * view.scale + canvas.height / 2};
+    }
+
+    function roundedRect(x, y, width, height, radius)
+    {
+        context.beginPath();
+        context.moveTo(x + radius, y);
+        context.arcTo(x + width, y, x + width, y + height, radius);
+        context.arcTo(x + width, y + height, x, y + height, radius);
+        context.arcTo(x, y + height, x, y, radius);
+        context.arcTo(x, y, x + width, y, radius);
+        context.closePath();
+    }
+
+    function draw()
+    {
+        context.fillStyle = "#330099";
+        context.fillRect(0, 0, canvas.width, canvas.height);
+        if(!graph)
+            return;
+
+        var i, node, p;
+        context.strokeStyle = "#b0a0e0";
+        context.lineWidth = Math.max(1, view.scale / 10);
+        context.beginPath();
+        for(i=0; i<graph.nodes.length; i++)
+        {
+            node = graph.nodes[i];
+            if(node.parent < 0)
+                continue;
+            var from = toScreen(graph.nodes[node.parent].x, graph.nodes[node.parent].y);
+            p = toScreen(node.x, node.y);
+            context.moveTo(from.x, from.y);
+            context.lineTo(p.x, p.y);
+        }
+        context.stroke();
+
+        var width = BLOCK_WIDTH * view.scale, height = BLOCK_HEIGHT * view.scale;
+        context.font = Math.max(8, Math.round(height / 3)) + "px sans-serif";
+        context.textAlign = "center";
+        context.textBaseline = "middle";
+        for(i=0; i<graph.nodes.length; i++)
+        {
+            node = graph.nodes[i];
+            p = toScreen(node.x, node.y);
+            if(p.x + width < 0 || p.x - width > canvas.width || p.y + height < 0 || p.y - height > canvas.height)
+                continue;
+            roundedRect(p.x - width / 2, p.y - height / 2, width, height, height / 4);
+            context.fillStyle = (i === selected) ? "#ffd75e" : "#e8e4f4";
+            context.fill();
+            // Blocks with a deeper level are outlined
+            if(node.child)
+            {
+                context.strokeStyle = "#5e3cc4";
+                context.stroke();
+            }
+            if(height >= 12)
+            {
+                context.fillStyle = "#1a1030";
+                context.save();
+                context.beginPath();
+                context.rect(p.x - width / 2, p.y - height / 2, width, height);
+                context.clip();
+                context.fillText(node.label, p.x, p.y);
+                context.restore();
+            }
+        }
+    }
+
+    function select(node)
+    {
+        selected = node;
+        var code = document.getElementById("code"), comment = document.getElementById("comment");
+        code.innerHTML = "";
+        comment.innerHTML = "";
+        if(node >= 0)
+        {
+            var block = graph.nodes[node];
+            if(block.code)
+            {
+                var file = document.createElement("div");
+                file.className = "file";
+                file.textContent = block.code.file;
+                code.appendChild(file);
+                code.insertAdjacentHTML("beforeend", block.code.html);
+            }
+            comment.innerHTML = block.comment || "";
+            // Blocks with a deeper level preview it, a click opens it
+            if(block.child)
+            {
+                var preview = document.createElement("img");
+                preview.className = "preview";
+                preview.src = "thumbnails/" + block.child + ".png";
+                preview.title = "Open the level of " + block.label;
+                preview.addEventListener("click", function() { loadGraph(block.child); });
+                comment.insertBefore(preview, comment.firstChild);
+            }
+            history.replaceState(null, "", "#" + graph.name + "/" + block.uid);
+        }
+        draw();
+    }
+
+    function nodeAt(x, y)
+    {
+        if(!graph)
+            return -1;
+        for(var i=0; i<graph.nodes.length; i++)
+        {
+            var p = toScreen(graph.nodes[i].x, graph.nodes[i].y);
+            if(Math.abs(x - p.x) <= BLOCK_WIDTH * view.scale / 2 && Math.abs(y - p.y) <= BLOCK_HEIGHT * view.scale / 2)
+                return i;
+        }
+        return -1;
+    }
+
+    function resize()
+    {
+        canvas.width = canvas.clientWidth;
+        canvas.height = canvas.clientHeight;
+    }
+
+    function goUp()
+    {
+        if(graph && graph.parent)
+            loadGraph(graph.parent, graph.parentBlock);
+    }
+
+    canvas.addEventListener("mousedown", function(e)
+    {
+        drag = {x: e.clientX, y: e.clientY, viewX: view.x, viewY: view.y, moved: false};
+    });
+    window.addEventListener("mousemove", function(e)
+    {
+        if(!drag)
+            return;
+        var dx = e.clientX - drag.x, dy = e.clientY - drag.y;
+        if(Math.abs(dx) + Math.abs(dy) > 3)
+            drag.moved = true;
+        view.x = drag.viewX - dx / view.scale;
+        view.y = drag.viewY - dy / view.scale;
+        draw();
+    });
+    window.addEventListener("mouseup", function(e)
+    {
+        if(drag && !drag.moved && e.target === canvas)
+        {
+            var node = nodeAt(e.offsetX, e.offsetY);
+            if(node !== -1)
+                select(node);
+        }
+        drag = null;
+    });
+    canvas.addEventListener("dblclick", function(e)
+    {
+        var node = nodeAt(e.offsetX, e.offsetY);
+        if(node !== -1 && graph.nodes[node].child)
+            loadGraph(graph.nodes[node].child);
+    });
+    canvas.addEventListener("wheel", function(e)
+    {
+        e.preventDefault();
+        // Zoom around the mouse position
+        var before = {x: (e.offsetX - canvas.width / 2) / view.scale + view.x,
+                      y: (e.offsetY - canvas.height / 2) / view.scale + view.y};
+        view.scale = Math.max(1, Math.min(200, view.scale * (e.deltaY < 0 ? 1.2 : 1 / 1.2)));
+        view.x = before.x - (e.offsetX - canvas.width / 2) / view.scale;
+        view.y = before.y - (e.offsetY - canvas.height / 2) / view.scale;
+        draw();
+    });
+    window.addEventListener("resize", function() { resize(); draw(); });
+    document.getElementById("upButton").addEventListener("click", goUp);
+
+    // Start from the linked block, if any
+    var start = location.hash.substring(1).split("/");
+    loadGraph(start[0] || ROOT_GRAPH, start.length > 1 ? Number(start[1]) : undefined);
+
+    return {graphLoaded: graphLoaded};
+})();
@@ -0,0 +1,25 @@
+# Level files storage and project-wide operations, shared by the gds application and the gds-cli
+# command line tool. Nothing in here depends on the GUI modules
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += $$PWD/levelstorage.cpp \
+    $$PWD/projectreader.cpp \
+    $$PWD/reanchorer.cpp \
+    $$PWD/searchindex.cpp \
+    $$PWD/profiler.cpp \
+    $$PWD/logger.cpp \
+    $$PWD/tourorder.cpp \
+    $$PWD/richtextformat.cpp
+
+HEADERS += $$PWD/gdsdbreader.h \
+    $$PWD/levelstorage.h \
+    $$PWD/projectreader.h \
+    $$PWD/reanchorer.h \
+    $$PWD/searchindex.h \
+    $$PWD/profiler.h \
+    $$PWD/logger.h \
+    $$PWD/tourorder.h \
+    $$PWD/richtextformat.h \
+    $$PWD/nodearena.h
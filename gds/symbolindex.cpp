@@ -0,0 +1,374 @@
+#include "symbolindex.h"
+#include "levelstorage.h"
+#include "reanchorer.h"
+#include "projectreader.h"
+#include "cpplexer.h"
+#include "logger.h"
+#include <QRunnable>
+#include <QThreadPool>
+#include <QFileInfo>
+#include <QDir>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QtAlgorithms>
+
+// Files next to the documented ones with these extensions are indexed too
+static const char *sourceFileFilters[] = {"*.c", "*.cc", "*.cpp", "*.cxx", "*.h", "*.hh", "*.hpp", "*.hxx", "*.inl", NULL};
+
+SymbolIndex::SymbolIndex()
+{
+    m_built = false;
+}
+
+QVector<QStringList> SymbolIndex::scanSourceLines(const QStringList &lines)
+{
+    QVector<QStringList> symbols(lines.size());
+    QVector<cppToken> tokens;
+    int state = CppLexer::STATE_NORMAL;
+    for(int i=0; i<lines.size(); i++)
+    {
+        tokens.resize(0);
+        state = CppLexer::lexLine(lines[i], state, tokens, true);
+        for(int j=0; j<tokens.size(); j++)
+        {
+            // Keywords, literals and comments aren't symbols
+            if(tokens[j].type != TOKEN_IDENTIFIER && tokens[j].type != TOKEN_FUNCTION && tokens[j].type != TOKEN_QT_CLASS)
+                continue;
+            QString symbol = lines[i].mid(tokens[j].start, tokens[j].length);
+            if(!symbols[i].contains(symbol))
+                symbols[i].append(symbol);
+        }
+    }
+    return symbols;
+}
+
+// One of these tasks is created for each code file, results are merged once every task has finished
+class symbolScanTask : public QRunnable
+{
+public:
+    int m_file;
+    QString m_fileName;
+    int m_lineCount;
+    QVector<QStringList> m_lineSymbols;
+
+    void run()
+    {
+        QStringList lines;
+        if(!Reanchorer::readSourceLines(m_fileName, lines))
+        {
+            m_lineCount = 0;
+            return;
+        }
+        m_lineCount = lines.size();
+        m_lineSymbols = SymbolIndex::scanSourceLines(lines);
+    }
+};
+
+// Adds the blocks of every level decoded by the project reader (code files are tokenized afterwards)
+class symbolIndexBuilder : public ProjectLevelConsumer
+{
+public:
+    SymbolIndex *m_index;
+
+    bool levelDecoded(int index, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        Q_UNUSED(index);
+        m_index->addBlocks(levelFile, elements, false);
+        return false;
+    }
+};
+
+QString SymbolIndex::fileKey(const QString &fileName)
+{
+    // Blocks store paths relative to the application, the same file could be referenced in different ways
+    return QFileInfo(LevelStorage::convertToAbsolutePath(fileName)).absoluteFilePath();
+}
+
+QString SymbolIndex::nodeKey(const QString &levelFile, quint64 uniqueID)
+{
+    return levelFile + "#" + QString::number(uniqueID);
+}
+
+int SymbolIndex::addFile(const QString &key)
+{
+    int file = m_fileIndex.value(key, -1);
+    if(file != -1)
+        return file;
+
+    file = m_files.size();
+    m_files.append(key);
+    m_filesDisplayNames.append(LevelStorage::convertToRelativePath(key));
+    m_fileIndex.insert(key, file);
+    m_fileLineCounts.append(-1);
+    m_lineBlocks.append(QHash<int, QVector<int> >());
+    return file;
+}
+
+void SymbolIndex::scanFiles(const QVector<int> &files)
+{
+    if(files.isEmpty())
+        return;
+
+    // Tokenize in parallel
+    QVector<symbolScanTask*> tasks;
+    QThreadPool pool;
+    for(int i=0; i<files.size(); i++)
+    {
+        symbolScanTask *task = new symbolScanTask();
+        task->setAutoDelete(false);
+        task->m_file = files[i];
+        task->m_fileName = m_files[files[i]];
+        tasks.append(task);
+        pool.start(task);
+    }
+    pool.waitForDone();
+
+    // Merge the results
+    for(int i=0; i<tasks.size(); i++)
+    {
+        symbolScanTask *task = tasks[i];
+        m_fileLineCounts[task->m_file] = task->m_lineCount;
+        for(int line=0; line<task->m_lineSymbols.size(); line++)
+        {
+            const QStringList &lineSymbols = task->m_lineSymbols[line];
+            for(int j=0; j<lineSymbols.size(); j++)
+            {
+                symbolOccurrence occurrence;
+                occurrence.file = task->m_file;
+                occurrence.line = line;
+                m_symbols[lineSymbols[j]].append(occurrence);
+            }
+        }
+        delete task;
+    }
+}
+
+void SymbolIndex::build()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_files.clear();
+    m_filesDisplayNames.clear();
+    m_fileIndex.clear();
+    m_fileLineCounts.clear();
+    m_symbols.clear();
+    m_blocks.clear();
+    m_blocksByLevelFile.clear();
+    m_lineBlocks.clear();
+    m_labels.clear();
+
+    // 1) Load every block, this also collects the documented code files
+    symbolIndexBuilder builder;
+    builder.m_index = this;
+    ProjectReader reader;
+    reader.read(LevelStorage::allLevelFiles(), &builder);
+    gdsInfo(LOGCAT_INDEX) << "SymbolIndex - " << reader.summary();
+
+    // 2) Add the C/C++ files in the same directories
+    QStringList filters;
+    for(int i=0; sourceFileFilters[i] != NULL; i++)
+        filters.append(sourceFileFilters[i]);
+    QSet<QString> directories;
+    int documentedFiles = m_files.size();
+    for(int i=0; i<documentedFiles; i++)
+        directories.insert(QFileInfo(m_files[i]).absolutePath());
+    QSet<QString>::const_iterator dir = directories.constBegin();
+    while(dir != directories.constEnd())
+    {
+        QStringList entries = QDir(*dir).entryList(filters, QDir::Files, QDir::Name);
+        for(int i=0; i<entries.size(); i++)
+            addFile(QFileInfo(*dir + "/" + entries[i]).absoluteFilePath());
+        dir++;
+    }
+
+    // 3) Tokenize all of them
+    QVector<int> files;
+    for(int i=0; i<m_files.size(); i++)
+        files.append(i);
+    scanFiles(files);
+
+    m_built = true;
+    gdsInfo(LOGCAT_INDEX) << "SymbolIndex - " << m_files.size() << " code files, " << m_symbols.size() << " symbols, "
+               << m_blocks.size() << " blocks in " << timer.elapsed() << " ms";
+}
+
+void SymbolIndex::addBlocks(const QString &levelFile, const QVector<dbDataStructure*> &elements, bool scanNewFiles)
+{
+    level lvl;
+    quint64 levelOneID, levelTwoID;
+    if(!LevelStorage::parseLevelFileName(levelFile, &lvl, &levelOneID, &levelTwoID))
+        return;
+
+    QVector<int> newFiles;
+    QVector<int> &levelBlocks = m_blocksByLevelFile[levelFile];
+    for(int i=0; i<elements.size(); i++)
+    {
+        const dbDataStructure *element = elements[i];
+        m_labels.insert(nodeKey(levelFile, element->uniqueID), element->label);
+
+        if(element->fileName.isEmpty() || element->linesNumbers.size() == 0)
+            continue;
+
+        documentingBlock block;
+        block.levelFile = levelFile;
+        block.lvl = lvl;
+        block.levelOneID = levelOneID;
+        block.levelTwoID = levelTwoID;
+        block.uniqueID = element->uniqueID;
+        block.label = element->label;
+        block.removed = false;
+
+        QString key = fileKey(element->fileName);
+        int filesBefore = m_files.size();
+        block.file = addFile(key);
+        if(m_files.size() != filesBefore)
+            newFiles.append(block.file);
+
+        // The first line is absolute, the next ones are relative to the first
+        quint32 firstLine = element->linesNumbers[0];
+        for(int j=0; j<element->linesNumbers.size(); j++)
+            block.lines.append((j == 0) ? firstLine : firstLine + element->linesNumbers[j]);
+
+        int blockIndex = m_blocks.size();
+        QHash<int, QVector<int> > &lineBlocks = m_lineBlocks[block.file];
+        for(int j=0; j<block.lines.size(); j++)
+            lineBlocks[(int)block.lines[j]].append(blockIndex);
+
+        m_blocks.append(block);
+        levelBlocks.append(blockIndex);
+    }
+
+    if(scanNewFiles)
+        scanFiles(newFiles);
+}
+
+void SymbolIndex::updateLevel(const QString &levelFile, const QVector<dbDataStructure*> &elements)
+{
+    removeLevel(levelFile);
+    addBlocks(levelFile, elements, true);
+}
+
+void SymbolIndex::removeLevel(const QString &levelFile)
+{
+    QVector<int> blocks = m_blocksByLevelFile.take(levelFile);
+    for(int i=0; i<blocks.size(); i++)
+    {
+        documentingBlock &block = m_blocks[blocks[i]];
+        QHash<int, QVector<int> > &lineBlocks = m_lineBlocks[block.file];
+        for(int j=0; j<block.lines.size(); j++)
+        {
+            QHash<int, QVector<int> >::iterator itr = lineBlocks.find((int)block.lines[j]);
+            if(itr == lineBlocks.end())
+                continue;
+            int index = itr.value().indexOf(blocks[i]);
+            if(index != -1)
+                itr.value().remove(index);
+            if(itr.value().isEmpty())
+                lineBlocks.erase(itr);
+        }
+        block.removed = true;
+    }
+
+    // Labels of this level are going to be inserted again if the level still exists
+    QString prefix = levelFile + "#";
+    QHash<QString, QString>::iterator itr = m_labels.begin();
+    while(itr != m_labels.end())
+    {
+        if(itr.key().startsWith(prefix))
+            itr = m_labels.erase(itr);
+        else
+            itr++;
+    }
+}
+
+// Best hits first
+static bool symbolHitLessThan(const searchHit &h1, const searchHit &h2)
+{
+    if(h1.score != h2.score)
+        return h1.score > h2.score;
+    return h1.breadcrumb < h2.breadcrumb;
+}
+
+QVector<searchHit> SymbolIndex::findSymbol(const QString &symbol, int maxHits) const
+{
+    QVector<searchHit> hits;
+
+    // Count, for each block, how many of its lines contain the symbol (and remember the first one)
+    QHash<int, int> occurrencesPerBlock;
+    QHash<int, int> firstLinePerBlock;
+    const QVector<symbolOccurrence> occurrences = m_symbols.value(symbol);
+    for(int i=0; i<occurrences.size(); i++)
+    {
+        const QVector<int> blocks = m_lineBlocks[occurrences[i].file].value(occurrences[i].line);
+        for(int j=0; j<blocks.size(); j++)
+        {
+            if(!firstLinePerBlock.contains(blocks[j]))
+                firstLinePerBlock.insert(blocks[j], occurrences[i].line);
+            occurrencesPerBlock[blocks[j]]++;
+        }
+    }
+
+    QHash<int, int>::const_iterator itr = occurrencesPerBlock.constBegin();
+    while(itr != occurrencesPerBlock.constEnd())
+    {
+        const documentingBlock &block = m_blocks[itr.key()];
+
+        searchHit hit;
+        hit.lvl = block.lvl;
+        hit.levelOneID = block.levelOneID;
+        hit.levelTwoID = block.levelTwoID;
+        hit.uniqueID = block.uniqueID;
+        hit.label = block.label;
+        hit.score = itr.value();
+
+        // Path through the levels (blocks with code are on levels 2 and 3)
+        hit.path.append(block.levelOneID);
+        hit.breadcrumb = m_labels.value(nodeKey(LevelStorage::levelFilePath(LEVEL_ONE, 0, 0), block.levelOneID)) + " > ";
+        if(block.lvl == LEVEL_THREE)
+        {
+            hit.path.append(block.levelTwoID);
+            hit.breadcrumb += m_labels.value(nodeKey(LevelStorage::levelFilePath(LEVEL_TWO, block.levelOneID, 0),
+                                                     block.levelTwoID)) + " > ";
+        }
+        hit.path.append(block.uniqueID);
+        hit.breadcrumb += block.label + QString(" (%1:%2)").arg(m_filesDisplayNames[block.file])
+                                                            .arg(firstLinePerBlock.value(itr.key()) + 1);
+        hits.append(hit);
+        itr++;
+    }
+
+    qSort(hits.begin(), hits.end(), symbolHitLessThan);
+    if(hits.size() > maxHits)
+        hits.resize(maxHits);
+    return hits;
+}
+
+bool SymbolIndex::fileCoverage(const QString &fileName, int *totalLines, int *documentedLines, int *documentingBlocks) const
+{
+    int file = m_fileIndex.value(fileKey(fileName), -1);
+    if(file == -1 || m_fileLineCounts[file] < 0)
+        return false;
+
+    // Only lines still in the file count (anchors might be broken)
+    const QHash<int, QVector<int> > &lineBlocks = m_lineBlocks[file];
+    QSet<int> blocks;
+    int documented = 0;
+    QHash<int, QVector<int> >::const_iterator itr = lineBlocks.constBegin();
+    while(itr != lineBlocks.constEnd())
+    {
+        if(itr.key() < m_fileLineCounts[file])
+            documented++;
+        for(int i=0; i<itr.value().size(); i++)
+            blocks.insert(itr.value()[i]);
+        itr++;
+    }
+
+    if(totalLines)
+        *totalLines = m_fileLineCounts[file];
+    if(documentedLines)
+        *documentedLines = documented;
+    if(documentingBlocks)
+        *documentingBlocks = blocks.size();
+    return true;
+}
@@ -0,0 +1,87 @@
+#ifndef SYMBOLINDEX_H
+#define SYMBOLINDEX_H
+
+// Symbol cross-reference: every identifier of the project's code files is mapped to the lines it appears on,
+// and every line is mapped to the level 2/3 blocks documenting it. A symbol lookup returns the documenting
+// blocks with no need to scan the levels, the same tables give the documentation coverage of a code file.
+// Project's code files are the ones referenced by the blocks and the C/C++ files lying next to them
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include "gdsdbreader.h"
+#include "searchindex.h"
+
+class SymbolIndex
+{
+public:
+    SymbolIndex();
+
+    // The index is built lazily the first time it's needed
+    bool isBuilt() const { return m_built; }
+    // Tokenizes every project's code file (in parallel) and loads every block of every level
+    void build();
+    // Updates the blocks of a level file (e.g. right after it has been saved), new code files are tokenized
+    void updateLevel(const QString &levelFile, const QVector<dbDataStructure*> &elements);
+    void removeLevel(const QString &levelFile);
+
+    // Every block documenting at least a line where the symbol appears, the most occurrences first
+    QVector<searchHit> findSymbol(const QString &symbol, int maxHits = 50) const;
+    // Lines of a code file documented by at least a block, returns false if the file isn't indexed
+    bool fileCoverage(const QString &fileName, int *totalLines, int *documentedLines, int *documentingBlocks) const;
+
+    int symbolsCount() const { return m_symbols.size(); }
+    int filesCount() const { return m_files.size(); }
+
+    // Identifiers found on each line of a code file (in order of appearance, repetitions removed)
+    static QVector<QStringList> scanSourceLines(const QStringList &lines);
+
+private:
+    friend class symbolIndexBuilder;
+
+    struct documentingBlock
+    {
+        QString levelFile;
+        level lvl;
+        quint64 levelOneID;
+        quint64 levelTwoID;
+        quint64 uniqueID;
+        QString label;
+        int file;
+        QVector<quint32> lines; // Absolute line numbers
+        bool removed;
+    };
+    struct symbolOccurrence
+    {
+        int file;
+        int line;
+    };
+
+    static QString fileKey(const QString &fileName);
+    static QString nodeKey(const QString &levelFile, quint64 uniqueID);
+    int addFile(const QString &key);
+    void scanFiles(const QVector<int> &files);
+    void addBlocks(const QString &levelFile, const QVector<dbDataStructure*> &elements, bool scanNewFiles);
+
+    bool m_built;
+
+    // Code files, identified by their absolute paths
+    QStringList m_files;
+    QStringList m_filesDisplayNames;    // Relative paths, as shown to the user
+    QHash<QString, int> m_fileIndex;
+    QVector<int> m_fileLineCounts;      // -1 if not tokenized yet
+
+    // Symbol -> every line it appears on
+    QHash<QString, QVector<symbolOccurrence> > m_symbols;
+
+    // Blocks and, for each code file, line -> blocks documenting it
+    QVector<documentingBlock> m_blocks;
+    QHash<QString, QVector<int> > m_blocksByLevelFile;
+    QVector< QHash<int, QVector<int> > > m_lineBlocks;
+
+    // Labels of every node of every level (used to show the path of a block)
+    QHash<QString, QString> m_labels;
+};
+
+#endif // SYMBOLINDEX_H
@@ -1,93 +1,93 @@
-#ifndef textEditorWinORWIN_H
-#define textEditorWinORWIN_H
-
-#include <QMainWindow>
-#include <QMap>
-#include <QPointer>
-#include <QAction>
-#include <QApplication>
-#include <QClipboard>
-#include <QColorDialog>
-#include <QComboBox>
-#include <QFontComboBox>
-#include <QFile>
-#include <QFileDialog>
-#include <QFileInfo>
-#include <QFontDatabase>
-#include <QPrintDialog>
-#include <QPrinter>
-#include <QTextCodec>
-#include <QTextEdit>
-#include <QToolBar>
-#include <QTextCursor>
-#include <QTextDocumentWriter>
-#include <QTextList>
-#include <QtDebug>
-#include <QCloseEvent>
-#include <QMessageBox>
-#include <QPrintPreviewDialog>
-#include <QImageReader>
-
-class textEditorWin : public QMainWindow
-{
-    Q_OBJECT
-
-public:
-    textEditorWin(QWidget *parent = 0);
-    ~textEditorWin();
-
-    QTextEdit *m_textEditorWin;
-
-protected:
-    virtual void closeEvent(QCloseEvent *);
-
-private:
-    void setupEditActions();
-    void setupTextActions();
-
-private slots:
-    void textBold();
-    void textUnderline();
-    void textItalic();
-    void textFamily(const QString &f);
-    void textSize(const QString &p);
-    void textStyle(int styleIndex);
-    void textColor();
-    void textAlign(QAction *a);
-
-    void currentCharFormatChanged(const QTextCharFormat &format);
-    void cursorPositionChanged();
-
-    void clipboardDataChanged();
-    void addImageToText();
-
-private:
-    void mergeFormatOnWordOrSelection(const QTextCharFormat &format);
-    void fontChanged(const QFont &f);
-    void colorChanged(const QColor &c);
-    void alignmentChanged(Qt::Alignment a);
-
-    QAction *actionSave,
-        *actionTextBold,
-        *actionTextUnderline,
-        *actionTextItalic,
-        *actionTextColor,
-        *actionAlignLeft,
-        *actionAlignCenter,
-        *actionAlignRight,
-        *actionAlignJustify,
-        *actionUndo,
-        *actionRedo,
-        *actionCut,
-        *actionCopy,
-        *actionPaste,
-        *actionInsertImage;
-
-    QComboBox *comboStyle;
-    QFontComboBox *comboFont;
-    QComboBox *comboSize;
-
-    QToolBar *tb;
-};
-
-#endif
+#ifndef textEditorWinORWIN_H
+#define textEditorWinORWIN_H
+
+#include <QMainWindow>
+#include <QMap>
+#include <QPointer>
+#include <QAction>
+#include <QApplication>
+#include <QClipboard>
+#include <QColorDialog>
+#include <QComboBox>
+#include <QFontComboBox>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QPrintDialog>
+#include <QPrinter>
+#include <QTextCodec>
+#include <QTextEdit>
+#include <QToolBar>
+#include <QTextCursor>
+#include <QTextDocumentWriter>
+#include <QTextList>
+#include <QtDebug>
+#include <QCloseEvent>
+#include <QMessageBox>
+#include <QPrintPreviewDialog>
+#include <QImageReader>
+
+class textEditorWin : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    textEditorWin(QWidget *parent = 0);
+    ~textEditorWin();
+
+    QTextEdit *m_textEditorWin;
+
+protected:
+    virtual void closeEvent(QCloseEvent *);
+
+private:
+    void setupEditActions();
+    void setupTextActions();
+
+private slots:
+    void textBold();
+    void textUnderline();
+    void textItalic();
+    void textFamily(const QString &f);
+    void textSize(const QString &p);
+    void textStyle(int styleIndex);
+    void textColor();
+    void textAlign(QAction *a);
+
+    void currentCharFormatChanged(const QTextCharFormat &format);
+    void cursorPositionChanged();
+
+    void clipboardDataChanged();
+    void addImageToText();
+
+private:
+    void mergeFormatOnWordOrSelection(const QTextCharFormat &format);
+    void fontChanged(const QFont &f);
+    void colorChanged(const QColor &c);
+    void alignmentChanged(Qt::Alignment a);
+
+    QAction *actionSave,
+        *actionTextBold,
+        *actionTextUnderline,
+        *actionTextItalic,
+        *actionTextColor,
+        *actionAlignLeft,
+        *actionAlignCenter,
+        *actionAlignRight,
+        *actionAlignJustify,
+        *actionUndo,
+        *actionRedo,
+        *actionCut,
+        *actionCopy,
+        *actionPaste,
+        *actionInsertImage;
+
+    QComboBox *comboStyle;
+    QFontComboBox *comboFont;
+    QComboBox *comboSize;
+
+    QToolBar *tb;
+};
+
+#endif
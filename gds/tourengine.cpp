@@ -0,0 +1,260 @@
+#include "tourengine.h"
+#include "tourorder.h"
+#include "levelstorage.h"
+#include "levelcache.h"
+#include "projectreader.h"
+#include "highlightcache.h"
+#include "logger.h"
+#include <QRunnable>
+#include <QMutexLocker>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QElapsedTimer>
+
+const char *TourEngine::TOUR_FILE = GDS_DIR "/tour.txt";
+
+QString tourStep::levelFile() const
+{
+    return LevelStorage::levelFilePath(lvl, levelOneID, levelTwoID);
+}
+
+// Collects the blocks of every level in their tour order, nothing else is kept
+class tourLevelCollector : public ProjectLevelConsumer
+{
+public:
+    QHash<QString, QVector<tourStep> > m_levels;
+
+    bool levelDecoded(int, const QString &levelFile, QVector<dbDataStructure*> &elements)
+    {
+        level lvl;
+        quint64 levelOneID, levelTwoID;
+        if(!LevelStorage::parseLevelFileName(levelFile, &lvl, &levelOneID, &levelTwoID))
+            return false;
+
+        TourOrder order;
+        order.build(elements);
+        QVector<tourStep> &blocks = m_levels[levelFile];
+        for(int i=0; i<order.stepsCount(); i++)
+        {
+            const dbDataStructure *element = elements[order.elementAt(i)];
+            tourStep block;
+            block.lvl = lvl;
+            block.levelOneID = (lvl == LEVEL_ONE) ? 0 : levelOneID;
+            block.levelTwoID = (lvl == LEVEL_THREE) ? levelTwoID : 0;
+            block.uniqueID = element->uniqueID;
+            block.element = order.elementAt(i);
+            block.codeFile = element->fileName;
+            blocks.append(block);
+        }
+        return false;
+    }
+};
+
+// Appends the tour of a level, each block followed by the tour of its deeper level (if it has one)
+static void appendLevelTour(const QHash<QString, QVector<tourStep> > &levels, const QString &levelFile,
+                            QVector<tourStep> &steps)
+{
+    const QVector<tourStep> blocks = levels.value(levelFile);
+    for(int i=0; i<blocks.size(); i++)
+    {
+        steps.append(blocks[i]);
+        if(blocks[i].lvl == LEVEL_ONE)
+            appendLevelTour(levels, LevelStorage::levelFilePath(LEVEL_TWO, blocks[i].uniqueID, 0), steps);
+        else if(blocks[i].lvl == LEVEL_TWO)
+            appendLevelTour(levels, LevelStorage::levelFilePath(LEVEL_THREE, blocks[i].levelOneID, blocks[i].uniqueID),
+                            steps);
+    }
+}
+
+// Reads a code file and highlights it on a worker thread, the highlighter will find it in the highlight cache
+class codePreloadTask : public QRunnable
+{
+public:
+    TourEngine *m_engine;
+    QString m_path;
+
+    void run()
+    {
+        QByteArray content;
+        QFile file(m_path);
+        if(file.open(QFile::ReadOnly))
+        {
+            content = file.readAll();
+            file.close();
+
+            QByteArray hash = HighlightCache::contentHash(content);
+            highlightData data;
+            if(!HighlightCache::find(hash, data))
+            {
+                HighlightCache::lexContent(content, data);
+                HighlightCache::insert(hash, data);
+            }
+        }
+        m_engine->deliverCodeFile(m_path, content);
+    }
+};
+
+TourEngine::TourEngine()
+{
+    m_built = false;
+    // A single worker, preloading shouldn't compete with the window for the disk
+    m_pool.setMaxThreadCount(1);
+}
+
+TourEngine::~TourEngine()
+{
+    m_pool.waitForDone();
+}
+
+QString TourEngine::blockKey(const QString &levelFile, quint64 uniqueID)
+{
+    return levelFile + "#" + QString::number(uniqueID);
+}
+
+bool TourEngine::build()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_steps.clear();
+    m_stepOfBlock.clear();
+
+    tourLevelCollector collector;
+    ProjectReader reader;
+    reader.read(LevelStorage::allLevelFiles(), &collector);
+
+    QFile file(TOUR_FILE);
+    if(file.open(QFile::ReadOnly | QFile::Text))
+    {
+        // Every block of the documentation by its path
+        QHash<QString, tourStep> blocks;
+        QHash<QString, QVector<tourStep> >::const_iterator itr = collector.m_levels.constBegin();
+        while(itr != collector.m_levels.constEnd())
+        {
+            for(int i=0; i<itr.value().size(); i++)
+                blocks.insert(blockKey(itr.key(), itr.value()[i].uniqueID), itr.value()[i]);
+            itr++;
+        }
+
+        QTextStream in(&file);
+        int lineNumber = 0;
+        while(!in.atEnd())
+        {
+            QString line = in.readLine().trimmed();
+            lineNumber++;
+            if(line.isEmpty() || line.startsWith("#"))
+                continue;
+
+            QStringList path = line.split('/', QString::SkipEmptyParts);
+            QVector<quint64> ids;
+            bool ok = (path.size() >= 1 && path.size() <= 3);
+            for(int i=0; i<path.size() && ok; i++)
+                ids.append(path[i].trimmed().toULongLong(&ok));
+            QString levelFile;
+            if(ok)
+                levelFile = LevelStorage::levelFilePath((level)(ids.size() - 1), ids[0], ids.size() > 2 ? ids[1] : 0);
+            if(!ok || !blocks.contains(blockKey(levelFile, ids.last())))
+            {
+                gdsWarning(LOGCAT_GENERAL) << "TourEngine -" << TOUR_FILE << "line" << lineNumber << "- no block" << line;
+                continue;
+            }
+            m_steps.append(blocks.value(blockKey(levelFile, ids.last())));
+        }
+        file.close();
+    }
+    else
+        appendLevelTour(collector.m_levels, LevelStorage::levelFilePath(LEVEL_ONE, 0, 0), m_steps);
+
+    // Going back to the first step showing a block
+    for(int i=m_steps.size()-1; i>=0; i--)
+        m_stepOfBlock.insert(blockKey(m_steps[i].levelFile(), m_steps[i].uniqueID), i);
+    m_visited = QBitArray(m_steps.size());
+
+    m_built = true;
+    gdsInfo(LOGCAT_GENERAL) << "TourEngine -" << m_steps.size() << "steps in" << timer.elapsed() << "ms";
+    return !m_steps.isEmpty();
+}
+
+int TourEngine::stepOf(const QString &levelFile, quint64 uniqueID) const
+{
+    return m_stepOfBlock.value(blockKey(levelFile, uniqueID), -1);
+}
+
+void TourEngine::markVisited(int step)
+{
+    if(step >= 0 && step < m_visited.size())
+        m_visited.setBit(step);
+}
+
+void TourEngine::clearVisited()
+{
+    m_visited.fill(false);
+}
+
+int TourEngine::nextUnvisited(int step) const
+{
+    // The tour goes forward and visited steps are mostly behind us, this rarely skips more than a step
+    for(int i=step+1; i<m_visited.size(); i++)
+    {
+        if(!m_visited.testBit(i))
+            return i;
+    }
+    return -1;
+}
+
+void TourEngine::preloadAfter(int step, const QString &currentLevelFile, LevelCache *levelCache)
+{
+    QSet<QString> codeFiles;
+    for(int i=step+1; i<m_steps.size() && i<=step+PRELOAD_STEPS; i++)
+    {
+        const tourStep &next = m_steps[i];
+        if(next.levelFile() != currentLevelFile)
+            levelCache->prefetch(next.levelFile());
+        if(!next.codeFile.isEmpty())
+            codeFiles.insert(LevelStorage::convertToAbsolutePath(next.codeFile));
+    }
+
+    QMutexLocker locker(&m_codeFilesMutex);
+
+    // Forget the files that aren't ahead anymore
+    QHash<QString, QByteArray>::iterator itr = m_codeFiles.begin();
+    while(itr != m_codeFiles.end())
+    {
+        if(codeFiles.contains(itr.key()))
+            itr++;
+        else
+            itr = m_codeFiles.erase(itr);
+    }
+
+    QSet<QString>::const_iterator file = codeFiles.constBegin();
+    while(file != codeFiles.constEnd())
+    {
+        if(!m_codeFiles.contains(*file) && !m_codeFilesLoading.contains(*file))
+        {
+            m_codeFilesLoading.insert(*file);
+            codePreloadTask *task = new codePreloadTask();
+            task->m_engine = this;
+            task->m_path = *file;
+            m_pool.start(task);
+        }
+        file++;
+    }
+}
+
+bool TourEngine::preloadedCodeFile(const QString &absolutePath, QByteArray &content)
+{
+    QMutexLocker locker(&m_codeFilesMutex);
+    if(!m_codeFiles.contains(absolutePath))
+        return false;
+    content = m_codeFiles.value(absolutePath);
+    return true;
+}
+
+void TourEngine::deliverCodeFile(const QString &absolutePath, const QByteArray &content)
+{
+    QMutexLocker locker(&m_codeFilesMutex);
+    m_codeFilesLoading.remove(absolutePath);
+    if(!content.isEmpty())
+        m_codeFiles.insert(absolutePath, content);
+}
@@ -0,0 +1,85 @@
+#ifndef TOURENGINE_H
+#define TOURENGINE_H
+
+// Guided tours across levels, followed by view mode's navigator. A tour is a sequence of blocks anywhere in the
+// documentation: by default the whole documentation depth first (every level in its tour order, each block
+// followed by the tour of its deeper level). A GDS_DIR/tour.txt file defines a different one, one block per line
+// given by its path of uniqueIDs from level one (e.g. "3/17" is block 17 in the level two of block 3, lines
+// starting with # are comments).
+// While a tour is followed the next steps are preloaded in the background: their levels are decoded into the
+// level cache and their code files are read and highlighted, so moving through them doesn't wait for the disk
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QBitArray>
+#include <QByteArray>
+#include <QMutex>
+#include <QThreadPool>
+#include "gdsdbreader.h"
+
+class LevelCache;
+
+struct tourStep
+{
+    level lvl;
+    quint64 levelOneID;     // Level one ancestor (levels 2 and 3 only)
+    quint64 levelTwoID;     // Level two ancestor (level 3 only)
+    quint64 uniqueID;
+    int element;            // Index of the block in its level
+    QString codeFile;       // Code file of the block (relative path), if any
+
+    QString levelFile() const;
+};
+
+class TourEngine
+{
+public:
+    TourEngine();
+    ~TourEngine();
+
+    // Reads the structure of every level and builds the tour (the one in the tour file, if there's one).
+    // Returns false if there's nothing to tour
+    bool build();
+    bool isBuilt() const { return m_built; }
+
+    int stepsCount() const { return m_steps.size(); }
+    const tourStep &step(int index) const { return m_steps[index]; }
+    // The step showing a block, -1 if the block isn't in the tour
+    int stepOf(const QString &levelFile, quint64 uniqueID) const;
+
+    // Steps visited since the tour (re)started
+    void markVisited(int step);
+    void clearVisited();
+    // The first step after this one that hasn't been visited yet, -1 if the tour is over
+    int nextUnvisited(int step) const;
+
+    // Starts loading the steps following this one. The current level is owned by the window, it's not prefetched
+    void preloadAfter(int step, const QString &currentLevelFile, LevelCache *levelCache);
+    // The content of a preloaded code file (absolute path), false if it isn't preloaded (yet)
+    bool preloadedCodeFile(const QString &absolutePath, QByteArray &content);
+
+    // Called by the preloading tasks
+    void deliverCodeFile(const QString &absolutePath, const QByteArray &content);
+
+    // Steps loaded ahead of the current one
+    static const int PRELOAD_STEPS = 8;
+    static const char *TOUR_FILE;
+
+private:
+    bool m_built;
+    QVector<tourStep> m_steps;
+    QHash<QString, int> m_stepOfBlock; // Keyed by level file and uniqueID
+    QBitArray m_visited;
+
+    // Code files of the steps ahead, read and highlighted by m_pool
+    QMutex m_codeFilesMutex;
+    QHash<QString, QByteArray> m_codeFiles;
+    QSet<QString> m_codeFilesLoading;
+    QThreadPool m_pool;
+
+    static QString blockKey(const QString &levelFile, quint64 uniqueID);
+};
+
+#endif // TOURENGINE_H
@@ -0,0 +1,58 @@
+#include "tourorder.h"
+#include <QtAlgorithms>
+
+struct tourEntry
+{
+    int element;
+    quint32 userIndex;
+    quint64 uniqueID;
+};
+
+static bool tourEntryLessThan(const tourEntry &e1, const tourEntry &e2)
+{
+    // If user indices are different, no problem
+    if(e1.userIndex != e2.userIndex)
+        return e1.userIndex < e2.userIndex;
+    // Otherwise order by uniqueID (and that's unique)
+    return e1.uniqueID < e2.uniqueID;
+}
+
+void TourOrder::build(const QVector<dbDataStructure*> &elements)
+{
+    QVector<tourEntry> entries(elements.size());
+    for(int i=0; i<elements.size(); i++)
+    {
+        entries[i].element = i;
+        entries[i].userIndex = elements[i]->userIndex;
+        entries[i].uniqueID = elements[i]->uniqueID;
+    }
+    qSort(entries.begin(), entries.end(), tourEntryLessThan);
+
+    m_elements.resize(entries.size());
+    m_steps.resize(entries.size());
+    for(int i=0; i<entries.size(); i++)
+    {
+        m_elements[i] = entries[i].element;
+        m_steps[entries[i].element] = i;
+    }
+}
+
+void TourOrder::clear()
+{
+    m_elements.clear();
+    m_steps.clear();
+}
+
+int TourOrder::elementAt(int step) const
+{
+    if(step < 0 || step >= m_elements.size())
+        return -1;
+    return m_elements[step];
+}
+
+int TourOrder::stepOf(int element) const
+{
+    if(element < 0 || element >= m_steps.size())
+        return -1;
+    return m_steps[element];
+}
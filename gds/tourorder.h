@@ -0,0 +1,28 @@
+#ifndef TOURORDER_H
+#define TOURORDER_H
+
+// The order blocks of a level are toured in: by their user index (the order the author chose, ties broken by
+// uniqueID). Positions are O(1) both ways. Tours spanning levels are made of these (see TourEngine)
+
+#include <QVector>
+#include "gdsdbreader.h"
+
+class TourOrder
+{
+public:
+    // Orders the elements of a level (indices of the vector, as the windows use them)
+    void build(const QVector<dbDataStructure*> &elements);
+    void clear();
+
+    bool isEmpty() const { return m_elements.isEmpty(); }
+    int stepsCount() const { return m_elements.size(); }
+    // Element index shown at a step and vice versa, -1 if out of range
+    int elementAt(int step) const;
+    int stepOf(int element) const;
+
+private:
+    QVector<int> m_elements; // Element index of each step
+    QVector<int> m_steps;    // Step of each element index
+};
+
+#endif // TOURORDER_H